@@ -0,0 +1,223 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Benchmarks the stages of the renderer and whole frames, and compares  *
+ *      the results of two runs.                                              *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+#include "qnf_bench_suite.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/*  Parses a comma-separated list of positive integers, e.g. "256,512".       */
+static bool parse_list(const char *text, std::vector<unsigned int> *out)
+{
+    out->clear();
+
+    while (*text)
+    {
+        char *end;
+        const unsigned long int n = std::strtoul(text, &end, 10);
+
+        if (end == text || n == 0UL || (*end && *end != ','))
+            return false;
+
+        out->push_back(static_cast<unsigned int>(n));
+        text = (*end ? end + 1 : end);
+    }
+
+    return !out->empty();
+}
+
+/*  The benchmarks to run once the polynomial is known. visit_polynomial      *
+ *  calls run<Poly>() with it as a type.                                      */
+struct job {
+    bool micro, macro;
+    unsigned int n_frames;
+    std::vector<unsigned int> sizes, threads;
+    const char *json_path;
+    const char *ppm_path;
+    qnf::render_options opts;
+
+    template <class Poly>
+    int run(void)
+    {
+        qnf::benchmark::suite s(Poly::name(), opts.isa, opts.max_iters);
+
+        std::printf("%s, instruction set %s, %u lanes\n", Poly::name(),
+                    qnf::isa_name(opts.isa),
+                    qnf::simd::level_width(opts.isa));
+
+        if (micro)
+        {
+            qnf::benchmark::quaternion_ops(s);
+            qnf::benchmark::newton_loop<Poly>(s, opts);
+            qnf::benchmark::ppm_output(
+                s, qnf::benchmark::coloring<Poly>(s, opts), ppm_path
+            );
+        }
+
+        if (macro)
+            qnf::benchmark::frames<Poly>(s, opts, sizes, threads, n_frames);
+
+        if (json_path && !s.write_json(json_path))
+            return EXIT_FAILURE;
+
+        /*  Printed so that the work behind it cannot be optimized away.      */
+        std::printf("checksum %g\n", s.sink);
+        return EXIT_SUCCESS;
+    }
+};
+
+/*  Usage: bench [--poly name] [--no-micro] [--no-macro] [--sizes list]       *
+ *               [--threads list] [--frames n] [--isa level]                  *
+ *               [--json file] [--ppm-path file]                              *
+ *         bench --compare old.json new.json [--threshold percent]            *
+ *      --poly        The polynomial, one of qnf::polynomial_names. Defaults  *
+ *                    to z3-1.                                                *
+ *      --no-micro    Skip the benchmarks of the single stages: the           *
+ *                    quaternion operations (ns/item), the Newton loop of the *
+ *                    kernel, the colorers (ns/pixel) and PPM output.         *
+ *      --no-macro    Skip rendering whole frames.                            *
+ *      --sizes list  Frame sizes for the whole frames, e.g. 256,512,1024     *
+ *                    (the default). The frames are square.                   *
+ *      --threads list                                                        *
+ *                    Thread counts for the whole frames. Defaults to 1, 2,   *
+ *                    4, ... up to the number of hardware threads.            *
+ *      --frames n    Frames timed per size and thread count. Defaults to 4.  *
+ *      --isa level   Instruction set of the Newton loops, in the loops and   *
+ *                    in the whole frames, as for main.                       *
+ *      --json file   Also write the results to file as JSON.                 *
+ *      --ppm-path    File the PPM benchmark writes and removes. Defaults to  *
+ *                    qnf_bench.ppm.                                          *
+ *      --compare     Run nothing, compare two JSON files instead and list    *
+ *                    the measurements that got slower by more than the       *
+ *                    threshold (default 5 percent). Exits with failure if    *
+ *                    there are any.                                          */
+int main(int argc, char **argv)
+{
+    const char *poly = "z3-1";
+    const char *compare_old = 0, *compare_new = 0;
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    double threshold = 5.0;
+    unsigned int n;
+    job j;
+    int arg, status;
+
+    j.micro = true;
+    j.macro = true;
+    j.n_frames = 4U;
+    j.json_path = 0;
+    j.ppm_path = "qnf_bench.ppm";
+    j.sizes.push_back(256U);
+    j.sizes.push_back(512U);
+    j.sizes.push_back(1024U);
+
+    for (n = 1U; n < hardware; n *= 2U)
+        j.threads.push_back(n);
+
+    j.threads.push_back(hardware > 0U ? hardware : 1U);
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!std::strcmp(argv[arg], "--poly") && arg + 1 < argc)
+            poly = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--no-micro"))
+            j.micro = false;
+
+        else if (!std::strcmp(argv[arg], "--no-macro"))
+            j.macro = false;
+
+        else if (!std::strcmp(argv[arg], "--sizes") && arg + 1 < argc &&
+                 parse_list(argv[arg + 1], &j.sizes))
+            ++arg;
+
+        else if (!std::strcmp(argv[arg], "--threads") && arg + 1 < argc &&
+                 parse_list(argv[arg + 1], &j.threads))
+            ++arg;
+
+        else if (!std::strcmp(argv[arg], "--frames") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) > 0)
+            j.n_frames = static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--isa") && arg + 1 < argc)
+        {
+            if (!qnf::parse_isa(argv[++arg], &j.opts.isa) ||
+                !qnf::isa_supported(j.opts.isa))
+            {
+                std::fprintf(stderr, "Unknown or unsupported instruction "
+                             "set: %s\n", argv[arg]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        else if (!std::strcmp(argv[arg], "--json") && arg + 1 < argc)
+            j.json_path = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--ppm-path") && arg + 1 < argc)
+            j.ppm_path = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--compare") && arg + 2 < argc)
+        {
+            compare_old = argv[++arg];
+            compare_new = argv[++arg];
+        }
+
+        else if (!std::strcmp(argv[arg], "--threshold") && arg + 1 < argc)
+            threshold = std::atof(argv[++arg]);
+
+        else
+        {
+            std::fprintf(
+                stderr,
+                "Usage: %s [--poly name] [--no-micro] [--no-macro] "
+                "[--sizes list] [--threads list] [--frames n] "
+                "[--isa auto | baseline | avx2 | avx512] [--json file] "
+                "[--ppm-path file]\n"
+                "       %s --compare old.json new.json "
+                "[--threshold percent]\n",
+                argv[0], argv[0]
+            );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (compare_old)
+    {
+        const bool ok = qnf::benchmark::compare_files(compare_old,
+                                                      compare_new, threshold);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!qnf::visit_polynomial(poly, j, &status))
+    {
+        std::fprintf(stderr, "Unknown polynomial: %s (choose from %s)\n",
+                     poly, qnf::polynomial_names);
+        return EXIT_FAILURE;
+    }
+
+    return status;
+}
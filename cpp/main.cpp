@@ -25,98 +25,1248 @@
  *  Date:   2024/01/25                                                        *
  ******************************************************************************/
 #include "qnf.hpp"
+#include "qnf_output.hpp"
+#include "qnf_benchmark.hpp"
+#include "qnf_method.hpp"
+#include "qnf_config.hpp"
+#include "qnf_pyramid.hpp"
+#include "qnf_service.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
-#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
-static inline qnf::quaternion func(const qnf::quaternion &q)
+/*  The settings of one run, from the command line or a job of a batch, and   *
+ *  what to do with the polynomial once it has been chosen. visit_polynomial  *
+ *  calls run<Poly>() with the polynomial as a type, and visit_method then    *
+ *  calls run_method<Method>() with it wrapped in the root-finding method, so *
+ *  each polynomial and method gets its own compiled copy of the renderer.    */
+struct job {
+    unsigned int n_threads;
+    const char *poly;
+    const char *output;
+    const char *encoder;
+    const char *name;
+    bool check;
+    bool bench;
+    bool fast_color;
+    const char *recolor_dir;
+    const char *method;
+    const char *telemetry_path;
+    double eps;
+    unsigned int xsize, ysize;
+    double window[4];
+    bool has_window;
+    bool still;
+    unsigned int still_frame;
+    const char *pyramid;
+    unsigned int zoom;
+    unsigned int tiles[4];
+    bool has_tiles;
+    unsigned int cached_tiles;
+    const char *batch;
+    unsigned int overlap;
+    const char *serve;
+    const char *connect;
+    const char *format;
+    unsigned int queue;
+    bool stop;
+
+    /*  The pool of a batch or of the service, shared by its jobs. Null to    *
+     *  start one.                                                            */
+    qnf::thread_pool *shared_pool;
+
+    /*  For a request of the service: the image is rendered into *image,      *
+     *  and tiles come from the service's cache.                              */
+    qnf::framebuffer *image;
+    qnf::tile_cache *shared_tiles;
+    qnf::render_options opts;
+
+    template <class Poly>
+    int run(void)
+    {
+        int status = EXIT_FAILURE;
+
+        if (!qnf::visit_method<Poly>(method, *this, &status))
+            std::fprintf(stderr, "Unknown method: %s (choose from %s)\n",
+                         method, qnf::method_names);
+
+        else if (bench)
+        {
+            qnf::thread_pool pool(n_threads);
+
+            if (fast_color)
+                qnf::benchmark::compare_methods<Poly>(
+                    pool, qnf::colorers::sphere_fast(eps), opts
+                );
+            else
+                qnf::benchmark::compare_methods<Poly>(
+                    pool, qnf::colorers::sphere(eps), opts
+                );
+        }
+
+        return status;
+    }
+
+    template <class Method>
+    int run_method(void)
+    {
+        if (fast_color)
+            return run_with<Method>(qnf::colorers::sphere_fast(eps));
+
+        return run_with<Method>(qnf::colorers::sphere(eps));
+    }
+
+    template <class Poly, class Colorer>
+    int run_with(const Colorer &colorer)
+    {
+        if (shared_pool)
+            return run_on<Poly>(*shared_pool, colorer);
+
+        qnf::thread_pool pool(n_threads);
+        return run_on<Poly>(pool, colorer);
+    }
+
+    template <class Poly, class Colorer>
+    int run_on(qnf::thread_pool &pool, const Colorer &colorer)
+    {
+        bool success;
+
+        if (check)
+            success = qnf::verify<Poly>(pool, colorer, opts) &&
+                      qnf::verify_colorers<Poly>(
+                          pool, qnf::colorers::sphere(eps),
+                          qnf::colorers::sphere_fast(eps), opts,
+                          "Fast coloring vs. std::atan2"
+                      );
+
+        else if (bench)
+            success = qnf::benchmark::newton_step<Poly>(opts.eps_sq,
+                                                        opts.max_iters,
+                                                        opts.isa);
+
+        else if (image)
+            success = render_image<Poly>(pool, colorer);
+
+        else if (pyramid)
+            success = pyramid_tiles<Poly>(pool, colorer);
+
+        else if (still)
+        {
+            const std::string path = std::string(name) + ".ppm";
+            success = qnf::render_bands<Poly>(pool, colorer, path.c_str(),
+                                              still_frame, opts);
+        }
+
+        else if (!std::strcmp(output, "pipe"))
+        {
+            qnf::output::encoder_pipe out(
+                encoder ? std::string(encoder)
+                        : qnf::output::stream_command(name)
+            );
+            qnf::output::async<qnf::output::encoder_pipe>
+                writer(out, opts.frames_in_flight);
+            success = frames<Poly>(pool, colorer, writer);
+        }
+        else if (!std::strcmp(output, "files") || !std::strcmp(output, "ppm"))
+        {
+            qnf::output::ppm_files out(!std::strcmp(output, "files"), name);
+            qnf::output::async<qnf::output::ppm_files>
+                writer(out, opts.frames_in_flight);
+            success = frames<Poly>(pool, colorer, writer);
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown output back end: %s\n", output);
+            return EXIT_FAILURE;
+        }
+
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /*  Renders the frames, or colors them from saved results.               */
+    template <class Poly, class Colorer, class Output>
+    bool frames(qnf::thread_pool &pool, const Colorer &colorer, Output &out)
+    {
+        if (recolor_dir)
+            return qnf::recolor(pool, colorer, out, recolor_dir, opts);
+
+        return qnf::render<Poly>(pool, colorer, out, opts);
+    }
+
+    /*  Everything besides the polynomial and method that changes the pixels  *
+     *  of a tile, for qnf::settings_tag.                                     */
+    std::string pyramid_tag(void) const
+    {
+        char settings[256];
+        const qnf::view &w = opts.window;
+
+        std::snprintf(settings, sizeof(settings),
+                      "%.17g %u %d %d %d %u %.17g %.17g %.17g %.17g %u %u",
+                      opts.eps_sq, opts.max_iters, fast_color ? 1 : 0,
+                      static_cast<int>(opts.precision),
+                      static_cast<int>(opts.subdivide), opts.tile_size,
+                      w.x_start, w.y_start, w.pxfact, w.pyfact,
+                      w.xsize, w.ysize);
+
+        return qnf::settings_tag(poly, method, settings);
+    }
+
+    /*  Renders the image a request of the service asks for into *image: the  *
+     *  tile (x0, y0) of level "zoom" with --tiles, else the whole window.    *
+     *  Either way of frame still_frame.                                      */
+    template <class Poly, class Colorer>
+    bool render_image(qnf::thread_pool &pool, const Colorer &colorer)
+    {
+        qnf::view v = opts.window;
+
+        if (has_tiles)
+        {
+            qnf::tile_address a;
+
+            a.tag = pyramid_tag();
+            a.zoom = zoom;
+            a.x = tiles[0];
+            a.y = tiles[1];
+            a.frame = still_frame;
+            a.n_frames = opts.n_frames;
+            qnf::pyramid_tile<Poly>(pool, colorer, *shared_tiles, a, opts,
+                                    *image);
+            return true;
+        }
+
+        v.rotate_frame(still_frame, opts.n_frames);
+        *image = qnf::framebuffer(v.xsize, v.ysize);
+        qnf::render_view<Poly>(pool, colorer, v, opts, *image);
+        return true;
+    }
+
+    /*  Gets the tiles x0 <= x <= x1, y0 <= y <= y1 of level "zoom" of the    *
+     *  pyramid of frame still_frame, rendering those not in the cache.       */
+    template <class Poly, class Colorer>
+    bool pyramid_tiles(qnf::thread_pool &pool, const Colorer &colorer)
+    {
+        typedef std::chrono::steady_clock clock;
+        qnf::tile_cache cache(pyramid, cached_tiles);
+        qnf::framebuffer fb(0U, 0U);
+        qnf::tile_address a;
+        unsigned long int n_tiles = 0UL, rendered = 0UL;
+        const clock::time_point start = clock::now();
+
+        a.tag = pyramid_tag();
+        a.zoom = zoom;
+        a.frame = still_frame;
+        a.n_frames = opts.n_frames;
+
+        for (a.y = tiles[1]; a.y <= tiles[3]; ++a.y)
+        {
+            for (a.x = tiles[0]; a.x <= tiles[2]; ++a.x)
+            {
+                rendered += qnf::pyramid_tile<Poly>(pool, colorer, cache, a,
+                                                    opts, fb) ? 1UL : 0UL;
+                ++n_tiles;
+            }
+        }
+
+        if (opts.progress)
+        {
+            const std::chrono::duration<double> elapsed = clock::now() - start;
+            std::printf("Level %u: %lu tiles in %.2f s, %lu rendered, %lu "
+                        "from disk, in %s/%s_*.\n", zoom, n_tiles,
+                        elapsed.count(), rendered, cache.disk_hits.load(),
+                        pyramid, a.tag.c_str());
+        }
+
+        return true;
+    }
+};
+
+/*  The settings of a run without flags.                                      */
+static void set_defaults(job *j)
 {
-    return q.cube() - 1.0;
+    j->n_threads = 0U;
+    j->poly = "z3-1";
+    j->output = "pipe";
+    j->encoder = 0;
+    j->name = "fractal";
+    j->check = false;
+    j->bench = false;
+    j->fast_color = false;
+    j->recolor_dir = 0;
+    j->method = "newton";
+    j->telemetry_path = 0;
+    j->eps = 1.0E-8;
+    j->xsize = qnf::setup::xsize;
+    j->ysize = qnf::setup::ysize;
+    j->has_window = false;
+    j->still = false;
+    j->still_frame = 0U;
+    j->pyramid = 0;
+    j->zoom = 0U;
+    j->has_tiles = false;
+    j->cached_tiles = 64U;
+    j->batch = 0;
+    j->overlap = 2U;
+    j->serve = 0;
+    j->connect = 0;
+    j->format = "ppm";
+    j->queue = 16U;
+    j->stop = false;
+    j->shared_pool = 0;
+    j->image = 0;
+    j->shared_tiles = 0;
 }
 
-static inline qnf::quaternion newton(const qnf::quaternion &q)
+/*  Reads the flags in argv[1] to argv[argc - 1] into j, on top of what j     *
+ *  holds already. Prints the usage and returns false for an unknown flag.    */
+static bool parse_flags(int argc, char **argv, job *j)
 {
-    qnf::quaternion num = q.cube()*2.0 + 1.0;
-    qnf::quaternion den = q.square() * 3.0;
-    return num / den;
+    unsigned int n;
+    int arg;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if ((!std::strcmp(argv[arg], "--threads") ||
+             !std::strcmp(argv[arg], "-t")) && arg + 1 < argc)
+            j->n_threads =
+                static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if ((!std::strcmp(argv[arg], "--output") ||
+                  !std::strcmp(argv[arg], "-o")) && arg + 1 < argc)
+            j->output = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--encoder") && arg + 1 < argc)
+            j->encoder = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--poly") && arg + 1 < argc)
+            j->poly = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--method") && arg + 1 < argc)
+            j->method = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--table"))
+            j->opts.use_table = true;
+
+        else if (!std::strcmp(argv[arg], "--no-balls"))
+            j->opts.use_balls = false;
+
+        else if (!std::strcmp(argv[arg], "--no-symmetry"))
+            j->opts.use_symmetry = false;
+
+        else if (!std::strcmp(argv[arg], "--isa") && arg + 1 < argc)
+        {
+            if (!qnf::parse_isa(argv[++arg], &j->opts.isa))
+            {
+                std::fprintf(stderr, "Unknown instruction set: %s (choose "
+                             "from auto, baseline, avx2, avx512)\n", argv[arg]);
+                return false;
+            }
+
+            if (!qnf::isa_supported(j->opts.isa))
+            {
+                std::fprintf(stderr, "This processor does not support %s.\n",
+                             argv[arg]);
+                return false;
+            }
+        }
+
+        else if (!std::strcmp(argv[arg], "--in-flight") && arg + 1 < argc)
+            j->opts.frames_in_flight =
+                static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--subdivide") && arg + 1 < argc &&
+                 !std::strcmp(argv[arg + 1], "color"))
+        {
+            j->opts.subdivide = qnf::subdivide_color;
+            ++arg;
+        }
+
+        else if (!std::strcmp(argv[arg], "--subdivide") && arg + 1 < argc &&
+                 !std::strcmp(argv[arg + 1], "fast"))
+        {
+            j->opts.subdivide = qnf::subdivide_fast;
+            ++arg;
+        }
+
+        else if (!std::strcmp(argv[arg], "--precision") && arg + 1 < argc &&
+                 !std::strcmp(argv[arg + 1], "double"))
+        {
+            j->opts.precision = qnf::precision_double;
+            ++arg;
+        }
+
+        else if (!std::strcmp(argv[arg], "--precision") && arg + 1 < argc &&
+                 !std::strcmp(argv[arg + 1], "single"))
+        {
+            j->opts.precision = qnf::precision_single;
+            ++arg;
+        }
+
+        else if (!std::strcmp(argv[arg], "--precision") && arg + 1 < argc &&
+                 !std::strcmp(argv[arg + 1], "mixed"))
+        {
+            j->opts.precision = qnf::precision_mixed;
+            ++arg;
+        }
+
+        else if (!std::strcmp(argv[arg], "--fast-color"))
+            j->fast_color = true;
+
+        else if (!std::strcmp(argv[arg], "--eps") && arg + 1 < argc)
+            j->eps = std::atof(argv[++arg]);
+
+        else if (!std::strcmp(argv[arg], "--max-iters") && arg + 1 < argc)
+            j->opts.max_iters =
+                static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--save-results") && arg + 1 < argc)
+            j->opts.results_dir = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--telemetry") && arg + 1 < argc)
+            j->telemetry_path = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--recolor") && arg + 1 < argc)
+            j->recolor_dir = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--verify"))
+            j->check = true;
+
+        else if (!std::strcmp(argv[arg], "--bench"))
+            j->bench = true;
+
+        else if (!std::strcmp(argv[arg], "--frames") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) > 0)
+            j->opts.n_frames =
+                static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--size") && arg + 2 < argc &&
+                 std::atoi(argv[arg + 1]) > 0 && std::atoi(argv[arg + 2]) > 0)
+        {
+            j->xsize = static_cast<unsigned int>(std::atoi(argv[++arg]));
+            j->ysize = static_cast<unsigned int>(std::atoi(argv[++arg]));
+        }
+
+        else if (!std::strcmp(argv[arg], "--still") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) >= 0)
+        {
+            j->still = true;
+            j->still_frame = static_cast<unsigned int>(std::atoi(argv[++arg]));
+        }
+
+        else if (!std::strcmp(argv[arg], "--band-rows") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) > 0)
+            j->opts.band_rows =
+                static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--pyramid") && arg + 1 < argc)
+            j->pyramid = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--zoom") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) >= 0)
+            j->zoom = static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--tiles") && arg + 4 < argc)
+        {
+            for (n = 0U; n < 4U; ++n)
+                j->tiles[n] =
+                    static_cast<unsigned int>(std::strtoul(argv[++arg], 0, 10));
+
+            j->has_tiles = true;
+        }
+
+        else if (!std::strcmp(argv[arg], "--tile-cache") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) >= 0)
+            j->cached_tiles =
+                static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--serve") && arg + 1 < argc)
+            j->serve = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--connect") && arg + 1 < argc)
+            j->connect = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--format") && arg + 1 < argc &&
+                 (!std::strcmp(argv[arg + 1], "ppm") ||
+                  !std::strcmp(argv[arg + 1], "raw")))
+            j->format = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--queue") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) >= 0)
+            j->queue = static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--stop"))
+            j->stop = true;
+
+        else if (!std::strcmp(argv[arg], "--name") && arg + 1 < argc)
+            j->name = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--batch") && arg + 1 < argc)
+            j->batch = argv[++arg];
+
+        else if (!std::strcmp(argv[arg], "--overlap") && arg + 1 < argc &&
+                 std::atoi(argv[arg + 1]) > 0)
+            j->overlap = static_cast<unsigned int>(std::atoi(argv[++arg]));
+
+        else if (!std::strcmp(argv[arg], "--window") && arg + 4 < argc)
+        {
+            for (n = 0U; n < 4U; ++n)
+                j->window[n] = std::atof(argv[++arg]);
+
+            j->has_window = true;
+        }
+
+        else
+        {
+            std::fprintf(
+                stderr,
+                "Usage: %s [--threads n] [--output pipe | files | ppm] "
+                "[--encoder cmd] [--poly name] [--method name] [--table] "
+                "[--no-balls] "
+                "[--no-symmetry] "
+                "[--in-flight k] [--isa auto | baseline | avx2 | avx512] "
+                "[--subdivide color | fast] "
+                "[--precision double | single | mixed] [--fast-color] "
+                "[--eps e] [--max-iters n] [--save-results dir] "
+                "[--telemetry file] [--recolor dir] "
+                "[--verify] [--bench] [--frames n] [--size x y] "
+                "[--window x0 x1 y0 y1] [--config file] [--name name] "
+                "[--batch manifest] [--overlap k] [--still frame] "
+                "[--band-rows n] [--pyramid dir] [--zoom z] "
+                "[--tiles x0 y0 x1 y1] [--tile-cache n] [--serve socket] "
+                "[--connect socket] [--format ppm | raw] [--queue n] "
+                "[--stop]\n",
+                argv[0]
+            );
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+/*  Works out the settings that follow from the flags, once they are read.    */
+static bool prepare(job *j)
+{
+    j->opts.eps_sq = j->eps * j->eps;
+
+    /*  The default window, with its shorter side at [start, end] and the     *
+     *  other widened about the same center so that the pixels are square.    */
+    if (!j->has_window)
+    {
+        const double mid = 0.5 * (qnf::setup::start + qnf::setup::end);
+        const double half = 0.5 * (qnf::setup::end - qnf::setup::start);
+        const double x_half =
+            half * std::max(double(j->xsize) / j->ysize, 1.0);
+        const double y_half =
+            half * std::max(double(j->ysize) / j->xsize, 1.0);
+
+        j->window[0] = mid - x_half;
+        j->window[1] = mid + x_half;
+        j->window[2] = mid - y_half;
+        j->window[3] = mid + y_half;
+    }
+
+    if (!(j->window[0] < j->window[1]) || !(j->window[2] < j->window[3]))
+    {
+        std::fprintf(stderr, "The window must have x0 < x1 and y0 < y1.\n");
+        return false;
+    }
+
+    j->opts.window.set_window(j->window[0], j->window[1], j->window[2],
+                              j->window[3], j->xsize, j->ysize);
+
+    if (j->still && j->still_frame >= j->opts.n_frames)
+    {
+        std::fprintf(stderr, "The still must be one of the %u frames.\n",
+                     j->opts.n_frames);
+        return false;
+    }
+
+    if (j->zoom > qnf::tile_address::max_zoom())
+    {
+        std::fprintf(stderr, "The zoom may be at most %u.\n",
+                     qnf::tile_address::max_zoom());
+        return false;
+    }
+
+    /*  The whole level by default.                                           */
+    if (!j->has_tiles)
+    {
+        j->tiles[0] = j->tiles[1] = 0U;
+        j->tiles[2] = j->tiles[3] = (1U << j->zoom) - 1U;
+    }
+
+    if (j->tiles[0] > j->tiles[2] || j->tiles[1] > j->tiles[3] ||
+        (j->tiles[2] >> j->zoom) != 0U || (j->tiles[3] >> j->zoom) != 0U)
+    {
+        std::fprintf(stderr, "Level %u has tiles 0 to %u across and down.\n",
+                     j->zoom, (1U << j->zoom) - 1U);
+        return false;
+    }
+
+    /*  The name goes into the encoder's shell command.                       */
+    if (std::strspn(j->name, "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                             "abcdefghijklmnopqrstuvwxyz"
+                             "0123456789_-./") != std::strlen(j->name))
+    {
+        std::fprintf(stderr, "The name may only hold letters, digits and "
+                     "_-./, not \"%s\".\n", j->name);
+        return false;
+    }
+
+    return true;
+
 }
 
-#ifdef WEBP
-#define ANIMATION_COMMAND \
-"ffmpeg -framerate 23 -i fractal_%03d.ppm -loop 0 -lossless 1 fractal.webp"
-#else
-#define ANIMATION_COMMAND \
-"ffmpeg -framerate 23 -i fractal_%03d.ppm -plays 0 fractal.apng"
-#endif
+/*  Runs the job: opens its telemetry, renders, and closes it again.          */
+static int run_job(job &j)
+{
+    int status;
+
+    if (j.telemetry_path && !std::strcmp(j.telemetry_path, "-"))
+    {
+        j.opts.telemetry = stdout;
+        j.opts.progress = false;
+    }
+    else if (j.telemetry_path)
+    {
+        j.opts.telemetry = std::fopen(j.telemetry_path, "a");
+
+        if (!j.opts.telemetry)
+        {
+            std::fprintf(stderr, "Could not open %s.\n", j.telemetry_path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!qnf::visit_polynomial(j.poly, j, &status))
+    {
+        std::fprintf(stderr, "Unknown polynomial: %s (choose from %s)\n",
+                     j.poly, qnf::polynomial_names);
+        status = EXIT_FAILURE;
+    }
 
-#define CLEANUP_COMMAND "rm -f *.ppm"
+    if (j.opts.telemetry && j.opts.telemetry != stdout)
+        std::fclose(j.opts.telemetry);
+
+    j.opts.telemetry = 0;
+    return status;
+}
 
-int main(void)
+/******************************************************************************
+ *  Function:                                                                 *
+ *      run_batch                                                             *
+ *  Purpose:                                                                  *
+ *      Renders every job of the manifest base.batch in this process.         *
+ *  Arguments:                                                                *
+ *      base (const job &):                                                   *
+ *          The settings from the command line, the defaults of each job.     *
+ *      program (const char *):                                               *
+ *          argv[0], for the usage message.                                   *
+ *  Output:                                                                   *
+ *      status (int):                                                         *
+ *          EXIT_SUCCESS if every job succeeded.                              *
+ *  Notes:                                                                    *
+ *      The manifest is a JSON array of objects, each holding the flags       *
+ *      of one job as a config file does (see qnf_config.hpp). Every job      *
+ *      is checked before the first one starts. Jobs are named job_000,       *
+ *      job_001, ... unless they set "name", which names their files.         *
+ *                                                                            *
+ *      The jobs share one thread pool and one render_cache, so threads,      *
+ *      frame buffers and basin tables are made once. base.overlap jobs       *
+ *      run at once, each on a thread of its own that only waits on the       *
+ *      pool. The tiles of one job fill the cores while another is            *
+ *      starting, finishing its last frames, or waiting for its encoder.      *
+ ******************************************************************************/
+static int run_batch(const job &base, const char *program)
 {
-    const unsigned int n_frames = 64U;
-    char name[20];
-    unsigned int frame;
-    const double angle_step = TWO_PI / static_cast<double>(n_frames);
-    const double eps = 1.0E-8;
-    const double eps_sq = 1.0E-16;
-    double angle = 0.0;
-
-    for (frame = 0U; frame < n_frames; ++frame)
-    {
-        const double cos_ang = std::cos(angle);
-        const double sin_ang = std::sin(angle);
-        const qnf::quaternion one = qnf::quaternion(1.0, 0.0, 0.0, 0.0);
-        const qnf::quaternion u0 = qnf::quaternion(cos_ang, sin_ang, 0.0, 0.0);
-        const qnf::quaternion u1 = qnf::quaternion(0.0, 0.0, cos_ang, sin_ang);
-        unsigned int x, y, iters;
-        qnf::color c;
-        std::sprintf(name, "fractal_%03u.ppm", frame);
-        qnf::ppm PPM = qnf::ppm(name);
-        PPM.init();
-
-        for (y = 0U; y < qnf::setup::ysize; ++y)
-        {
-            const double a0 = qnf::setup::start + qnf::setup::pyfact * y;
-
-            for (x = 0U; x < qnf::setup::xsize; ++x)
+    typedef std::chrono::steady_clock clock;
+    qnf::json::value manifest;
+    std::vector<qnf::arguments> args;
+    std::vector<std::string> names;
+    std::vector<job> jobs;
+    std::vector<int> status;
+    std::vector<std::thread> drivers;
+    std::atomic<unsigned int> next(0U);
+    unsigned int n, n_jobs, n_failed = 0U;
+    char name[32];
+
+    if (!qnf::json::read_file(base.batch, &manifest))
+        return EXIT_FAILURE;
+
+    if (manifest.kind != qnf::json::value::array_kind)
+    {
+        std::fprintf(stderr, "%s: expected a JSON array of jobs.\n",
+                     base.batch);
+        return EXIT_FAILURE;
+    }
+
+    n_jobs = static_cast<unsigned int>(manifest.items.size());
+    args.resize(n_jobs);
+    names.resize(n_jobs);
+    jobs.assign(n_jobs, base);
+    status.assign(n_jobs, EXIT_FAILURE);
+
+    for (n = 0U; n < n_jobs; ++n)
+    {
+        std::sprintf(name, "job_%03u", n);
+        names[n] = name;
+        jobs[n].name = names[n].c_str();
+        jobs[n].batch = 0;
+
+        if (!args[n].expand(program, manifest.items[n], base.batch) ||
+            !parse_flags(args[n].argc(), args[n].argv(), &jobs[n]) ||
+            !prepare(&jobs[n]))
+        {
+            std::fprintf(stderr, "%s: job %u is not valid.\n",
+                         base.batch, n);
+            return EXIT_FAILURE;
+        }
+
+        if (jobs[n].batch)
+        {
+            std::fprintf(stderr, "%s: job %u starts another batch.\n",
+                         base.batch, n);
+            return EXIT_FAILURE;
+        }
+    }
+
+    qnf::thread_pool pool(base.n_threads);
+    qnf::render_cache cache;
+    const clock::time_point start = clock::now();
+
+    for (n = 0U; n < n_jobs; ++n)
+    {
+        jobs[n].shared_pool = &pool;
+        jobs[n].opts.cache = &cache;
+        jobs[n].opts.progress = false;
+    }
+
+    for (n = 0U; n < std::min(base.overlap, n_jobs); ++n)
+    {
+        drivers.push_back(std::thread([&](void) {
+            unsigned int i;
+            qnf::thread_pool_helps() = false;
+
+            while ((i = next.fetch_add(1U)) < n_jobs)
             {
-                const double a1 = qnf::setup::start + qnf::setup::pxfact*x;
-                qnf::quaternion q = u0*a0 + u1*a1;
-                qnf::quaternion p = func(q);
-
-                for (iters = 0U; iters < qnf::setup::max_iters; ++iters)
-                {
-                    if (p.norm_sq() < eps_sq)
-                        break;
-
-                    q = newton(q);
-                    p = func(q);
-                }
-
-                if (p.norm_sq() > eps_sq)
-                    c = qnf::colors::black();
-
-                else if (qnf::dist(q, one) < eps)
-                    c = qnf::colors::white() * 0.5;
-                else
-                {
-                    const double rho_sq = q.dat[1]*q.dat[1] + q.dat[2]*q.dat[2];
-                    const double rho = std::sqrt(rho_sq);
-                    const double phi = std::atan2(q.dat[3], rho);
-                    const double theta = std::atan2(q.dat[2], q.dat[1]);
-                    c = qnf::sphere_color(phi, theta);
-                }
-
-                c.write(PPM);
+                const clock::time_point job_start = clock::now();
+                std::chrono::duration<double> elapsed;
+
+                status[i] = run_job(jobs[i]);
+                elapsed = clock::now() - job_start;
+                std::printf("Job %u of %u (%s): %s in %.2f s\n", i + 1U,
+                            n_jobs, jobs[i].name,
+                            status[i] == EXIT_SUCCESS ? "done" : "FAILED",
+                            elapsed.count());
             }
+        }));
+    }
+
+    for (n = 0U; n < drivers.size(); ++n)
+        drivers[n].join();
+
+    for (n = 0U; n < n_jobs; ++n)
+        n_failed += (status[n] == EXIT_SUCCESS ? 0U : 1U);
+
+    const std::chrono::duration<double> total = clock::now() - start;
+    std::printf("Rendered %u of %u jobs in %.2f s.\n",
+                n_jobs - n_failed, n_jobs, total.count());
+    return n_failed == 0U ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*  A request of the service: the connection to answer on, the flags, which   *
+ *  the job's strings point into, and the job they make. Requests with the    *
+ *  same key ask for the same image.                                          */
+struct request {
+    int fd;
+    std::string key;
+    qnf::arguments args;
+    job j;
+};
+
+typedef std::shared_ptr<request> request_ptr;
+
+/*  Makes r->j from base and the request line. Returns the reason as the      *
+ *  error line for the client if the request is not valid.                    */
+static const char *
+parse_request(const job &base, const char *program, const std::string &line,
+              request *r)
+{
+    const std::vector<std::string> words = qnf::service::split(line);
+    const job &j = r->j;
+    std::size_t n;
+
+    r->args.text.assign(1U, program);
+    r->key.clear();
+
+    for (n = 0U; n < words.size(); ++n)
+    {
+        r->args.text.push_back(words[n]);
+        r->key += (n > 0U ? " " : "") + words[n];
+    }
+
+    r->args.point();
+    r->j = base;
+    r->j.serve = 0;
+
+    if (!parse_flags(r->args.argc(), r->args.argv(), &r->j) ||
+        !prepare(&r->j))
+        return "error invalid flags\n";
+
+    if (j.serve || j.connect || j.batch || j.stop || j.check || j.bench ||
+        j.recolor_dir)
+        return "error flag not allowed in a request\n";
+
+    if (static_cast<double>(j.xsize) * j.ysize > 67108864.0)
+        return "error more than 2^26 pixels\n";
+
+    if (j.has_tiles && (j.tiles[0] != j.tiles[2] || j.tiles[1] != j.tiles[3]))
+        return "error one tile per request\n";
+
+    return 0;
+}
+
+/*  Renders the image of a batch of equal requests once and sends it to       *
+ *  each of them, as a PPM file or as raw RGB bytes.                          */
+static void answer(const std::vector<request_ptr> &batch)
+{
+    typedef std::chrono::steady_clock clock;
+    job &j = batch[0]->j;
+    qnf::framebuffer fb(0U, 0U);
+    const clock::time_point start = clock::now();
+    std::string head, body;
+    char text[64];
+    std::size_t n;
+    int status;
+
+    j.image = &fb;
+
+    if (!qnf::visit_polynomial(j.poly, j, &status))
+        status = EXIT_FAILURE;
+
+    if (status != EXIT_SUCCESS)
+        head = "error unknown polynomial or method\n";
+    else
+    {
+        if (!std::strcmp(j.format, "ppm"))
+        {
+            std::sprintf(text, "P6\n%u %u\n255\n", fb.xsize, fb.ysize);
+            body = text;
         }
 
-        PPM.close();
-        std::printf("Current Frame: %3u  Total: %u\n", frame + 1U, n_frames);
+        body.append(fb.data.begin(), fb.data.end());
+        std::sprintf(text, "ok %lu %u %u\n",
+                     static_cast<unsigned long int>(body.size()),
+                     fb.xsize, fb.ysize);
+        head = text;
+    }
 
-        angle += angle_step;
+    for (n = 0U; n < batch.size(); ++n)
+    {
+        qnf::service::send_text(batch[n]->fd, head);
+        qnf::service::send_text(batch[n]->fd, body);
+        ::close(batch[n]->fd);
     }
 
-    std::system(ANIMATION_COMMAND);
-    std::system(CLEANUP_COMMAND);
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+    std::printf("Answered %lu request%s for \"%s\" in %.1f ms.\n",
+                static_cast<unsigned long int>(batch.size()),
+                batch.size() > 1U ? "s" : "", batch[0]->key.c_str(),
+                1.0E3 * elapsed.count());
+    std::fflush(stdout);
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      run_server                                                            *
+ *  Purpose:                                                                  *
+ *      Answers render requests on the Unix domain socket base.serve until a  *
+ *      client sends "quit". See qnf_service.hpp for the protocol.            *
+ *  Arguments:                                                                *
+ *      base (const job &):                                                   *
+ *          The settings from the command line, the defaults of every         *
+ *          request.                                                          *
+ *      program (const char *):                                               *
+ *          argv[0], for the usage message.                                   *
+ *  Output:                                                                   *
+ *      status (int):                                                         *
+ *          EXIT_FAILURE if the socket could not be opened.                   *
+ *  Notes:                                                                    *
+ *      A request renders frame --still (0 by default) of its window, or a    *
+ *      single tile of the pyramid with --zoom and --tiles x y x y. The       *
+ *      thread pool, the tile cache (--pyramid and --tile-cache) and the      *
+ *      basin tables stay warm between requests.                              *
+ *                                                                            *
+ *      base.overlap requests are rendered at once on the one pool, however   *
+ *      many clients connect, so no more threads compute than the pool has.   *
+ *      Up to base.queue more wait, and the rest are answered "error busy"    *
+ *      at once. Requests that ask for the same image while they wait are     *
+ *      rendered once and answered together.                                  *
+ *                                                                            *
+ *      The request lines of all clients are read on the thread that accepts  *
+ *      connections with poll(), see qnf::service::line_reader, so a slow     *
+ *      client does not hold up the others. Clients that send no line within  *
+ *      10 seconds are dropped, and sending an answer gives up after 10       *
+ *      seconds without progress.                                             *
+ ******************************************************************************/
+static int run_server(const job &base, const char *program)
+{
+    qnf::service::admission_queue<request_ptr> queue(base.queue);
+    std::vector<std::thread> slots;
+    unsigned long int n_requests = 0UL, n_busy = 0UL;
+    std::string line;
+    unsigned int n;
+    const int listener = qnf::service::listen_at(base.serve);
+
+    if (listener < 0)
+        return EXIT_FAILURE;
+
+    qnf::service::line_reader lines(listener, 10U);
+
+    qnf::thread_pool pool(base.n_threads);
+    qnf::tile_cache tiles(base.pyramid, base.cached_tiles);
+
+    std::printf("Listening at %s with %u threads, %u requests at a time and "
+                "up to %u waiting.\n", base.serve, pool.size(), base.overlap,
+                base.queue);
+    std::fflush(stdout);
+
+    for (n = 0U; n < base.overlap; ++n)
+    {
+        slots.push_back(std::thread([&](void) {
+            std::vector<request_ptr> batch;
+            qnf::thread_pool_helps() = false;
+
+            while (queue.pop(batch))
+                answer(batch);
+        }));
+    }
+
+    for (;;)
+    {
+        const char *error;
+        request_ptr r;
+        int fd;
+
+        lines.next(&fd, &line);
+
+        if (line == "quit")
+        {
+            qnf::service::send_text(fd, "ok 0 0 0\n");
+            ::close(fd);
+            break;
+        }
+
+        r = std::make_shared<request>();
+        r->fd = fd;
+        error = parse_request(base, program, line, r.get());
+
+        if (!error)
+        {
+            r->j.shared_pool = &pool;
+            r->j.shared_tiles = &tiles;
+            r->j.opts.progress = false;
+            ++n_requests;
+
+            if (queue.push(r))
+                continue;
+
+            error = "error busy\n";
+            ++n_busy;
+        }
+
+        qnf::service::send_text(fd, error);
+        ::close(fd);
+    }
+
+    queue.close();
+
+    for (n = 0U; n < slots.size(); ++n)
+        slots[n].join();
+
+    ::close(listener);
+    ::unlink(base.serve);
+    std::printf("Stopped after %lu requests, %lu of them turned away as "
+                "busy. %lu tiles from memory, %lu from disk.\n", n_requests,
+                n_busy, tiles.memory_hits.load(), tiles.disk_hits.load());
+    return EXIT_SUCCESS;
+}
+
+/*  Sends the flags in argv to the server at j.connect as a request, or       *
+ *  "quit" with --stop, and writes the image it returns to j.name with .ppm,  *
+ *  or .rgb for --format raw. --connect and --name stay with the client, so   *
+ *  that clients asking for the same image send the same request.             */
+static int run_client(const job &j, int argc, char **argv)
+{
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    std::string line, reply, path;
+    std::vector<char> body;
+    unsigned long int n_bytes;
+    unsigned int x, y;
+    FILE *fp;
+    int arg, fd;
+
+    for (arg = 1; arg < argc && !j.stop; ++arg)
+    {
+        if (!std::strcmp(argv[arg], "--connect") ||
+            !std::strcmp(argv[arg], "--name"))
+        {
+            ++arg;
+            continue;
+        }
+
+        if (std::strpbrk(argv[arg], " \t\r\n"))
+        {
+            std::fprintf(stderr, "Flags sent to the server may not contain "
+                         "spaces: \"%s\".\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+
+        line += (line.empty() ? "" : " ") + std::string(argv[arg]);
+    }
+
+    if (j.stop)
+        line = "quit";
+
+    fd = qnf::service::connect_to(j.connect);
+
+    if (fd < 0)
+        return EXIT_FAILURE;
+
+    if (!qnf::service::send_text(fd, line + "\n") ||
+        !qnf::service::receive_line(fd, &reply))
+    {
+        std::fprintf(stderr, "The server at %s did not answer.\n", j.connect);
+        ::close(fd);
+        return EXIT_FAILURE;
+    }
+
+    if (std::sscanf(reply.c_str(), "ok %lu %u %u", &n_bytes, &x, &y) != 3)
+    {
+        std::fprintf(stderr, "The server answered: %s\n", reply.c_str());
+        ::close(fd);
+        return EXIT_FAILURE;
+    }
+
+    body.resize(n_bytes);
+
+    if (n_bytes > 0UL && !qnf::service::receive_all(fd, &body[0], n_bytes))
+    {
+        std::fprintf(stderr, "The server sent less than %lu bytes.\n",
+                     n_bytes);
+        ::close(fd);
+        return EXIT_FAILURE;
+    }
+
+    ::close(fd);
+
+    if (j.stop)
+        return EXIT_SUCCESS;
+
+    path = std::string(j.name) + (!std::strcmp(j.format, "raw") ? ".rgb"
+                                                                : ".ppm");
+    fp = std::fopen(path.c_str(), "wb");
+
+    if (!fp || std::fwrite(&body[0], 1UL, n_bytes, fp) != n_bytes)
+    {
+        std::fprintf(stderr, "Could not write %s.\n", path.c_str());
+
+        if (fp)
+            std::fclose(fp);
+
+        return EXIT_FAILURE;
+    }
+
+    std::fclose(fp);
+
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+    std::printf("Wrote %s, %ux%u pixels, in %.1f ms.\n", path.c_str(), x, y,
+                1.0E3 * elapsed.count());
+    return EXIT_SUCCESS;
+}
+
+/*  Usage: main [--threads n] [--output pipe | files | ppm] [--encoder cmd]   *
+ *              [--poly name] [--method name] [--table] [--no-balls]          *
+ *              [--no-symmetry]                                               *
+ *              [--in-flight k]                                               *
+ *              [--isa auto | baseline | avx2 | avx512]                       *
+ *              [--subdivide color | fast] [--precision double | single |     *
+ *              mixed] [--fast-color] [--eps e] [--max-iters n]               *
+ *              [--save-results dir] [--telemetry file]                       *
+ *              [--recolor dir] [--verify] [--bench]                          *
+ *              [--frames n] [--size x y] [--window x0 x1 y0 y1]              *
+ *              [--config file] [--name name] [--batch manifest]              *
+ *              [--overlap k] [--still frame] [--band-rows n]                 *
+ *              [--pyramid dir] [--zoom z] [--tiles x0 y0 x1 y1]              *
+ *              [--tile-cache n] [--serve socket] [--connect socket]          *
+ *              [--format ppm | raw] [--queue n] [--stop]                     *
+ *      --threads n   Number of worker threads. With n = 0 (the default) one  *
+ *                    thread per core is used. Every thread count produces    *
+ *                    byte-identical frames.                                  *
+ *      --output      pipe (default): stream frames into the encoder.         *
+ *                    files: write fractal_%03u.ppm, encode, then delete them.*
+ *                    ppm: only write the fractal_%03u.ppm frames.            *
+ *      --encoder     Shell command that reads the PPM stream on stdin, used  *
+ *                    by the pipe back end. Defaults to STREAM_COMMAND.       *
+ *      --poly        The polynomial, one of qnf::polynomial_names. Defaults  *
+ *                    to z3-1.                                                *
+ *      --method      The root-finding method, one of qnf::method_names:      *
+ *                    newton (default), damped (7/8 of each Newton step),     *
+ *                    halley or schroeder. Each gives a different fractal.    *
+ *      --table       Precompute a table of basins over (real part, vector    *
+ *                    norm) and look pixels up in it. Only the boundary       *
+ *                    pixels are iterated. Needs real coefficients.           *
+ *      --no-balls    Iterate every orbit until |p(q)| < eps, instead of      *
+ *                    stopping it at the root once it enters a disc about the *
+ *                    root where Newton's method is known to converge. Only   *
+ *                    matters with real coefficients and --method newton, the *
+ *                    frames are the same.                                    *
+ *      --no-symmetry Render every frame, instead of deriving frames related  *
+ *                    by a half turn or a reflection from each other.         *
+ *      --isa         Instruction set the Newton loops run with. auto (the    *
+ *                    default) picks the newest one the processor supports,   *
+ *                    the others force a level, e.g. for benchmarking. Also   *
+ *                    applies to --bench.                                     *
+ *      --in-flight k Iterate up to k frames at once and queue up to k       *
+ *                    rendered frames for a writer thread, so output overlaps *
+ *                    with computing. Defaults to 4. At 1024x1024 each frame  *
+ *                    in flight costs 3 to 9 MB.                              *
+ *      --subdivide   Iterate only the borders of rectangles inside a tile,   *
+ *                    splitting them until each border lies in one basin, and *
+ *                    fill the inside. color: only if the border has a        *
+ *                    single color. fast: color the inside from the root, for *
+ *                    real coefficients and away from the line through the    *
+ *                    origin where the slice folds the plane (color           *
+ *                    otherwise). Neither is exact, see --verify.             *
+ *      --precision   double (default): iterate in double. single: iterate in *
+ *                    float, twice as many pixels per register, and finish    *
+ *                    each orbit in double. mixed: as single, but pixels that *
+ *                    did not converge in float are run again in double.      *
+ *      --fast-color  Color with a polynomial atan2 instead of std::atan2.    *
+ *                    The angles are within 4E-8 radians, a handful of pixels *
+ *                    per frame change by one level.                          *
+ *      --eps e       Newton's method stops once |p(q)| < e. Defaults to 1E-8.*
+ *      --max-iters n Newton's method stops after n steps if it has not       *
+ *                    converged. Defaults to 32. Orbits that cycle, or are    *
+ *                    too far out to come back in the steps left, are stopped *
+ *                    early, so raising it mostly costs the slow basins.      *
+ *      --save-results dir                                                    *
+ *                    Also store the final point, residual, step count and    *
+ *                    root of every pixel in dir/result_%03u.qnr, one         *
+ *                    memory-mapped file per frame (24 bytes per pixel).      *
+ *                    Every frame is then rendered, without symmetry or       *
+ *                    subdivision. With --table, pixels in uniform cells are  *
+ *                    still looked up, and store the table's step count.      *
+ *      --telemetry file                                                      *
+ *                    Append a line of JSON per frame to file: the time spent *
+ *                    iterating, coloring and writing, pixels per second, the *
+ *                    Newton steps and their histogram, and the shares of     *
+ *                    pixels that converged, ended on a real root, or did     *
+ *                    not converge. See qnf_telemetry.hpp. With "-" the lines *
+ *                    go to stdout instead of the progress lines.             *
+ *      --recolor dir Do not iterate, color the frames saved in dir with      *
+ *                    --save-results instead, e.g. with --fast-color. --poly  *
+ *                    is ignored, and --eps may only be looser than before.   *
+ *      --verify      Render nothing, instead check the complex-slice kernel, *
+ *                    the basin table, the root balls, subdivision, the       *
+ *                    kernels for each instruction set, single and mixed      *
+ *                    precision, stopping orbits early and the frames derived *
+ *                    by symmetry against direct iteration, and the fast      *
+ *                    coloring against std::atan2.                            *
+ *      --bench       Render nothing, instead time the method with the fused  *
+ *                    eval and step against newton followed by func, then     *
+ *                    render a few frames with every method and compare their *
+ *                    steps per pixel, time per frame and pixels.             *
+ *      --frames n    Number of frames in one full turn. Defaults to 64.      *
+ *      --size x y    Frames of x by y pixels. Defaults to 1024 by 1024.      *
+ *                    Without --window the default window keeps its shorter   *
+ *                    side at [-3, 3] and is widened to square pixels.        *
+ *      --window x0 x1 y0 y1                                                  *
+ *                    Draw [x0, x1] horizontally and [y0, y1] vertically.     *
+ *                    Defaults to [-3, 3] by [-3, 3]. Frames keep the         *
+ *                    symmetry shortcut only if the window is symmetric about *
+ *                    the origin pixel for pixel.                             *
+ *      --config file Read flags from the JSON object in file, each member    *
+ *                    "key": value standing for --key value. true stands for  *
+ *                    the bare flag, arrays for several values, e.g.          *
+ *                    {"size": [1920, 1080], "output": "ppm"}. Flags after    *
+ *                    --config override the file. See qnf_config.hpp.         *
+ *      --name name   Name of the animation, fractal by default: the pipe     *
+ *                    and files back ends write name.webp or name.apng, and   *
+ *                    the frames are name_%03u.ppm.                           *
+ *      --batch manifest                                                      *
+ *                    Render every job of manifest, a JSON array of objects   *
+ *                    with the flags of each job as in a config file, in this *
+ *                    process. The flags on the command line are the defaults *
+ *                    of every job. See run_batch.                            *
+ *      --overlap k   Jobs of a batch that run at once. Defaults to 2.        *
+ *      --still frame Render only the given frame of the turn, to name.ppm,   *
+ *                    in bands of rows that are written as they finish, so    *
+ *                    images far larger than memory can be drawn, e.g.        *
+ *                    --size 32768 32768. --output, --table and --recolor are *
+ *                    ignored. Prints the peak resident memory at the end.    *
+ *      --band-rows n Rows per band of --still. Defaults to 128. Up to        *
+ *                    --in-flight bands are iterated at once.                 *
+ *      --pyramid dir Render tiles of a zoom pyramid of the frame given by    *
+ *                    --still (0 by default) instead, each with the size of   *
+ *                    the frame: level z splits the window into 2^z by 2^z    *
+ *                    tiles. Tiles are cached as PPM files in dir and only    *
+ *                    rendered if they are not there. See qnf_pyramid.hpp.    *
+ *      --zoom z      Level of the pyramid, 0 (the default) to 31.            *
+ *      --tiles x0 y0 x1 y1                                                   *
+ *                    Only the tiles x0 <= x <= x1, y0 <= y <= y1 of the      *
+ *                    level. Every tile of the level by default.              *
+ *      --tile-cache n                                                        *
+ *                    Tiles the pyramid keeps in memory. Defaults to 64.      *
+ *      --serve socket                                                        *
+ *                    Run as a service: answer render requests on the Unix    *
+ *                    domain socket, with one warm pool and tile cache for    *
+ *                    all of them. The other flags are the defaults of every  *
+ *                    request, and --overlap k requests render at once. See   *
+ *                    run_server.                                             *
+ *      --connect socket                                                      *
+ *                    Send the other flags to the service at socket as a      *
+ *                    request and write the image to name.ppm, or name.rgb    *
+ *                    with --format raw.                                      *
+ *      --format      ppm (default): the service answers with a PPM file.     *
+ *                    raw: only the RGB bytes, row by row.                    *
+ *      --queue n     Requests the service holds while others render. Beyond  *
+ *                    that it answers "error busy". Defaults to 16.           *
+ *      --stop        With --connect, stop the service instead.               */
+int main(int argc, char **argv)
+{
+    qnf::arguments args;
+    job j;
+
+    set_defaults(&j);
+
+    /*  Config files are read into the command line, where --config stood.    */
+    if (!args.expand(argc, argv))
+        return EXIT_FAILURE;
+
+    argc = args.argc();
+    argv = args.argv();
+
+    if (!parse_flags(argc, argv, &j) || !prepare(&j))
+        return EXIT_FAILURE;
+
+    if (j.connect)
+        return run_client(j, argc, argv);
+
+    if (j.serve)
+        return run_server(j, argv[0]);
+
+    if (j.batch)
+        return run_batch(j, argv[0]);
+
+    return run_job(j);
 }
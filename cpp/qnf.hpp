@@ -32,10 +32,1433 @@
 #include "qnf_color.hpp"
 #include "qnf_ppm.hpp"
 #include "qnf_pi.hpp"
+#include "qnf_thread_pool.hpp"
+#include "qnf_view.hpp"
+#include "qnf_colorer.hpp"
+#include "qnf_polynomial.hpp"
+#include "qnf_basin_table.hpp"
+#include "qnf_root_ball.hpp"
+#include "qnf_kernel.hpp"
+#include "qnf_symmetry.hpp"
+#include "qnf_cpu.hpp"
+#include "qnf_result.hpp"
+#include "qnf_telemetry.hpp"
 
-/*  TODO:
- *      Write the template. Use main.cpp as a guide.
- */
+/*  printf, for progress and for the verification report.                     */
+#include <cstdio>
+
+/*  abs for ints, fabs and sqrt.                                              */
+#include <cstdlib>
+#include <cmath>
+
+/*  std::max, std::min and std::swap.                                         */
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+/*  The cache shared by the renders of a batch.                               */
+#include <memory>
+#include <mutex>
+
+/*  std::integral_constant, used to skip real-only steps at compile time.     */
+#include <type_traits>
+#include <vector>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  An address unique to the type T, to tell the cache entries of         *
+     *  different polynomials and methods apart.                              */
+    template <class T>
+    inline const void *type_key(void)
+    {
+        static const char key = 0;
+        return &key;
+    }
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      render_cache                                                      *
+     *  Purpose:                                                              *
+     *      Frame buffers and basin tables kept from one render to the next,  *
+     *      for a process that renders many animations, see main's --batch.   *
+     *      Renders running at the same time may share one.                   *
+     *  Notes:                                                                *
+     *      A render takes the buffers of its size and frees the others, so   *
+     *      the cache holds no more buffers than the renders of one size      *
+     *      used. Up to max_tables basin tables are kept, the oldest is       *
+     *      dropped first. Renders still using a dropped table keep it alive. *
+     **************************************************************************/
+    struct render_cache {
+
+        /*  A basin table of the polynomial "type" and what it was built for. */
+        struct table_entry {
+            const void *type;
+            double bound, cell, eps_sq;
+            unsigned int max_iters;
+            std::shared_ptr<const void> table;
+        };
+
+        std::mutex lock;
+        std::vector<framebuffer> buffers;
+        std::vector<table_entry> tables;
+
+        static inline std::size_t max_tables(void)
+        {
+            return 4U;
+        }
+
+        /*  Moves the buffers of v.xsize by v.ysize pixels into "spare" and   *
+         *  frees the others.                                                 */
+        inline void take_buffers(const view &v, std::vector<framebuffer> &spare)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            std::size_t n;
+
+            for (n = 0U; n < buffers.size(); ++n)
+            {
+                if (buffers[n].xsize == v.xsize && buffers[n].ysize == v.ysize)
+                {
+                    spare.push_back(framebuffer(0U, 0U));
+                    std::swap(spare.back(), buffers[n]);
+                }
+            }
+
+            buffers.clear();
+        }
+
+        /*  Moves the allocated buffers among "frames" into the cache.        */
+        inline void give_buffers(std::vector<framebuffer> &frames)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            std::size_t n;
+
+            for (n = 0U; n < frames.size(); ++n)
+            {
+                if (frames[n].data.empty())
+                    continue;
+
+                buffers.push_back(framebuffer(0U, 0U));
+                std::swap(buffers.back(), frames[n]);
+            }
+        }
+    };
+
+    /*  Parameters for rendering the rotation.                                */
+    struct render_options {
+
+        /*  The window drawn and its size in pixels. Each frame turns its     *
+         *  plane, see view::rotate_frame. Defaults to the one in "setup".    */
+        view window;
+
+        /*  Number of frames in one full turn of the plane.                   */
+        unsigned int n_frames;
+
+        /*  Newton's method stops once |p(q)|^2 < eps_sq, or after max_iters. */
+        double eps_sq;
+        unsigned int max_iters;
+
+        /*  Side length of the square tiles handed to the thread pool.        */
+        unsigned int tile_size;
+
+        /*  Look basins up in a table over (real part, vector norm). Ignored  *
+         *  for polynomials without real coefficients.                        */
+        bool use_table;
+
+        /*  Finish complex orbits as soon as they enter a disc about a root   *
+         *  where Newton's method is known to converge, see root_balls.       *
+         *  Ignored for polynomials without real coefficients.                */
+        bool use_balls;
+
+        /*  Derive frames from others through the symmetries of the rotation  *
+         *  (see qnf::frame_symmetry) instead of rendering each one.          */
+        bool use_symmetry;
+
+        /*  Number of frames iterated at the same time. Their tiles share the *
+         *  pool, so the next frames start while the last tiles of the        *
+         *  current one finish. Each takes one or two frame buffers.          */
+        unsigned int frames_in_flight;
+
+        /*  Skip the iteration inside uniform basins by subdividing tiles,    *
+         *  see kernel::tile_subdivide. Takes precedence over the table.      */
+        subdivision subdivide;
+
+        /*  The instruction set the kernels run with, see qnf_cpu.hpp.        */
+        isa_level isa;
+
+        /*  Iterate in double, in single precision, or in single precision    *
+         *  with the doubtful pixels run again in double, see                 *
+         *  kernel::tile_single. Ignored with subdivision or the table.       */
+        precision_mode precision;
+
+        /*  Rows in each band of render_bands. Each band in flight takes a    *
+         *  buffer of 3*xsize*band_rows bytes.                                */
+        unsigned int band_rows;
+
+        /*  Print a line as each frame is written.                            */
+        bool progress;
+
+        /*  If set, the end of every orbit is also stored in a result file    *
+         *  per frame in this directory, see qnf::result_file, for recolor.   *
+         *  Every frame is then iterated, without symmetry or subdivision.    */
+        const char *results_dir;
+
+        /*  If set, a line of JSON per frame goes here, see telemetry_log.    *
+         *  Left null the kernels skip the counting altogether.               */
+        FILE *telemetry;
+
+        /*  If set, frame buffers and basin tables are taken from it and      *
+         *  handed back to it, instead of being made anew for every render.   */
+        render_cache *cache;
+
+        render_options(void)
+            : n_frames(64U), eps_sq(1.0E-16), max_iters(setup::max_iters),
+              tile_size(32U), use_table(false), use_balls(true),
+              use_symmetry(true),
+              frames_in_flight(4U), subdivide(subdivide_none),
+              isa(detect_isa()), precision(precision_double),
+              band_rows(128U), progress(true), results_dir(0), telemetry(0),
+              cache(0)
+        {
+            return;
+        }
+    };
+
+    /*  The largest coordinate the window v reaches, and the side of a cell   *
+     *  of its basin table: a pixel's width, but no more than 1/256, a little *
+     *  finer than the pixels of the default frames. Wrong lookups grow with  *
+     *  the cells, so small frames get as good a table as large ones. Large   *
+     *  frames and wide windows get coarser cells rather than more than about *
+     *  2^22 of them, up to rounding at the edges.                            */
+    inline void table_window(const view &v, double *bound, double *cell)
+    {
+        const double x_end = v.x_start + v.pxfact * v.xsize;
+        const double y_end = v.y_start + v.pyfact * v.ysize;
+        const double bx = std::max(std::fabs(v.x_start), std::fabs(x_end));
+        const double by = std::max(std::fabs(v.y_start), std::fabs(y_end));
+        double finest;
+
+        *bound = std::max(bx, by);
+
+        /*  The table is 2 bound by sqrt(2) bound, see build_table.           */
+        finest = *bound * std::sqrt(2.0 * std::sqrt(2.0) / 4194304.0);
+        *cell = std::max(finest, std::min(std::min(v.pxfact, v.pyfact),
+                                          1.0 / 256.0));
+    }
+
+    /*  Builds the basin table over every (real part, vector norm) the frames *
+     *  of the rotation can reach, with cells from table_window.              */
+    template <class Poly>
+    inline void build_table(basin_table<Poly> &table, thread_pool &pool,
+                            const view &v, const render_options &opts)
+    {
+        double bound, cell;
+        table_window(v, &bound, &cell);
+
+        /*  |Re(q)| <= |a0| and |Im(q)|^2 <= a0^2 + a1^2 for q = u0*a0+u1*a1. */
+        table.build(pool, -bound, bound, std::sqrt(2.0) * bound, cell,
+                    opts.eps_sq, opts.max_iters);
+    }
+
+    /*  The basin table for the window v from the cache, built and added if   *
+     *  it is not there. The build runs outside the lock, so two renders that *
+     *  start together may both build the same table.                         */
+    template <class Poly>
+    inline std::shared_ptr<const basin_table<Poly> >
+    cached_table(render_cache &cache, thread_pool &pool, const view &v,
+                 const render_options &opts)
+    {
+        std::shared_ptr<basin_table<Poly> > table;
+        render_cache::table_entry entry;
+        std::size_t n;
+
+        entry.type = type_key<Poly>();
+        entry.eps_sq = opts.eps_sq;
+        entry.max_iters = opts.max_iters;
+        table_window(v, &entry.bound, &entry.cell);
+
+        {
+            std::lock_guard<std::mutex> guard(cache.lock);
+
+            for (n = 0U; n < cache.tables.size(); ++n)
+            {
+                const render_cache::table_entry &e = cache.tables[n];
+
+                if (e.type == entry.type && e.bound == entry.bound &&
+                    e.cell == entry.cell && e.eps_sq == entry.eps_sq &&
+                    e.max_iters == entry.max_iters)
+                    return std::static_pointer_cast<const basin_table<Poly> >(
+                        e.table
+                    );
+            }
+        }
+
+        table = std::make_shared<basin_table<Poly> >();
+        build_table(*table, pool, v, opts);
+        entry.table = table;
+
+        {
+            std::lock_guard<std::mutex> guard(cache.lock);
+
+            if (cache.tables.size() >= render_cache::max_tables())
+                cache.tables.erase(cache.tables.begin());
+
+            cache.tables.push_back(entry);
+        }
+
+        return table;
+    }
+
+    /*  Real coefficients: build the table if it was asked for, or take it    *
+     *  from opts.cache, which "shared" then holds on to.                     */
+    template <class Poly>
+    inline const basin_table<Poly> *
+    maybe_build_table(basin_table<Poly> &table,
+                      std::shared_ptr<const basin_table<Poly> > &shared,
+                      thread_pool &pool, const view &v,
+                      const render_options &opts, std::true_type)
+    {
+        if (!opts.use_table)
+            return 0;
+
+        if (opts.cache)
+        {
+            shared = cached_table<Poly>(*opts.cache, pool, v, opts);
+            return shared.get();
+        }
+
+        build_table(table, pool, v, opts);
+        return &table;
+    }
+
+    /*  No real coefficients: the table does not apply.                      */
+    template <class Poly>
+    inline const basin_table<Poly> *
+    maybe_build_table(basin_table<Poly> &,
+                      std::shared_ptr<const basin_table<Poly> > &,
+                      thread_pool &, const view &, const render_options &,
+                      std::false_type)
+    {
+        return 0;
+    }
+
+    /*  Real coefficients and Newton's method: build the root balls if they   *
+     *  were asked for.                                                       */
+    template <class Poly>
+    inline const root_balls<Poly> *
+    maybe_build_balls(root_balls<Poly> &balls, const render_options &opts,
+                      std::true_type)
+    {
+        if (!opts.use_balls)
+            return 0;
+
+        balls.build(opts.eps_sq);
+        return &balls;
+    }
+
+    /*  No real coefficients, so the roots are not known, or another method,  *
+     *  which the balls do not hold for.                                      */
+    template <class Poly>
+    inline const root_balls<Poly> *
+    maybe_build_balls(root_balls<Poly> &, const render_options &,
+                      std::false_type)
+    {
+        return 0;
+    }
+
+    /*  Renders the tile t with k and adds the time to k's telemetry, for the *
+     *  worker that runs it.                                                  */
+    template <class Kernel>
+    inline void timed_tile(const Kernel &k, const tile &t, const view &v,
+                           framebuffer &fb)
+    {
+        const telemetry_log::clock::time_point start =
+            telemetry_log::clock::now();
+        k(t, v, fb);
+
+        const std::chrono::duration<double> elapsed =
+            telemetry_log::clock::now() - start;
+        k.telemetry->local().tile_seconds += elapsed.count();
+    }
+
+    /*  Moves a frame buffer out of "spare" into fb, or allocates one.        */
+    inline void take_buffer(std::vector<framebuffer> &spare, framebuffer &fb,
+                            const view &v)
+    {
+        if (spare.empty())
+            fb = framebuffer(v.xsize, v.ysize);
+        else
+        {
+            std::swap(fb, spare.back());
+            spare.pop_back();
+        }
+    }
+
+    /*  Moves fb into "spare" for later use.                                  */
+    inline void give_buffer(std::vector<framebuffer> &spare, framebuffer &fb)
+    {
+        spare.push_back(framebuffer(0U, 0U));
+        std::swap(spare.back(), fb);
+    }
+
+    /*  Fills "spare" from a render's cache, if it has one, and hands "spare" *
+     *  and the frame buffers back to it however the render returns.          */
+    struct buffer_lease {
+        render_cache *cache;
+        std::vector<framebuffer> &spare, &frames;
+
+        buffer_lease(render_cache *c, const view &v,
+                     std::vector<framebuffer> &s, std::vector<framebuffer> &f)
+            : cache(c), spare(s), frames(f)
+        {
+            if (cache)
+                cache->take_buffers(v, spare);
+        }
+
+        ~buffer_lease(void)
+        {
+            if (!cache)
+                return;
+
+            cache->give_buffers(spare);
+            cache->give_buffers(frames);
+        }
+    };
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      render                                                            *
+     *  Purpose:                                                              *
+     *      Renders the frames of the rotation of the plane through 1 and i   *
+     *      into the plane through j and k, and hands them to the output back *
+     *      end in order. With opts.use_symmetry only the lowest frame of     *
+     *      each class of qnf::frame_symmetry is iterated, colored for both   *
+     *      its own points and their conjugates by j, and the other frames of *
+     *      the class are copies of these, point reflected where needed.      *
+     *  Template Parameters:                                                  *
+     *      Poly:                                                             *
+     *          The polynomial, see qnf_polynomial.hpp.                       *
+     *      Colorer:                                                          *
+     *          The coloring policy, see qnf_colorer.hpp.                     *
+     *      Output:                                                           *
+     *          The output back end, see qnf_output.hpp.                      *
+     *  Arguments:                                                            *
+     *      pool (qnf::thread_pool &):                                        *
+     *          Threads the tiles of each frame are spread over.              *
+     *      colorer (const Colorer &):                                        *
+     *          Colors the pixels.                                            *
+     *      out (Output &):                                                   *
+     *          Receives the frames.                                          *
+     *      opts (const qnf::render_options &):                               *
+     *          Number of frames, convergence parameters, and so on.          *
+     *  Output:                                                               *
+     *      success (bool):                                                   *
+     *          False if the output back end failed.                          *
+     *  Notes:                                                                *
+     *      Derived frames are bit-identical to rendering them directly. The  *
+     *      price is memory: a frame's colors are kept until the last frame   *
+     *      derived from them is written. For 64 frames at 1024x1024 that     *
+     *      peaks at 32 buffers, about 100 MB.                                *
+     *                                                                        *
+     *      With opts.results_dir every frame has its own orbits to store, so *
+     *      symmetry is off, and subdivision too since it fills rectangles    *
+     *      without computing their points. Each slot in flight maps the      *
+     *      result file of its frame, 24 MB at 1024x1024.                     *
+     **************************************************************************/
+    template <class Poly, class Colorer, class Output>
+    inline bool render(thread_pool &pool, const Colorer &colorer,
+                       Output &out, const render_options &opts)
+    {
+        typedef std::integral_constant<bool, Poly::real_coefficients> real;
+        typedef std::integral_constant<
+            bool, Poly::real_coefficients && Poly::is_newton
+        > has_balls;
+        const unsigned int n_frames = opts.n_frames;
+        const bool use_symmetry = opts.use_symmetry && !opts.results_dir;
+        unsigned int frame;
+        view v = opts.window;
+        const std::vector<tile> tiles =
+            make_tiles(v.xsize, v.ysize, opts.tile_size, opts.tile_size);
+        const frame_symmetry symmetry(
+            n_frames,
+            use_symmetry && v.point_symmetric(),
+            use_symmetry && Poly::commutes_with_j
+        );
+        const std::vector<unsigned int> last_use = symmetry.last_use();
+        const unsigned int n_slots = std::max(opts.frames_in_flight, 1U);
+        std::vector<framebuffer> buffers(2U*n_frames, framebuffer(0U, 0U));
+        std::vector<framebuffer> spare;
+        const buffer_lease lease(opts.cache, v, spare, buffers);
+        std::vector<unsigned int> reps;
+        unsigned int launched = 0U, landed = 0U;
+        framebuffer reflected(v.xsize, v.ysize);
+        std::vector<tile> edges(2U);
+        basin_table<Poly> table;
+        std::shared_ptr<const basin_table<Poly> > shared_table;
+        root_balls<Poly> balls;
+
+        /*  One pass of Newton over the (real part, vector norm) plane        *
+         *  replaces the iteration in every frame, except on the boundaries.  */
+        kernel<Poly, Colorer> k(
+            colorer, opts.eps_sq, opts.max_iters,
+            maybe_build_table(table, shared_table, pool, v, opts, real())
+        );
+
+        /*  The frames being iterated, slot i % n_slots for the i-th frame of *
+         *  "reps". Each has its own plane, and its own mirror buffer set in  *
+         *  a copy of the kernel.                                             */
+        std::vector<view> views(n_slots, v);
+        std::vector<task_group> groups(n_slots);
+        std::vector<kernel<Poly, Colorer> > kernels;
+        std::vector<result_file> results(opts.results_dir ? n_slots : 0U);
+        orbit_stats stats;
+
+        /*  Telemetry: the counts of each slot, and those of every iterated   *
+         *  frame once it has landed, for the frames derived from it.         */
+        std::vector<frame_counters> counters(
+            opts.telemetry ? n_slots : 0U,
+            frame_counters(pool, opts.eps_sq, opts.max_iters)
+        );
+        std::vector<pixel_counts> frame_counts(opts.telemetry ? n_frames : 0U);
+        telemetry_log log(opts.telemetry);
+
+        k.stats = &stats;
+        k.balls = maybe_build_balls(balls, opts, has_balls());
+        k.subdivide = (opts.results_dir ? subdivide_none : opts.subdivide);
+        k.isa = opts.isa;
+        k.precision = opts.precision;
+        kernels.assign(n_slots, k);
+
+        /*  The frames that are iterated. Each is the lowest of its class, so *
+         *  it is needed first as itself and they are needed in this order.   */
+        for (frame = 0U; frame < n_frames; ++frame)
+            if (symmetry.of(frame).rep == frame)
+                reps.push_back(frame);
+
+        /*  Row 0 and column 0 of a reflected frame have no partner pixels    *
+         *  and are rendered directly.                                        */
+        edges[0].x0 = 0U;
+        edges[0].y0 = 0U;
+        edges[0].x1 = v.xsize;
+        edges[0].y1 = 1U;
+        edges[1].x0 = 0U;
+        edges[1].y0 = 1U;
+        edges[1].x1 = 1U;
+        edges[1].y1 = v.ysize;
+
+        if (!out.begin())
+            return false;
+
+        for (frame = 0U; frame < n_frames; ++frame)
+        {
+            const frame_symmetry::source src = symmetry.of(frame);
+            const unsigned int b = frame_symmetry::buffer(src);
+            const framebuffer *fb = &buffers[b];
+
+            /*  Start the tiles of the next frames to iterate, up to n_slots  *
+             *  ahead, without waiting for them. The workers move on to them  *
+             *  as the current frame runs out of tiles, and the frames that   *
+             *  follow are ready while this one is being written.             */
+            while (launched < reps.size() && launched < landed + n_slots)
+            {
+                const unsigned int r = reps[launched];
+                const unsigned int slot = launched % n_slots;
+                const bool need_mirror = (last_use[2U*r + 1U] < n_frames);
+                unsigned int n;
+
+                take_buffer(spare, buffers[2U*r], v);
+
+                if (need_mirror)
+                    take_buffer(spare, buffers[2U*r + 1U], v);
+
+                views[slot].rotate_frame(r, n_frames);
+                kernels[slot].mirror = (need_mirror ? &buffers[2U*r + 1U] : 0);
+
+                if (opts.results_dir)
+                {
+                    result_header h = make_result_header(
+                        v.xsize, v.ysize, r, n_frames, Poly::name()
+                    );
+
+                    h.eps_sq = opts.eps_sq;
+                    h.max_iters = opts.max_iters;
+
+                    if (!results[slot].create(opts.results_dir, h))
+                    {
+                        for (; landed < launched; ++landed)
+                            pool.wait(groups[landed % n_slots]);
+
+                        out.abort();
+                        return false;
+                    }
+
+                    kernels[slot].results = &results[slot];
+                }
+
+                if (opts.telemetry)
+                {
+                    counters[slot].reset();
+                    kernels[slot].telemetry = &counters[slot];
+                }
+
+                for (n = 0U; n < tiles.size(); ++n)
+                {
+                    const kernel<Poly, Colorer> *ks = &kernels[slot];
+                    const view *vs = &views[slot];
+                    const tile *t = &tiles[n];
+                    framebuffer *fs = &buffers[2U*r];
+
+                    if (opts.telemetry)
+                        pool.submit(groups[slot], [ks, vs, t, fs](void) {
+                            timed_tile(*ks, *t, *vs, *fs);
+                        });
+                    else
+                        pool.submit(groups[slot], [ks, vs, t, fs](void) {
+                            (*ks)(*t, *vs, *fs);
+                        });
+                }
+
+                ++launched;
+            }
+
+            if (landed < reps.size() && reps[landed] == src.rep)
+            {
+                pool.wait(groups[landed % n_slots]);
+
+                if (opts.results_dir)
+                    results[landed % n_slots].close();
+
+                if (opts.telemetry)
+                    frame_counts[src.rep] = counters[landed % n_slots].total();
+
+                ++landed;
+            }
+
+            if (src.reflect)
+            {
+                reflect(buffers[b], reflected);
+                v.rotate_frame(frame, n_frames);
+
+                pool.parallel_for(
+                    static_cast<unsigned int>(edges.size()),
+                    [&](unsigned int n) {
+                        k(edges[n], v, reflected);
+                    }
+                );
+
+                fb = &reflected;
+            }
+
+            const telemetry_log::clock::time_point write_start =
+                telemetry_log::clock::now();
+
+            if (!out.write_frame(frame, *fb))
+            {
+                for (; landed < launched; ++landed)
+                    pool.wait(groups[landed % n_slots]);
+
+                out.abort();
+                return false;
+            }
+
+            if (opts.telemetry)
+            {
+                const std::chrono::duration<double> write_time =
+                    telemetry_log::clock::now() - write_start;
+                log.frame(frame, src.rep, v.xsize, v.ysize,
+                          frame_counts[src.rep], write_time.count());
+            }
+
+            if (last_use[b] == frame)
+                give_buffer(spare, buffers[b]);
+
+            if (opts.progress)
+                std::printf("Current Frame: %3u  Total: %u\n",
+                            frame + 1U, n_frames);
+        }
+
+        if (opts.progress && symmetry.n_rendered() < n_frames)
+            std::printf("Iterated %u of %u frames, derived the rest by "
+                        "symmetry.\n", symmetry.n_rendered(), n_frames);
+
+        if (opts.progress && stats.steps_saved > 0UL)
+            std::printf("Stopped %lu cycling and %lu escaping orbits early, "
+                        "saving %lu Newton steps.\n",
+                        stats.cycling.load(), stats.escaping.load(),
+                        stats.steps_saved.load());
+
+        if (opts.progress && stats.in_ball > 0UL)
+            std::printf("Finished %lu orbits as they entered a root ball.\n",
+                        stats.in_ball.load());
+
+        if (!out.finish())
+            return false;
+
+        if (opts.telemetry)
+            log.finish(n_frames, symmetry.n_rendered());
+
+        return true;
+    }
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      render_bands                                                      *
+     *  Purpose:                                                              *
+     *      Renders one frame of the rotation into a PPM file a band of rows  *
+     *      at a time, for stills too large to hold in memory. Each band is   *
+     *      written as soon as it and the bands above it are done.            *
+     *  Template Parameters:                                                  *
+     *      Poly:                                                             *
+     *          The polynomial, see qnf_polynomial.hpp.                       *
+     *      Colorer:                                                          *
+     *          The coloring policy, see qnf_colorer.hpp.                     *
+     *  Arguments:                                                            *
+     *      pool (qnf::thread_pool &):                                        *
+     *          Threads the tiles of each band are spread over.               *
+     *      colorer (const Colorer &):                                        *
+     *          Colors the pixels.                                            *
+     *      path (const char *):                                              *
+     *          The PPM file to write.                                        *
+     *      frame (unsigned int):                                             *
+     *          The frame of the opts.n_frames frame turn to draw.            *
+     *      opts (const qnf::render_options &):                               *
+     *          The window, band_rows, frames_in_flight (the bands iterated   *
+     *          at once), convergence parameters, and so on.                  *
+     *  Output:                                                               *
+     *      success (bool):                                                   *
+     *          False if the file could not be written.                       *
+     *  Notes:                                                                *
+     *      Memory is bounded by the bands in flight, frames_in_flight times  *
+     *      3*xsize*band_rows bytes, whatever the height of the image: 50 MB  *
+     *      for a 32768 pixel wide image with the defaults. The caller writes *
+     *      a band while the workers iterate the next ones.                   *
+     *                                                                        *
+     *      Band buffers address pixels by their row in the image (see        *
+     *      framebuffer::first_row), and band_rows is rounded up to a         *
+     *      multiple of tile_size so the bands are cut into the same tiles as *
+     *      a whole frame. The pixels are bit-identical to those of render,   *
+     *      with subdivision too. The basin table stops at about 2^22 cells,  *
+     *      far coarser than the pixels of such an image, so opts.use_table   *
+     *      is ignored, as are symmetry, results_dir and telemetry, which     *
+     *      concern whole frames.                                             *
+     **************************************************************************/
+    template <class Poly, class Colorer>
+    inline bool render_bands(thread_pool &pool, const Colorer &colorer,
+                             const char *path, unsigned int frame,
+                             const render_options &opts)
+    {
+        typedef std::integral_constant<
+            bool, Poly::real_coefficients && Poly::is_newton
+        > has_balls;
+        typedef telemetry_log::clock clock;
+        view v = opts.window;
+        const unsigned int ts = opts.tile_size;
+        const unsigned int rows =
+            std::min((std::max(opts.band_rows, 1U) + ts - 1U) / ts * ts,
+                     v.ysize);
+        const unsigned int n_bands = (v.ysize + rows - 1U) / rows;
+        const unsigned int n_slots =
+            std::min(std::max(opts.frames_in_flight, 1U), n_bands);
+        const std::vector<tile> band_tiles =
+            make_tiles(v.xsize, rows, opts.tile_size, opts.tile_size);
+        std::vector<framebuffer> bands(n_slots, framebuffer(v.xsize, rows));
+        std::vector<std::vector<tile> > tiles(n_slots);
+        std::vector<task_group> groups(n_slots);
+        unsigned int launched = 0U, landed;
+        root_balls<Poly> balls;
+        orbit_stats stats;
+        kernel<Poly, Colorer> k(colorer, opts.eps_sq, opts.max_iters, 0);
+        const clock::time_point start = clock::now();
+        bool success = true;
+        ppm PPM(path);
+
+        if (!PPM.fp)
+            return false;
+
+        v.rotate_frame(frame, opts.n_frames);
+        k.stats = &stats;
+        k.balls = maybe_build_balls(balls, opts, has_balls());
+        k.subdivide = opts.subdivide;
+        k.isa = opts.isa;
+        k.precision = opts.precision;
+        PPM.init(v.xsize, v.ysize, 6);
+
+        for (landed = 0U; landed < n_bands; ++landed)
+        {
+            const unsigned int slot = landed % n_slots;
+            const unsigned int y0 = landed * rows;
+            const unsigned int y1 = std::min(y0 + rows, v.ysize);
+
+            /*  Start the bands below, up to n_slots ahead, so the workers    *
+             *  have tiles to iterate while this band is written.             */
+            while (success && launched < n_bands &&
+                   launched < landed + n_slots)
+            {
+                const unsigned int s = launched % n_slots;
+                const unsigned int b0 = launched * rows;
+                const unsigned int b1 = std::min(b0 + rows, v.ysize);
+                const kernel<Poly, Colorer> *ks = &k;
+                const view *vs = &v;
+                framebuffer *fs = &bands[s];
+                unsigned int n;
+
+                fs->first_row = b0;
+                fs->ysize = b1 - b0;
+                tiles[s].clear();
+
+                for (n = 0U; n < band_tiles.size(); ++n)
+                {
+                    tile t = band_tiles[n];
+                    t.y0 += b0;
+                    t.y1 = std::min(t.y1 + b0, b1);
+
+                    if (t.y0 < b1)
+                        tiles[s].push_back(t);
+                }
+
+                for (n = 0U; n < tiles[s].size(); ++n)
+                {
+                    const tile *t = &tiles[s][n];
+                    pool.submit(groups[s], [ks, vs, t, fs](void) {
+                        (*ks)(*t, *vs, *fs);
+                    });
+                }
+
+                ++launched;
+            }
+
+            if (landed >= launched)
+                break;
+
+            pool.wait(groups[slot]);
+
+            if (!success)
+                continue;
+
+            PPM.write(bands[slot], y0, y1);
+            success = !std::ferror(PPM.fp);
+
+            if (opts.progress)
+                std::printf("Current Band: %4u  Total: %u\n",
+                            landed + 1U, n_bands);
+        }
+
+        PPM.close();
+
+        if (opts.progress)
+        {
+            const std::chrono::duration<double> elapsed = clock::now() - start;
+            std::printf("Rendered %ux%u pixels in %u bands of %u rows in "
+                        "%.2f s, peak resident memory %.1f MB.\n",
+                        v.xsize, v.ysize, n_bands, rows, elapsed.count(),
+                        peak_resident_mb());
+        }
+
+        return success;
+    }
+
+    /*  Renders the plane and window of v into fb, which must be v.xsize by   *
+     *  v.ysize, with the tiles spread over the pool. For single images such  *
+     *  as the tiles of a pyramid, see qnf_pyramid.hpp. Like render_bands it  *
+     *  does not use the table, symmetry, results_dir or telemetry of opts.   */
+    template <class Poly, class Colorer>
+    inline void render_view(thread_pool &pool, const Colorer &colorer,
+                            const view &v, const render_options &opts,
+                            framebuffer &fb)
+    {
+        typedef std::integral_constant<
+            bool, Poly::real_coefficients && Poly::is_newton
+        > has_balls;
+        const std::vector<tile> tiles =
+            make_tiles(v.xsize, v.ysize, opts.tile_size, opts.tile_size);
+        root_balls<Poly> balls;
+        kernel<Poly, Colorer> k(colorer, opts.eps_sq, opts.max_iters, 0);
+
+        k.balls = maybe_build_balls(balls, opts, has_balls());
+        k.subdivide = opts.subdivide;
+        k.isa = opts.isa;
+        k.precision = opts.precision;
+
+        pool.parallel_for(
+            static_cast<unsigned int>(tiles.size()),
+            [&](unsigned int n) {
+                k(tiles[n], v, fb);
+            }
+        );
+    }
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      recolor                                                           *
+     *  Purpose:                                                              *
+     *      Colors the frames stored in a directory of result files, written  *
+     *      by render with opts.results_dir, and hands them to the output     *
+     *      back end in order. No Newton step is taken, so a new palette      *
+     *      costs a read of the files and one colorer call per pixel.         *
+     *  Template Parameters:                                                  *
+     *      Colorer:                                                          *
+     *          The coloring policy, see qnf_colorer.hpp.                     *
+     *      Output:                                                           *
+     *          The output back end, see qnf_output.hpp.                      *
+     *  Arguments:                                                            *
+     *      pool (qnf::thread_pool &):                                        *
+     *          Threads the rows of each frame are spread over.               *
+     *      colorer (const Colorer &):                                        *
+     *          Colors the pixels.                                            *
+     *      out (Output &):                                                   *
+     *          Receives the frames.                                          *
+     *      dir (const char *):                                               *
+     *          The directory of result_%03u.qnr files.                       *
+     *      opts (const qnf::render_options &):                               *
+     *          Only eps_sq and progress are used.                            *
+     *  Output:                                                               *
+     *      success (bool):                                                   *
+     *          False if a file is missing or does not match the first one,   *
+     *          if opts.eps_sq is tighter than the files were rendered with,  *
+     *          or if the output back end failed.                             *
+     *  Notes:                                                                *
+     *      The number of frames, the size and the polynomial come from the   *
+     *      files. The tolerance can be loosened but not tightened: an orbit  *
+     *      stopped at the first |p(q)|^2 below the old eps_sq, and would     *
+     *      have gone on for a smaller one.                                   *
+     **************************************************************************/
+    template <class Colorer, class Output>
+    inline bool recolor(thread_pool &pool, const Colorer &colorer, Output &out,
+                        const char *dir, const render_options &opts)
+    {
+        result_file file;
+        result_header first;
+        unsigned int frame;
+        framebuffer fb(0U, 0U);
+
+        if (!file.open(dir, 0U))
+            return false;
+
+        first = *file.header;
+
+        if (opts.eps_sq < first.eps_sq)
+        {
+            std::printf("ERROR: %s was rendered with eps^2 = %g, it cannot "
+                        "be recolored for eps^2 = %g.\n",
+                        dir, first.eps_sq, opts.eps_sq);
+            return false;
+        }
+
+        if (opts.progress)
+            std::printf("Recoloring %u frames of %s, %ux%u.\n",
+                        first.n_frames, first.poly, first.xsize, first.ysize);
+
+        fb = framebuffer(first.xsize, first.ysize);
+
+        if (!out.begin())
+            return false;
+
+        for (frame = 0U; frame < first.n_frames; ++frame)
+        {
+            if (frame > 0U && !file.open(dir, frame))
+            {
+                out.abort();
+                return false;
+            }
+
+            if (file.header->xsize != first.xsize ||
+                file.header->ysize != first.ysize ||
+                file.header->n_frames != first.n_frames ||
+                file.header->frame != frame ||
+                file.header->eps_sq != first.eps_sq)
+            {
+                std::printf("ERROR: Frame %u of %s does not belong to the "
+                            "same render as frame 0.\n", frame, dir);
+                out.abort();
+                return false;
+            }
+
+            pool.parallel_for(first.ysize, [&](unsigned int y) {
+                unsigned int x;
+
+                for (x = 0U; x < first.xsize; ++x)
+                {
+                    const pixel_result &r = file.at(x, y);
+                    colorer(r.point(), r.residual()).write(fb, x, y);
+                }
+            });
+
+            if (!out.write_frame(frame, fb))
+            {
+                out.abort();
+                return false;
+            }
+
+            if (opts.progress)
+                std::printf("Current Frame: %3u  Total: %u\n",
+                            frame + 1U, first.n_frames);
+        }
+
+        return out.finish();
+    }
+
+    /*  Counts the pixels of two frames where some color channel differs by   *
+     *  more than "slack", and finds the largest difference in any channel.   */
+    inline unsigned long int
+    count_differences(const framebuffer &a, const framebuffer &b, int *max_diff,
+                      int slack = 0)
+    {
+        unsigned long int n, m, differ = 0UL;
+        *max_diff = 0;
+
+        for (n = 0UL; n < a.size(); n += 3UL)
+        {
+            bool same = true;
+
+            for (m = n; m < n + 3UL; ++m)
+            {
+                const int d = std::abs(int(a.data[m]) - int(b.data[m]));
+                *max_diff = (d > *max_diff ? d : *max_diff);
+                same = same && (d <= slack);
+            }
+
+            differ += (same ? 0UL : 1UL);
+        }
+
+        return differ;
+    }
+
+    /*  Renders every frame of the rotation with two tile kernels and prints  *
+     *  how many pixels differ. Fails if any frame has more than "tolerance"  *
+     *  (as a fraction of the pixels) pixels that differ by more than one     *
+     *  level. A difference of one level is rounding in the coloring, e.g.    *
+     *  an orbit that ends a hair on the other side of theta = pi.            */
+    template <class KernelA, class KernelB>
+    inline bool
+    compare_kernels(thread_pool &pool, const render_options &opts,
+                    const char *title, const KernelA &kernel_a,
+                    const KernelB &kernel_b, double tolerance)
+    {
+        unsigned int frame;
+        view v = opts.window;
+        const std::vector<tile> tiles =
+            make_tiles(v.xsize, v.ysize, opts.tile_size, opts.tile_size);
+        const double n_pixels = static_cast<double>(v.xsize) *
+                                static_cast<double>(v.ysize);
+        framebuffer fb_a(v.xsize, v.ysize), fb_b(v.xsize, v.ysize);
+        unsigned long int total = 0UL, worst = 0UL, large = 0UL;
+        int max_diff = 0;
+        bool success = true;
+
+        for (frame = 0U; frame < opts.n_frames; ++frame)
+        {
+            unsigned long int differ, wrong;
+            int frame_diff;
+
+            v.rotate_frame(frame, opts.n_frames);
+
+            pool.parallel_for(
+                static_cast<unsigned int>(tiles.size()),
+                [&](unsigned int n) {
+                    kernel_a(tiles[n], v, fb_a);
+                    kernel_b(tiles[n], v, fb_b);
+                }
+            );
+
+            differ = count_differences(fb_a, fb_b, &frame_diff);
+            wrong = count_differences(fb_a, fb_b, &frame_diff, 1);
+
+            if (static_cast<double>(wrong) > tolerance * n_pixels)
+                success = false;
+
+            max_diff = (frame_diff > max_diff ? frame_diff : max_diff);
+            worst = (wrong > worst ? wrong : worst);
+            total += differ;
+            large += wrong;
+        }
+
+        std::printf("%s: %lu pixels differ in %u frames, %lu by more than one "
+                    "level, at most %lu (%.4f%%) in one frame, max channel "
+                    "difference %d. %s\n", title, total, opts.n_frames, large,
+                    worst, 100.0 * static_cast<double>(worst) / n_pixels,
+                    max_diff, success ? "PASSED" : "FAILED");
+        return success;
+    }
+
+    /*  Checks that finishing complex orbits in the root balls gives the same *
+     *  frames as iterating them to the end, and prints how many steps the    *
+     *  balls take and the share of the pixels finished in one.               */
+    template <class Poly, class Colorer>
+    inline bool verify_balls(thread_pool &pool, const Colorer &colorer,
+                             const render_options &opts, std::true_type)
+    {
+        typedef kernel<Poly, Colorer> kernel_type;
+        const kernel_type direct(colorer, opts.eps_sq, opts.max_iters);
+        kernel_type ball(colorer, opts.eps_sq, opts.max_iters);
+        root_balls<Poly> balls;
+        orbit_stats stats;
+        const view v = opts.window;
+        bool success;
+
+        balls.build(opts.eps_sq);
+        ball.balls = &balls;
+        ball.stats = &stats;
+
+        success = compare_kernels(
+            pool, opts, "Root balls vs. direct",
+            [&direct](const tile &t, const view &v, framebuffer &fb) {
+                direct.tile_slice(t, v, fb);
+            },
+            [&ball](const tile &t, const view &v, framebuffer &fb) {
+                ball.tile_slice(t, v, fb);
+            },
+            0.0
+        );
+
+        std::printf("Root balls: %u steps from entering one to converging, "
+                    "%.2f%% of the pixels finished in one.\n", balls.steps,
+                    100.0 * static_cast<double>(stats.in_ball) /
+                    (static_cast<double>(opts.n_frames) * v.xsize * v.ysize));
+
+        return success;
+    }
+
+    /*  The balls only hold for Newton's method.                              */
+    template <class Poly, class Colorer>
+    inline bool verify_balls(thread_pool &, const Colorer &,
+                             const render_options &, std::false_type)
+    {
+        return true;
+    }
+
+    /*  Checks the fast paths for real polynomials against the plain          *
+     *  iteration they replace:                                               *
+     *      1. The complex-slice kernel against the 4-dimensional iteration.  *
+     *         The two agree up to rounding, so only a few boundary pixels,   *
+     *         where the outcome is decided by the last bits, may change.     *
+     *      2. The basin table against direct iteration, with the table's     *
+     *         error estimate from random samples and the measured pixel      *
+     *         differences.                                                   *
+     *      3. For Newton's method, finishing orbits in the root balls        *
+     *         against iterating them to the end, see verify_balls.           */
+    template <class Poly, class Colorer>
+    inline bool verify(thread_pool &pool, const Colorer &colorer,
+                       const render_options &opts, std::true_type)
+    {
+        typedef kernel<Poly, Colorer> kernel_type;
+        typedef std::integral_constant<bool, Poly::is_newton> newton;
+        basin_table<Poly> table;
+        basin_table_error err;
+        bool success = true;
+        const kernel_type direct(colorer, opts.eps_sq, opts.max_iters);
+        const kernel_type lookup(colorer, opts.eps_sq, opts.max_iters, &table);
+
+        success = compare_kernels(
+            pool, opts, "Complex slice vs. 4D",
+            [&direct](const tile &t, const view &v, framebuffer &fb) {
+                direct.tile_4d(t, v, fb);
+            },
+            [&direct](const tile &t, const view &v, framebuffer &fb) {
+                direct.tile_slice(t, v, fb);
+            },
+            1.0E-3
+        ) && success;
+
+        build_table(table, pool, opts.window, opts);
+        err = table.estimate_error(1000000UL, 1U);
+        std::printf("Basin table: %u x %u cells, %.2f%% uniform. Wrong "
+                    "lookups: %lu of %lu samples, rate %.2e, 95%% bound "
+                    "%.2e\n", table.n_a, table.n_r, 100.0 * table.coverage(),
+                    err.mismatches, err.samples, err.rate, err.bound);
+
+        success = compare_kernels(
+            pool, opts, "Basin table vs. direct",
+            [&direct](const tile &t, const view &v, framebuffer &fb) {
+                direct.tile_slice(t, v, fb);
+            },
+            [&lookup](const tile &t, const view &v, framebuffer &fb) {
+                lookup.tile_table(t, v, fb);
+            },
+            1.0E-3
+        ) && success;
+
+        return verify_balls<Poly>(pool, colorer, opts, newton()) && success;
+    }
+
+    /*  Without real coefficients there is only the 4-dimensional kernel.    */
+    template <class Poly, class Colorer>
+    inline bool verify(thread_pool &, const Colorer &,
+                       const render_options &, std::false_type)
+    {
+        std::printf("%s has non-real coefficients, no complex-slice or table "
+                    "kernel to check.\n", Poly::name());
+        return true;
+    }
+
+    /*  Checks Mariani-Silver subdivision against iterating every pixel, in   *
+     *  color mode and, for real coefficients, in fast mode, and prints the   *
+     *  share of the pixels that were still iterated. Neither mode is exact,  *
+     *  filaments thinner than a pixel can cross a border unseen, so a few    *
+     *  wrong pixels are allowed.                                             */
+    template <class Poly, class Colorer>
+    inline bool verify_subdivision(thread_pool &pool, const Colorer &colorer,
+                                   const render_options &opts)
+    {
+        typedef kernel<Poly, Colorer> kernel_type;
+        const view v = opts.window;
+        const double n_pixels = static_cast<double>(opts.n_frames) *
+                                static_cast<double>(v.xsize) *
+                                static_cast<double>(v.ysize);
+        const kernel_type direct(colorer, opts.eps_sq, opts.max_iters);
+        kernel_type subdivided(colorer, opts.eps_sq, opts.max_iters);
+        unsigned int n;
+        bool success = true;
+
+        for (n = 0U; n < 2U; ++n)
+        {
+            const bool fast = (n == 1U);
+            std::atomic<unsigned long int> iterated(0UL);
+
+            if (fast && !Poly::real_coefficients)
+                break;
+
+            subdivided.subdivide = (fast ? subdivide_fast : subdivide_color);
+
+            success = compare_kernels(
+                pool, opts, fast ? "Fast subdivision vs. direct" :
+                                   "Color subdivision vs. direct",
+                [&direct](const tile &t, const view &w, framebuffer &fb) {
+                    direct(t, w, fb);
+                },
+                [&](const tile &t, const view &w, framebuffer &fb) {
+                    iterated += subdivided.tile_subdivide(t, w, fb, fast);
+                },
+                1.0E-3
+            ) && success;
+
+            std::printf("    %.2f%% of the pixels iterated.\n",
+                        100.0 * static_cast<double>(iterated) / n_pixels);
+        }
+
+        return success;
+    }
+
+    /*  Checks that the kernels compiled for each instruction set the         *
+     *  processor supports give the same frames as the baseline build.        */
+    template <class Poly, class Colorer>
+    inline bool verify_isa(thread_pool &pool, const Colorer &colorer,
+                           const render_options &opts)
+    {
+        typedef kernel<Poly, Colorer> kernel_type;
+        const isa_level levels[2] = {isa_avx2, isa_avx512};
+        kernel_type baseline(colorer, opts.eps_sq, opts.max_iters);
+        unsigned int n;
+        bool success = true;
+
+        baseline.isa = isa_baseline;
+
+        for (n = 0U; n < 2U; ++n)
+        {
+            kernel_type other(colorer, opts.eps_sq, opts.max_iters);
+            char title[64];
+
+            if (!isa_supported(levels[n]))
+            {
+                std::printf("%s not supported by this processor, skipped.\n",
+                            isa_name(levels[n]));
+                continue;
+            }
+
+            other.isa = levels[n];
+            std::sprintf(title, "%s vs. baseline", isa_name(levels[n]));
+            success = compare_kernels(pool, opts, title,
+                                      baseline, other, 0.0) && success;
+        }
+
+        return success;
+    }
+
+    /*  Checks that stopping cycling and escaping orbits early gives the same *
+     *  frames as running them to max_iters, and prints how much it saved.   */
+    template <class Poly, class Colorer>
+    inline bool verify_early_stop(thread_pool &pool, const Colorer &colorer,
+                                  const render_options &opts)
+    {
+        typedef kernel<Poly, Colorer> kernel_type;
+        const view v = opts.window;
+        const double n_steps = static_cast<double>(opts.n_frames) *
+                               static_cast<double>(v.xsize) *
+                               static_cast<double>(v.ysize) * opts.max_iters;
+        kernel_type early(colorer, opts.eps_sq, opts.max_iters);
+        kernel_type full(colorer, opts.eps_sq, opts.max_iters);
+        orbit_stats stats;
+        bool success;
+
+        early.stats = &stats;
+        full.stop_early = false;
+
+        success = compare_kernels(pool, opts, "Early stop vs. max_iters",
+                                  full, early, 0.0);
+
+        std::printf("Stopped %lu cycling and %lu escaping orbits early, "
+                    "saving %lu Newton steps (%.2f%% of the worst case).\n",
+                    stats.cycling.load(), stats.escaping.load(),
+                    stats.steps_saved.load(),
+                    100.0 * static_cast<double>(stats.steps_saved) / n_steps);
+
+        return success;
+    }
+
+    /*  Compares single and mixed precision against iterating in double and   *
+     *  prints the share of the pixels mixed precision ran again in double.   */
+    template <class Poly, class Colorer>
+    inline bool verify_precision(thread_pool &pool, const Colorer &colorer,
+                                 const render_options &opts)
+    {
+        typedef kernel<Poly, Colorer> kernel_type;
+        typedef std::integral_constant<bool, Poly::real_coefficients> real;
+        const view v = opts.window;
+        const double n_pixels = static_cast<double>(opts.n_frames) *
+                                static_cast<double>(v.xsize) *
+                                static_cast<double>(v.ysize);
+        const kernel_type direct(colorer, opts.eps_sq, opts.max_iters);
+        unsigned int n;
+        bool success = true;
+
+        for (n = 0U; n < 2U; ++n)
+        {
+            const bool mixed = (n == 1U);
+            std::atomic<unsigned long int> rerun(0UL);
+
+            success = compare_kernels(
+                pool, opts, mixed ? "Mixed precision vs. double" :
+                                    "Single precision vs. double",
+                direct,
+                [&](const tile &t, const view &w, framebuffer &fb) {
+                    rerun += direct.tile_single(t, w, fb, mixed, real());
+                },
+                1.0E-3
+            ) && success;
+
+            if (mixed)
+                std::printf("    %.2f%% of the pixels run again in double.\n",
+                            100.0 * static_cast<double>(rerun) / n_pixels);
+        }
+
+        return success;
+    }
+
+    /*  Compares two colorers on the same orbits, e.g. the fast one against   *
+     *  the one with std::atan2. Only the coloring differs, so every pixel    *
+     *  that changes is an angle rounded across a step of the gradient.       */
+    template <class Poly, class ColorerA, class ColorerB>
+    inline bool verify_colorers(thread_pool &pool, const ColorerA &colorer_a,
+                                const ColorerB &colorer_b,
+                                const render_options &opts, const char *title)
+    {
+        const kernel<Poly, ColorerA> a(colorer_a, opts.eps_sq, opts.max_iters);
+        const kernel<Poly, ColorerB> b(colorer_b, opts.eps_sq, opts.max_iters);
+        return compare_kernels(pool, opts, title, a, b, 1.0E-4);
+    }
+
+    /*  Output back end that renders every frame it is given again, directly, *
+     *  and counts the pixels that differ.                                    */
+    template <class Poly, class Colorer>
+    struct direct_frames {
+        thread_pool &pool;
+        kernel<Poly, Colorer> k;
+        unsigned int n_frames;
+        view v;
+        std::vector<tile> tiles;
+        framebuffer fb;
+        unsigned long int total;
+        int max_diff;
+
+        direct_frames(thread_pool &p, const Colorer &colorer,
+                      const render_options &opts)
+            : pool(p), k(colorer, opts.eps_sq, opts.max_iters),
+              n_frames(opts.n_frames), v(opts.window),
+              tiles(make_tiles(v.xsize, v.ysize, opts.tile_size,
+                               opts.tile_size)),
+              fb(v.xsize, v.ysize), total(0UL), max_diff(0)
+        {
+            return;
+        }
+
+        inline bool begin(void)
+        {
+            return true;
+        }
+
+        inline bool write_frame(unsigned int frame, const framebuffer &in)
+        {
+            int frame_diff;
+
+            v.rotate_frame(frame, n_frames);
+
+            pool.parallel_for(
+                static_cast<unsigned int>(tiles.size()),
+                [&](unsigned int n) {
+                    k(tiles[n], v, fb);
+                }
+            );
+
+            total += count_differences(in, fb, &frame_diff);
+            max_diff = (frame_diff > max_diff ? frame_diff : max_diff);
+            return true;
+        }
+
+        inline bool finish(void)
+        {
+            return true;
+        }
+
+        inline void abort(void)
+        {
+            return;
+        }
+    };
+
+    /*  Checks that the frames render derives by symmetry match rendering     *
+     *  them directly. They should agree bit for bit.                         */
+    template <class Poly, class Colorer>
+    inline bool verify_symmetry(thread_pool &pool, const Colorer &colorer,
+                                const render_options &opts)
+    {
+        render_options symmetric = opts;
+        bool success;
+
+        symmetric.use_table = false;
+        symmetric.use_symmetry = true;
+        symmetric.subdivide = subdivide_none;
+        symmetric.precision = precision_double;
+        symmetric.progress = false;
+
+        const frame_symmetry symmetry(
+            opts.n_frames, opts.window.point_symmetric(), Poly::commutes_with_j
+        );
+        direct_frames<Poly, Colorer> direct(pool, colorer, symmetric);
+
+        success = render<Poly>(pool, colorer, direct, symmetric) &&
+                  (direct.total == 0UL);
+
+        std::printf("Symmetric frames vs. direct: %u of %u frames iterated, "
+                    "%lu pixels differ, max channel difference %d. %s\n",
+                    symmetry.n_rendered(), opts.n_frames, direct.total,
+                    direct.max_diff, success ? "PASSED" : "FAILED");
+        return success;
+    }
+
+    /*  Runs the checks above that apply to Poly.                             */
+    template <class Poly, class Colorer>
+    inline bool verify(thread_pool &pool, const Colorer &colorer,
+                       const render_options &opts)
+    {
+        typedef std::integral_constant<bool, Poly::real_coefficients> real;
+        bool success = verify<Poly>(pool, colorer, opts, real());
+        success = verify_subdivision<Poly>(pool, colorer, opts) && success;
+        success = verify_isa<Poly>(pool, colorer, opts) && success;
+        success = verify_precision<Poly>(pool, colorer, opts) && success;
+        success = verify_early_stop<Poly>(pool, colorer, opts) && success;
+        return verify_symmetry<Poly>(pool, colorer, opts) && success;
+    }
+}
+/*  End of namespace "qnf".                                                   */
 
 #endif
 /*  End of include guard.                                                     */
@@ -0,0 +1,405 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a lookup table of Newton basins for real polynomials, keyed  *
+ *      on the real part and the norm of the imaginary part of a quaternion.  *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_BASIN_TABLE_HPP
+#define QNF_BASIN_TABLE_HPP
+
+/*  Complex numbers and the polynomials.                                      */
+#include "qnf_complex.hpp"
+#include "qnf_polynomial.hpp"
+
+/*  The table is built in parallel.                                           */
+#include "qnf_thread_pool.hpp"
+
+/*  sqrt and floor are found here.                                            */
+#include <cmath>
+
+/*  Random sample points for the error estimate.                              */
+#include <random>
+#include <vector>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Index of the root of the real polynomial Poly closest to z.           */
+    template <class Poly>
+    inline unsigned int nearest_root(const complex &z)
+    {
+        unsigned int k, best = 0U;
+        double best_dist = (z - Poly::root(0U)).norm_sq();
+
+        for (k = 1U; k < Poly::n_roots; ++k)
+        {
+            const double d = (z - Poly::root(k)).norm_sq();
+
+            if (d < best_dist)
+            {
+                best_dist = d;
+                best = k;
+            }
+        }
+
+        return best;
+    }
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      classify                                                          *
+     *  Purpose:                                                              *
+     *      Runs Newton's method for a real polynomial from the complex       *
+     *      starting point z and reports which root, if any, it reached.      *
+     *  Arguments:                                                            *
+     *      z (qnf::complex):                                                 *
+     *          The starting point.                                           *
+     *      eps_sq (double):                                                  *
+     *          Convergence threshold for |p(z)|^2.                           *
+     *      max_iters (unsigned int):                                         *
+     *          Maximum number of Newton steps.                               *
+     *      iters (unsigned int *):                                           *
+     *          Set to the number of Newton steps that were taken.            *
+     *  Outputs:                                                              *
+     *      basin (unsigned int):                                             *
+     *          0 if the orbit did not converge, 1 + k if it converged to     *
+     *          Poly::root(k).                                                *
+     **************************************************************************/
+    template <class Poly>
+    inline unsigned int
+    classify(complex z, double eps_sq, unsigned int max_iters,
+             unsigned int *iters)
+    {
+        typename Poly::template powers<complex> w;
+        complex p = Poly::eval(z, &w);
+        unsigned int n;
+
+        for (n = 0U; n < max_iters; ++n)
+        {
+            if (p.norm_sq() < eps_sq)
+                break;
+
+            z = Poly::step(z, w);
+            p = Poly::eval(z, &w);
+        }
+
+        *iters = n;
+
+        if (!(p.norm_sq() < eps_sq))
+            return 0U;
+
+        return nearest_root<Poly>(z) + 1U;
+    }
+
+    /*  Result of comparing a basin table with direct iteration.              */
+    struct basin_table_error {
+        unsigned long int samples;
+        unsigned long int mismatches;
+
+        /*  Observed mismatch rate and a 95% upper confidence bound for it.   */
+        double rate;
+        double bound;
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      basin_table                                                       *
+     *  Purpose:                                                              *
+     *      For a real polynomial the orbit of q = a + rn, with n a unit      *
+     *      imaginary quaternion, is the complex orbit of a + ri lifted along *
+     *      n. Which basin q lands in depends only on (a, r), so every frame  *
+     *      of the rotation samples one and the same 2D function. This table  *
+     *      samples that function once on a grid of square cells.            *
+     *                                                                        *
+     *      Newton is run at the four corners and the center of every cell.   *
+     *      If all five land in the same basin the cell is marked with that   *
+     *      basin, otherwise it is marked "mixed". A lookup in a uniform cell *
+     *      is one load. Points in mixed cells (the basin boundaries) or off  *
+     *      the table return -1 and must be iterated directly.                *
+     *  Notes:                                                                *
+     *      Pixels in uniform cells can only be wrong if a piece of another   *
+     *      basin fits inside the cell without touching any of its five       *
+     *      samples. The rate at which that happens is measured by            *
+     *      estimate_error. Shrinking the step shrinks the error.             *
+     **************************************************************************/
+    template <class Poly>
+    struct basin_table {
+
+        /*  Cell marker for cells that straddle a basin boundary.             */
+        static const unsigned char mixed = 0xFFU;
+
+        /*  The table covers [a_min, a_min + n_a*step] x [0, n_r*step].       */
+        double a_min, step, inv_step;
+        unsigned int n_a, n_r;
+
+        /*  Convergence parameters the table was built with.                  */
+        double eps_sq;
+        unsigned int max_iters;
+
+        /*  Basin of each cell, or "mixed". Row r holds cells [r*n_a, ...).   */
+        std::vector<unsigned char> cells;
+
+        /*  Newton steps taken at each grid node (capped at 255).             */
+        std::vector<unsigned char> iters;
+
+        basin_table(void) : a_min(0.0), step(1.0), inv_step(1.0),
+                            n_a(0U), n_r(0U), eps_sq(0.0), max_iters(0U)
+        {
+            return;
+        }
+
+        /*  Samples the basins on [a_lo, a_hi] x [0, r_hi] with cells of the  *
+         *  given side length.                                                */
+        inline void build(thread_pool &pool, double a_lo, double a_hi,
+                          double r_hi, double cell_size,
+                          double eps_sq_in, unsigned int max_iters_in);
+
+        /*  Basin of (a, r), or -1 if the point needs direct iteration.       */
+        inline int lookup(double a, double r) const;
+
+        /*  Bilinearly interpolated Newton step count at (a, r).              */
+        inline double iterations(double a, double r) const;
+
+        /*  Fraction of cells that are uniform.                               */
+        inline double coverage(void) const;
+
+        /*  Compares lookups against direct iteration at random points.       */
+        inline basin_table_error
+        estimate_error(unsigned long int n_samples, unsigned int seed) const;
+    };
+
+    /**************************************************************************
+     *  Method:                                                               *
+     *      build                                                             *
+     *  Purpose:                                                              *
+     *      Computes the table. Rows of nodes, and then rows of cells, are    *
+     *      spread over the thread pool.                                      *
+     *  Arguments:                                                            *
+     *      pool (qnf::thread_pool &):                                        *
+     *          Threads to build with.                                        *
+     *      a_lo, a_hi (double):                                              *
+     *          Range of real parts to cover.                                 *
+     *      r_hi (double):                                                    *
+     *          Largest norm of the imaginary part to cover.                  *
+     *      cell_size (double):                                               *
+     *          Side length of a cell. About a pixel, see qnf::table_window.  *
+     *      eps_sq_in (double), max_iters_in (unsigned int):                  *
+     *          The convergence test, as used by the renderer.                *
+     *  Outputs:                                                              *
+     *      None (void).                                                      *
+     **************************************************************************/
+    template <class Poly>
+    inline void
+    basin_table<Poly>::build(thread_pool &pool, double a_lo, double a_hi,
+                             double r_hi, double cell_size,
+                             double eps_sq_in, unsigned int max_iters_in)
+    {
+        std::vector<unsigned char> nodes;
+        basin_table<Poly> &self = *this;
+
+        a_min = a_lo;
+        step = cell_size;
+        inv_step = 1.0 / cell_size;
+        n_a = static_cast<unsigned int>(std::ceil((a_hi - a_lo) * inv_step));
+        n_r = static_cast<unsigned int>(std::ceil(r_hi * inv_step));
+        eps_sq = eps_sq_in;
+        max_iters = max_iters_in;
+
+        nodes.resize(static_cast<std::size_t>(n_a + 1U) * (n_r + 1U));
+        iters.resize(nodes.size());
+        cells.resize(static_cast<std::size_t>(n_a) * n_r);
+
+        /*  Basin and step count at every grid node.                          */
+        pool.parallel_for(n_r + 1U, [&self, &nodes](unsigned int j) {
+            const double r = self.step * j;
+            unsigned int i, count;
+
+            for (i = 0U; i <= self.n_a; ++i)
+            {
+                const std::size_t ind = static_cast<std::size_t>(j) *
+                                        (self.n_a + 1U) + i;
+                const complex z(self.a_min + self.step * i, r);
+                nodes[ind] = static_cast<unsigned char>(
+                    classify<Poly>(z, self.eps_sq, self.max_iters, &count)
+                );
+                self.iters[ind] = static_cast<unsigned char>(
+                    count < 255U ? count : 255U
+                );
+            }
+        });
+
+        /*  A cell is uniform if its corners and its center agree.            */
+        pool.parallel_for(n_r, [&self, &nodes](unsigned int j) {
+            const std::size_t stride = self.n_a + 1U;
+            unsigned int i, count;
+
+            for (i = 0U; i < self.n_a; ++i)
+            {
+                const std::size_t ind = static_cast<std::size_t>(j)*stride + i;
+                const unsigned char basin = nodes[ind];
+                const complex center(self.a_min + self.step * (i + 0.5),
+                                     self.step * (j + 0.5));
+                unsigned char out = mixed;
+
+                if (nodes[ind + 1U] == basin &&
+                    nodes[ind + stride] == basin &&
+                    nodes[ind + stride + 1U] == basin &&
+                    classify<Poly>(center, self.eps_sq,
+                                   self.max_iters, &count) == basin)
+                    out = basin;
+
+                self.cells[static_cast<std::size_t>(j) * self.n_a + i] = out;
+            }
+        });
+    }
+
+    template <class Poly>
+    inline int basin_table<Poly>::lookup(double a, double r) const
+    {
+        const double u = (a - a_min) * inv_step;
+        const double v = r * inv_step;
+        unsigned int i, j;
+        unsigned char basin;
+
+        /*  The negated test also sends NaN to direct iteration.              */
+        if (!(u >= 0.0 && v >= 0.0 && u < n_a && v < n_r))
+            return -1;
+
+        i = static_cast<unsigned int>(u);
+        j = static_cast<unsigned int>(v);
+        basin = cells[static_cast<std::size_t>(j) * n_a + i];
+        return (basin == mixed ? -1 : static_cast<int>(basin));
+    }
+
+    template <class Poly>
+    inline double basin_table<Poly>::iterations(double a, double r) const
+    {
+        const std::size_t stride = n_a + 1U;
+        double u = (a - a_min) * inv_step;
+        double v = r * inv_step;
+        unsigned int i, j;
+        std::size_t ind;
+
+        /*  Clamp to the table so the four nodes always exist.                */
+        u = (u < 0.0 ? 0.0 : (u > n_a - 1E-9 ? n_a - 1E-9 : u));
+        v = (v < 0.0 ? 0.0 : (v > n_r - 1E-9 ? n_r - 1E-9 : v));
+        i = static_cast<unsigned int>(u);
+        j = static_cast<unsigned int>(v);
+        u -= i;
+        v -= j;
+        ind = static_cast<std::size_t>(j) * stride + i;
+
+        return (1.0 - v) * ((1.0 - u) * iters[ind] + u * iters[ind + 1U]) +
+               v * ((1.0 - u) * iters[ind + stride] +
+                    u * iters[ind + stride + 1U]);
+    }
+
+    template <class Poly>
+    inline double basin_table<Poly>::coverage(void) const
+    {
+        std::size_t n, uniform = 0UL;
+
+        for (n = 0UL; n < cells.size(); ++n)
+            uniform += (cells[n] == mixed ? 0UL : 1UL);
+
+        return static_cast<double>(uniform) / static_cast<double>(cells.size());
+    }
+
+    /**************************************************************************
+     *  Method:                                                               *
+     *      estimate_error                                                    *
+     *  Purpose:                                                              *
+     *      Picks uniformly random points in the table, and for those in      *
+     *      uniform cells compares the table's basin with direct iteration.   *
+     *  Arguments:                                                            *
+     *      n_samples (unsigned long int):                                    *
+     *          Number of random points.                                      *
+     *      seed (unsigned int):                                              *
+     *          Seed for the random points, so results are reproducible.      *
+     *  Outputs:                                                              *
+     *      err (qnf::basin_table_error):                                     *
+     *          The number of points checked and wrong, the observed rate,    *
+     *          and a 95% upper bound on the true rate of wrong lookups: the  *
+     *          "rule of three" 3/n if nothing was wrong, the Wilson score    *
+     *          bound otherwise.                                              *
+     **************************************************************************/
+    template <class Poly>
+    inline basin_table_error
+    basin_table<Poly>::estimate_error(unsigned long int n_samples,
+                                      unsigned int seed) const
+    {
+        const double z = 1.959963984540054;
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> ua(0.0, n_a * step);
+        std::uniform_real_distribution<double> ur(0.0, n_r * step);
+        basin_table_error err;
+        unsigned long int n;
+        unsigned int count;
+        double p, m;
+
+        err.samples = 0UL;
+        err.mismatches = 0UL;
+
+        for (n = 0UL; n < n_samples; ++n)
+        {
+            const double a = a_min + ua(rng);
+            const double r = ur(rng);
+            const int basin = lookup(a, r);
+
+            if (basin < 0)
+                continue;
+
+            ++err.samples;
+
+            if (classify<Poly>(complex(a, r), eps_sq, max_iters, &count) !=
+                static_cast<unsigned int>(basin))
+                ++err.mismatches;
+        }
+
+        if (err.samples == 0UL)
+        {
+            err.rate = 0.0;
+            err.bound = 1.0;
+            return err;
+        }
+
+        m = static_cast<double>(err.samples);
+        p = static_cast<double>(err.mismatches) / m;
+        err.rate = p;
+
+        if (err.mismatches == 0UL)
+            err.bound = 3.0 / m;
+        else
+            err.bound = (p + z*z/(2.0*m) +
+                         z*std::sqrt(p*(1.0 - p)/m + z*z/(4.0*m*m))) /
+                        (1.0 + z*z/m);
+
+        return err;
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
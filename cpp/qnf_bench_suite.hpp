@@ -0,0 +1,715 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      The benchmark suite of cpp/bench.cpp: each stage of the renderer      *
+ *      timed on its own, whole frames at several sizes and thread counts,    *
+ *      the results as JSON, and the comparison of two such files.            *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_BENCH_SUITE_HPP
+#define QNF_BENCH_SUITE_HPP
+
+/*  printf, remove and snprintf are found here.                               */
+#include <cstdio>
+
+/*  HUGE_VAL.                                                                 */
+#include <cmath>
+
+/*  Timers.                                                                   */
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*  time_loop, load and sample_points, and the renderer's kernels.            */
+#include "qnf_benchmark.hpp"
+
+/*  The results are written and compared as JSON.                             */
+#include "qnf_json.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Another namespace to avoid name conflicts with these helpers.         */
+    namespace benchmark {
+
+        /*  One timed quantity. Every unit is a time, so lower is better,     *
+         *  and "items" is how many items or pixels one run covered.          */
+        struct measurement {
+            std::string name;
+            std::string unit;
+            double value;
+            double items;
+        };
+
+        /*  The measurements of a run, and what they were measured on.        */
+        struct suite {
+            std::vector<measurement> results;
+            const char *poly;
+            isa_level isa;
+            unsigned int max_iters;
+
+            /*  Results the compiler must not see unused.                     */
+            double sink;
+
+            suite(const char *poly_name, isa_level level, unsigned int iters)
+                : poly(poly_name), isa(level), max_iters(iters), sink(0.0)
+            {
+                return;
+            }
+
+            /*  Records a measurement and prints it.                          */
+            inline void add(const std::string &name, const char *unit,
+                            double value, double items)
+            {
+                measurement m;
+                m.name = name;
+                m.unit = unit;
+                m.value = value;
+                m.items = items;
+                results.push_back(m);
+                std::printf("%-30s %12.3f %-9s (%.0f per run)\n",
+                            name.c_str(), value, unit, items);
+            }
+
+            /*  Writes the results as a JSON document to "path".              */
+            inline bool write_json(const char *path) const
+            {
+                FILE *fp = std::fopen(path, "w");
+                std::size_t n;
+
+                if (!fp)
+                {
+                    std::fprintf(stderr, "Could not open %s.\n", path);
+                    return false;
+                }
+
+                json::writer out(fp);
+                out.begin_object(0, true);
+                out.field("poly", poly);
+                out.field("isa", isa_name(isa));
+                out.field("simd_lanes", simd::level_width(isa));
+                out.field("hardware_threads",
+                          std::thread::hardware_concurrency());
+                out.field("max_iters", max_iters);
+                out.field("time", static_cast<unsigned long int>(
+                    std::time(0)
+                ));
+                out.begin_array("results", true);
+
+                for (n = 0U; n < results.size(); ++n)
+                {
+                    out.begin_object();
+                    out.field("name", results[n].name.c_str());
+                    out.field("unit", results[n].unit.c_str());
+                    out.field("value", results[n].value);
+                    out.field("items", results[n].items);
+                    out.end_object();
+                }
+
+                out.end_array();
+                out.end_object();
+                std::fputc('\n', fp);
+                return std::fclose(fp) == 0;
+            }
+        };
+
+        /*  The least wall time of "repeats" calls of f, in seconds.          */
+        template <class Func>
+        inline double best_time(unsigned int repeats, Func f)
+        {
+            typedef std::chrono::steady_clock clock;
+            double best = HUGE_VAL;
+            unsigned int r;
+
+            for (r = 0U; r < repeats; ++r)
+            {
+                const clock::time_point start = clock::now();
+                f();
+
+                const std::chrono::duration<double> elapsed =
+                    clock::now() - start;
+
+                if (elapsed.count() < best)
+                    best = elapsed.count();
+            }
+
+            return best;
+        }
+
+        /*  Times op(p[n], q[n]) over the arrays. The results are stored,     *
+         *  as the kernels store theirs, which keeps the compiler from        *
+         *  dropping the work without adding a dependency between items.      */
+        template <class Op>
+        inline void time_op(suite &s, const char *name,
+                            const std::vector<quaternion> &p,
+                            const std::vector<quaternion> &q, Op op)
+        {
+            const unsigned int rounds = 2048U;
+            const std::size_t n_items = p.size();
+            std::vector<quaternion> out(n_items);
+            double sum = 0.0;
+
+            const double seconds = best_time(5U, [&](void) {
+                unsigned int r;
+                std::size_t n;
+
+                for (r = 0U; r < rounds; ++r)
+                {
+                    for (n = 0U; n < n_items; ++n)
+                        out[n] = op(p[n], q[n]);
+
+                    sum += out[r % n_items].dat[0];
+                }
+            });
+
+            const double items = static_cast<double>(rounds) * n_items;
+            s.sink += sum;
+            s.add(name, "ns/item", 1.0E9 * seconds / items, items);
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      quaternion_ops                                                *
+         *  Purpose:                                                          *
+         *      Times the quaternion products, quotients, squares, cubes and  *
+         *      reciprocals of qnf::quaternion on 1024 points of a frame,     *
+         *      shifted so that none is zero.                                 *
+         **********************************************************************/
+        inline void quaternion_ops(suite &s)
+        {
+            const std::vector<quaternion> points = sample_points(0.3, 32U);
+            const quaternion shift_p(0.125, 0.25, -0.375, 0.5);
+            const quaternion shift_q(-0.25, 0.125, 0.5, -0.375);
+            std::vector<quaternion> p(points.size()), q(points.size());
+            std::size_t n;
+
+            for (n = 0U; n < points.size(); ++n)
+            {
+                p[n] = points[n] + shift_p;
+                q[n] = points[points.size() - 1U - n] + shift_q;
+            }
+
+            time_op(s, "quaternion.multiply", p, q,
+                    [](const quaternion &a, const quaternion &b) {
+                        return a * b;
+                    });
+
+            time_op(s, "quaternion.divide", p, q,
+                    [](const quaternion &a, const quaternion &b) {
+                        return a / b;
+                    });
+
+            time_op(s, "quaternion.square", p, q,
+                    [](const quaternion &a, const quaternion &) {
+                        return a.square();
+                    });
+
+            time_op(s, "quaternion.cube", p, q,
+                    [](const quaternion &a, const quaternion &) {
+                        return a.cube();
+                    });
+
+            time_op(s, "quaternion.reciprocal", p, q,
+                    [](const quaternion &a, const quaternion &) {
+                        return a.reciprocal();
+                    });
+        }
+
+        /*  The orbit of the kernel's loop from a point, or from the points   *
+         *  of a batch in the back end of k.isa. Adds the steps taken to      *
+         *  *steps.                                                           */
+        template <class Kernel, class Number>
+        inline Number
+        kernel_orbit(const Kernel &k, const Number &q, unsigned long int *steps)
+        {
+            unsigned int n;
+            double p_norm_sq;
+            const Number out = k.iterate(q, &p_norm_sq, &n);
+            *steps += n;
+            return out;
+        }
+
+        template <class Kernel, template <class> class Batch>
+        inline lanes_of<Batch>
+        kernel_orbit(const Kernel &k, lanes_of<Batch> q,
+                     unsigned long int *steps)
+        {
+            double *c[lanes_of<Batch>::dims], res[simd::max_width];
+            unsigned int n[simd::max_width], m;
+
+            for (m = 0U; m < lanes_of<Batch>::dims; ++m)
+                c[m] = q.dat[m];
+
+            k.template iterate_lanes<Batch>(c, res, simd::max_width,
+                                            k.eps_sq, k.max_iters, n);
+
+            for (m = 0U; m < simd::max_width; ++m)
+                *steps += n[m];
+
+            return q;
+        }
+
+        /*  kernel_orbit for number type T, called as loop(q, &steps) like    *
+         *  the loops of newton_step. As in the renderer the batches run in   *
+         *  the back end of k.isa and single points at the baseline.          */
+        template <class Kernel, class T>
+        struct kernel_loop {
+            const Kernel *k;
+
+            kernel_loop(const Kernel &kern) : k(&kern)
+            {
+                return;
+            }
+
+            inline T operator () (const T &q, unsigned long int *steps) const
+            {
+                return kernel_orbit(*k, q, steps);
+            }
+        };
+
+        /*  Times the kernel's loop for number type T over the points and     *
+         *  records the time and the number of steps per pixel.               */
+        template <class T, class Kernel>
+        inline void time_kernel(suite &s, const char *name, const Kernel &k,
+                                const std::vector<quaternion> &points)
+        {
+            const unsigned int n_lanes = lanes(static_cast<const T *>(0));
+            const timing t = time_loop<T>(points, n_lanes,
+                                          kernel_loop<Kernel, T>(k), 3U);
+            const double pixels = static_cast<double>(points.size());
+
+            /*  Orbits from 0 end as NaN.                                     */
+            if (std::isfinite(t.checksum))
+                s.sink += t.checksum;
+
+            s.add(name, "ns/pixel", 1.0E9 * t.seconds / pixels, pixels);
+            std::printf("%30s %12.3f steps/pixel\n", "",
+                        static_cast<double>(t.steps) / pixels);
+        }
+
+        /*  The kernel's loops on complex numbers, for real coefficients.     */
+        template <class Kernel>
+        inline void newton_complex(suite &s, const Kernel &k,
+                                   const std::vector<quaternion> &points,
+                                   std::true_type)
+        {
+            time_kernel<complex>(s, "newton.complex", k, points);
+            time_kernel<complex_lanes>(s, "newton.complex_batch", k, points);
+        }
+
+        template <class Kernel>
+        inline void newton_complex(suite &, const Kernel &,
+                                   const std::vector<quaternion> &,
+                                   std::false_type)
+        {
+            return;
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      newton_loop                                                   *
+         *  Purpose:                                                          *
+         *      Times the per-pixel Newton loop of the renderer's kernel,     *
+         *      root balls and early stops included, from every 4th pixel of  *
+         *      a frame in each direction: on quaternions one and a batch at  *
+         *      a time, and for real coefficients on the complex slices. The  *
+         *      batches run in the back end of opts.isa.                      *
+         **********************************************************************/
+        template <class Poly>
+        inline void newton_loop(suite &s, const render_options &opts)
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+            typedef std::integral_constant<
+                bool, Poly::real_coefficients && Poly::is_newton
+            > has_balls;
+            typedef kernel<Poly, colorers::sphere> kernel_type;
+
+            const std::vector<quaternion> points = sample_points(0.3, 4U);
+            kernel_type k(colorers::sphere(std::sqrt(opts.eps_sq)),
+                          opts.eps_sq, opts.max_iters);
+            root_balls<Poly> balls;
+
+            k.balls = maybe_build_balls(balls, opts, has_balls());
+            k.isa = opts.isa;
+
+            time_kernel<quaternion>(s, "newton.quaternion", k, points);
+            time_kernel<quaternion_lanes>(s, "newton.quaternion_batch", k,
+                                          points);
+            newton_complex(s, k, points, real());
+        }
+
+        /*  Times colorer c on the final points and residuals, writing each   *
+         *  color to the frame buffer as the kernels do.                      */
+        template <class Colorer>
+        inline void time_colorer(suite &s, const char *name, const Colorer &c,
+                                 const std::vector<quaternion> &q,
+                                 const std::vector<double> &p_norm_sq,
+                                 framebuffer &fb)
+        {
+            const double seconds = best_time(5U, [&](void) {
+                std::size_t n;
+
+                for (n = 0U; n < q.size(); ++n)
+                    c(q[n], p_norm_sq[n]).write(fb, n % fb.xsize,
+                                                n / fb.xsize);
+            });
+
+            const double pixels = static_cast<double>(q.size());
+            s.sink += fb.data[fb.size() / 2U];
+            s.add(name, "ns/pixel", 1.0E9 * seconds / pixels, pixels);
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      coloring                                                      *
+         *  Purpose:                                                          *
+         *      Times color_wheel and sphere_color on their own, and both     *
+         *      colorers on the ends of the orbits of a 256 by 256 frame,     *
+         *      so the share of black and gray pixels is that of a render.    *
+         *  Output:                                                           *
+         *      fb (framebuffer):                                             *
+         *          The colored frame, for the output benchmark.              *
+         **********************************************************************/
+        template <class Poly>
+        inline framebuffer coloring(suite &s, const render_options &opts)
+        {
+            const double eps = std::sqrt(opts.eps_sq);
+            const std::vector<quaternion> points = sample_points(0.3, 4U);
+            kernel<Poly, colorers::sphere> k(colorers::sphere(eps),
+                                             opts.eps_sq, opts.max_iters);
+            std::vector<quaternion> q(points.size());
+            std::vector<double> p_norm_sq(points.size());
+            std::vector<double> phi(points.size()), theta(points.size());
+            std::vector<color> out(points.size());
+            const unsigned int side = static_cast<unsigned int>(
+                std::sqrt(static_cast<double>(points.size()))
+            );
+            framebuffer fb(side, side);
+            const double items = static_cast<double>(points.size());
+            double seconds;
+            std::size_t n;
+
+            for (n = 0U; n < points.size(); ++n)
+            {
+                q[n] = k.iterate(points[n], &p_norm_sq[n]);
+                phi[n] = HALF_PI * (2.0 * n / items - 1.0);
+                theta[n] = ONE_PI * (2.0 * (n * 7919U % points.size()) /
+                                     items - 1.0);
+            }
+
+            seconds = best_time(5U, [&](void) {
+                std::size_t m;
+
+                for (m = 0U; m < theta.size(); ++m)
+                    out[m] = color_wheel(theta[m]);
+            });
+
+            s.sink += out[out.size() / 2U].red;
+            s.add("color.color_wheel", "ns/item", 1.0E9 * seconds / items,
+                  items);
+
+            seconds = best_time(5U, [&](void) {
+                std::size_t m;
+
+                for (m = 0U; m < theta.size(); ++m)
+                    out[m] = sphere_color(phi[m], theta[m]);
+            });
+
+            s.sink += out[out.size() / 2U].red;
+            s.add("color.sphere_color", "ns/item", 1.0E9 * seconds / items,
+                  items);
+
+            time_colorer(s, "color.sphere_fast", colorers::sphere_fast(eps),
+                         q, p_norm_sq, fb);
+            time_colorer(s, "color.sphere", colorers::sphere(eps),
+                         q, p_norm_sq, fb);
+            return fb;
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      ppm_output                                                    *
+         *  Purpose:                                                          *
+         *      Times writing a full-size frame with qnf::ppm, header and     *
+         *      close included, to the file "path", which is removed after.   *
+         *      The frame repeats the small one colored by "coloring".        *
+         **********************************************************************/
+        inline void ppm_output(suite &s, const framebuffer &small,
+                               const char *path)
+        {
+            framebuffer fb;
+            unsigned int x, y;
+            double seconds, pixels;
+
+            for (y = 0U; y < fb.ysize; ++y)
+                for (x = 0U; x < fb.xsize; ++x)
+                    std::memcpy(fb.pixel(x, y),
+                                small.pixel(x % small.xsize, y % small.ysize),
+                                3U);
+
+            seconds = best_time(3U, [&](void) {
+                ppm out(path);
+                out.init(fb.xsize, fb.ysize, 6);
+                out.write(fb);
+                out.close();
+            });
+
+            std::remove(path);
+            pixels = static_cast<double>(fb.xsize) * fb.ysize;
+            s.add("ppm.write", "ns/pixel", 1.0E9 * seconds / pixels, pixels);
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      frames                                                        *
+         *  Purpose:                                                          *
+         *      Renders n_bench frames spread over the rotation, at each size *
+         *      in "sizes" (square, the default window) and with each number  *
+         *      of threads in "threads", and records the time per frame.      *
+         *  Notes:                                                            *
+         *      Uses the kernel and the options of render, without symmetry,  *
+         *      the table or output. One frame is rendered first and not      *
+         *      timed, so the threads and the caches are warm.                *
+         **********************************************************************/
+        template <class Poly>
+        inline void frames(suite &s, const render_options &opts,
+                           const std::vector<unsigned int> &sizes,
+                           const std::vector<unsigned int> &threads,
+                           unsigned int n_bench)
+        {
+            typedef std::integral_constant<
+                bool, Poly::real_coefficients && Poly::is_newton
+            > has_balls;
+            kernel<Poly, colorers::sphere>
+                k(colorers::sphere(std::sqrt(opts.eps_sq)), opts.eps_sq,
+                  opts.max_iters);
+            root_balls<Poly> balls;
+            std::size_t m, n;
+            unsigned int frame;
+
+            k.balls = maybe_build_balls(balls, opts, has_balls());
+            k.subdivide = opts.subdivide;
+            k.isa = opts.isa;
+            k.precision = opts.precision;
+
+            for (m = 0U; m < sizes.size(); ++m)
+            {
+                view v;
+                std::vector<tile> tiles;
+                v.set_window(setup::start, setup::end,
+                             setup::start, setup::end, sizes[m], sizes[m]);
+                tiles = make_tiles(v.xsize, v.ysize,
+                                   opts.tile_size, opts.tile_size);
+                framebuffer fb(v.xsize, v.ysize);
+                const double pixels = static_cast<double>(v.xsize) * v.ysize;
+
+                for (n = 0U; n < threads.size(); ++n)
+                {
+                    thread_pool pool(threads[n]);
+                    const auto render = [&](void) {
+                        pool.parallel_for(
+                            static_cast<unsigned int>(tiles.size()),
+                            [&](unsigned int t) {
+                                k(tiles[t], v, fb);
+                            }
+                        );
+                    };
+                    char name[64];
+                    double seconds;
+
+                    v.rotate_frame(1U, opts.n_frames);
+                    render();
+
+                    seconds = best_time(1U, [&](void) {
+                        for (frame = 0U; frame < n_bench; ++frame)
+                        {
+                            v.rotate_frame(frame * opts.n_frames / n_bench,
+                                           opts.n_frames);
+                            render();
+                        }
+                    }) / n_bench;
+
+                    std::snprintf(name, sizeof(name), "frame.%ux%u.threads%u",
+                                  v.xsize, v.ysize, pool.size());
+                    s.add(name, "ms/frame", 1.0E3 * seconds, pixels);
+                    std::printf("%30s %12.3f ns/pixel  %.1f Mpixel/s\n", "",
+                                1.0E9 * seconds / pixels,
+                                1.0E-6 * pixels / seconds);
+                }
+            }
+        }
+
+        /*  The measurement named "name" in a parsed results file, or null.   */
+        inline const json::value *
+        find_result(const json::value &doc, const std::string &name)
+        {
+            const json::value *results = doc.find("results");
+            std::size_t n;
+
+            if (!results)
+                return 0;
+
+            for (n = 0U; n < results->items.size(); ++n)
+            {
+                const json::value *r = results->items[n].find("name");
+
+                if (r && r->text == name)
+                    return &results->items[n];
+            }
+
+            return 0;
+        }
+
+        /*  A field of the header of a results file, as text.                 */
+        inline std::string header_field(const json::value &doc, const char *key)
+        {
+            const json::value *v = doc.find(key);
+            char buffer[32];
+
+            if (!v)
+                return "?";
+
+            if (v->kind == json::value::string_kind)
+                return v->text;
+
+            std::snprintf(buffer, sizeof(buffer), "%g", v->number);
+            return buffer;
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      compare_files                                                 *
+         *  Purpose:                                                          *
+         *      Compares two files written by suite::write_json measurement   *
+         *      by measurement, and flags every one that got slower by more   *
+         *      than "threshold" percent.                                     *
+         *  Arguments:                                                        *
+         *      old_path (const char *):                                      *
+         *          The baseline run.                                         *
+         *      new_path (const char *):                                      *
+         *          The run to check.                                         *
+         *      threshold (double):                                           *
+         *          The slowdown, in percent, that counts as a regression.    *
+         *  Output:                                                           *
+         *      ok (bool):                                                    *
+         *          False if a measurement regressed or a file is unreadable. *
+         *  Notes:                                                            *
+         *      Measurements only in one of the files are listed, but not     *
+         *      counted. A warning is printed if the runs differ in the       *
+         *      polynomial, the instruction set or the machine's threads.     *
+         **********************************************************************/
+        inline bool compare_files(const char *old_path, const char *new_path,
+                                  double threshold)
+        {
+            static const char * const keys[] = {
+                "poly", "isa", "simd_lanes", "hardware_threads", "max_iters"
+            };
+            json::value before, after;
+            const json::value *results;
+            unsigned int regressions = 0U, n_keys;
+            std::size_t n;
+
+            if (!json::read_file(old_path, &before) ||
+                !json::read_file(new_path, &after))
+                return false;
+
+            results = after.find("results");
+
+            if (!results || results->kind != json::value::array_kind)
+            {
+                std::fprintf(stderr, "%s has no results.\n", new_path);
+                return false;
+            }
+
+            for (n_keys = 0U; n_keys < sizeof(keys) / sizeof(keys[0]); ++n_keys)
+            {
+                const std::string a = header_field(before, keys[n_keys]);
+                const std::string b = header_field(after, keys[n_keys]);
+
+                if (a != b)
+                    std::printf("Warning: %s differs, %s vs. %s.\n",
+                                keys[n_keys], a.c_str(), b.c_str());
+            }
+
+            std::printf("%-30s %12s %12s %9s\n", "", "old", "new", "change");
+
+            for (n = 0U; n < results->items.size(); ++n)
+            {
+                const json::value &r = results->items[n];
+                const json::value *name = r.find("name");
+                const json::value *unit = r.find("unit");
+                const json::value *value = r.find("value");
+                const json::value *old_r, *old_value;
+                double change;
+
+                if (!name || !value)
+                    continue;
+
+                old_r = find_result(before, name->text);
+                old_value = (old_r ? old_r->find("value") : 0);
+
+                if (!old_value || !(old_value->number > 0.0))
+                {
+                    std::printf("%-30s %12s %12.3f %9s  new\n",
+                                name->text.c_str(), "-", value->number, "");
+                    continue;
+                }
+
+                change = 100.0 * (value->number / old_value->number - 1.0);
+
+                std::printf("%-30s %12.3f %12.3f %+8.1f%%  %s%s\n",
+                            name->text.c_str(), old_value->number,
+                            value->number, change,
+                            unit ? unit->text.c_str() : "",
+                            change > threshold ? "  REGRESSION" :
+                            (change < -threshold ? "  faster" : ""));
+
+                if (change > threshold)
+                    ++regressions;
+            }
+
+            results = before.find("results");
+
+            for (n = 0U; results && n < results->items.size(); ++n)
+            {
+                const json::value *name = results->items[n].find("name");
+
+                if (name && !find_result(after, name->text))
+                    std::printf("%-30s only in %s\n", name->text.c_str(),
+                                old_path);
+            }
+
+            std::printf("%u regression%s over %.1f%%.\n", regressions,
+                        regressions == 1U ? "" : "s", threshold);
+            return regressions == 0U;
+        }
+    }
+    /*  End of namespace "benchmark".                                         */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,703 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Micro-benchmarks for the Newton iteration, and whole frames rendered  *
+ *      with each of the root-finding methods.                                *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_BENCHMARK_HPP
+#define QNF_BENCHMARK_HPP
+
+/*  printf is found here.                                                     */
+#include <cstdio>
+
+/*  memcmp, for comparing the checksums bit for bit.                          */
+#include <cstring>
+
+/*  Timers.                                                                   */
+#include <chrono>
+
+/*  std::integral_constant, used to skip the complex types when the           *
+ *  polynomial does not have real coefficients.                               */
+#include <type_traits>
+#include <vector>
+
+/*  Number types, single and batched, and the polynomials.                    */
+#include "qnf_quaternion.hpp"
+#include "qnf_quaternion_batch.hpp"
+#include "qnf_complex.hpp"
+#include "qnf_polynomial.hpp"
+#include "qnf_view.hpp"
+
+/*  The instruction set levels the loops can run with.                        */
+#include "qnf_cpu.hpp"
+
+/*  The renderer's kernels, and the methods they are timed with.              */
+#include "qnf.hpp"
+#include "qnf_method.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Another namespace to avoid name conflicts with these helpers.         */
+    namespace benchmark {
+
+        /*  Newton's method as it was written before eval and step existed:   *
+         *  newton(q) followed by func on the new point, so the powers of     *
+         *  each point are computed twice.                                    */
+        template <class Poly, class Number>
+        inline Number
+        unfused(Number q, double eps_sq, unsigned int max_iters,
+                unsigned long int *steps)
+        {
+            Number p = Poly::func(q);
+            unsigned int iters;
+
+            for (iters = 0U; iters < max_iters; ++iters)
+            {
+                if (p.norm_sq() < eps_sq)
+                    break;
+
+                q = Poly::newton(q);
+                p = Poly::func(q);
+            }
+
+            *steps += iters;
+            return q;
+        }
+
+        /*  The same iteration with eval and step, as in qnf::kernel.         */
+        template <class Poly, class Number>
+        inline Number
+        fused(Number q, double eps_sq, unsigned int max_iters,
+              unsigned long int *steps)
+        {
+            typename Poly::template powers<Number> w;
+            Number p = Poly::eval(q, &w);
+            unsigned int iters;
+
+            for (iters = 0U; iters < max_iters; ++iters)
+            {
+                if (p.norm_sq() < eps_sq)
+                    break;
+
+                q = Poly::step(q, w);
+                p = Poly::eval(q, &w);
+            }
+
+            *steps += iters;
+            return q;
+        }
+
+        /*  Batched versions, replacing *q_io with the final points. A batch  *
+         *  costs one step per lane per iteration, converged lanes included,  *
+         *  and that is what is counted.                                      */
+        template <class Poly, class Batch>
+        inline void
+        unfused_batch(Batch *q_io, double eps_sq, unsigned int max_iters,
+                      unsigned long int *steps)
+        {
+            const typename Batch::vec_type tol(eps_sq);
+            Batch q = *q_io;
+            Batch p = Poly::func(q);
+            typename Batch::mask_type done = simd::less(p.norm_sq(), tol);
+            unsigned int iters;
+
+            for (iters = 0U; iters < max_iters; ++iters)
+            {
+                if (simd::all(done))
+                    break;
+
+                q = Batch::select(done, q, Poly::newton(q));
+                p = Batch::select(done, p, Poly::func(q));
+                done = done | simd::less(p.norm_sq(), tol);
+            }
+
+            *steps += iters * Batch::width;
+            *q_io = q;
+        }
+
+        template <class Poly, class Batch>
+        inline void
+        fused_batch(Batch *q_io, double eps_sq, unsigned int max_iters,
+                    unsigned long int *steps)
+        {
+            const typename Batch::vec_type tol(eps_sq);
+            typename Poly::template powers<Batch> w;
+            Batch q = *q_io;
+            Batch p = Poly::eval(q, &w);
+            typename Batch::mask_type done = simd::less(p.norm_sq(), tol);
+            unsigned int iters;
+
+            for (iters = 0U; iters < max_iters; ++iters)
+            {
+                if (simd::all(done))
+                    break;
+
+                q = Batch::select(done, q, Poly::step(q, w));
+                p = Batch::select(done, p, Poly::eval(q, &w));
+                done = done | simd::less(p.norm_sq(), tol);
+            }
+
+            *steps += iters * Batch::width;
+            *q_io = q;
+        }
+
+        /*  simd::max_width points stored component by component, the number  *
+         *  type of the batched loops. Each instruction set loads them into   *
+         *  the batches of its own back end, Batch<V> with V from             *
+         *  qnf_simd.hpp (see run_lanes), so every level times the same       *
+         *  points.                                                           */
+        template <template <class> class Batch>
+        struct lanes_of {
+            static const unsigned int dims = Batch<simd::vec>::dims;
+            double dat[dims][simd::max_width];
+        };
+
+        typedef lanes_of<basic_quaternion_batch> quaternion_lanes;
+        typedef lanes_of<basic_complex_batch> complex_lanes;
+
+        /*  Sum of the components of the final points. Keeps the compiler    *
+         *  from discarding the work and checks that both loops agree.        */
+        inline double checksum(const quaternion &q)
+        {
+            return q.dat[0] + q.dat[1] + q.dat[2] + q.dat[3];
+        }
+
+        inline double checksum(const complex &z)
+        {
+            return z.dat[0] + z.dat[1];
+        }
+
+        template <template <class> class Batch>
+        inline double checksum(const lanes_of<Batch> &q)
+        {
+            double sum = 0.0;
+            unsigned int m, n;
+
+            for (n = 0U; n < simd::max_width; ++n)
+                for (m = 0U; m < lanes_of<Batch>::dims; ++m)
+                    sum += q.dat[m][n];
+
+            return sum;
+        }
+
+        /*  Starting points: every "stride" pixel of the frame at "angle".    */
+        inline std::vector<quaternion>
+        sample_points(double angle, unsigned int stride)
+        {
+            const view v(angle);
+            std::vector<quaternion> points;
+            unsigned int x, y;
+
+            for (y = 0U; y < v.ysize; y += stride)
+                for (x = 0U; x < v.xsize; x += stride)
+                    points.push_back(v.point(x, y));
+
+            return points;
+        }
+
+        /*  Loads the points into number type T.                              */
+        inline void load(const quaternion *q, quaternion *out)
+        {
+            *out = *q;
+        }
+
+        inline void load(const quaternion *q, complex *out)
+        {
+            slice plane;
+            *out = plane.project(*q);
+        }
+
+        inline void load(const quaternion *q, quaternion_lanes *out)
+        {
+            unsigned int m, n;
+
+            for (n = 0U; n < simd::max_width; ++n)
+                for (m = 0U; m < 4U; ++m)
+                    out->dat[m][n] = q[n].dat[m];
+        }
+
+        inline void load(const quaternion *q, complex_lanes *out)
+        {
+            unsigned int n;
+
+            for (n = 0U; n < simd::max_width; ++n)
+            {
+                slice plane;
+                const complex z = plane.project(q[n]);
+                out->dat[0][n] = z.dat[0];
+                out->dat[1][n] = z.dat[1];
+            }
+        }
+
+        /*  Result of timing one loop over all of the sample points.          */
+        struct timing {
+            double seconds;
+            unsigned long int steps;
+            double checksum;
+        };
+
+        /*  Runs "loop" over the points "repeats" times, keeping the fastest. *
+         *  The points are loaded into T inside the loop, which costs the same *
+         *  for both loops and is small next to the Newton iterations.        */
+        template <class T, class Loop>
+        inline timing
+        time_loop(const std::vector<quaternion> &points, unsigned int lanes,
+                  Loop loop, unsigned int repeats)
+        {
+            typedef std::chrono::steady_clock clock;
+            timing best;
+            unsigned int r;
+            unsigned long int n;
+
+            best.seconds = 0.0;
+            best.steps = 0UL;
+            best.checksum = 0.0;
+
+            for (r = 0U; r < repeats; ++r)
+            {
+                timing t;
+                t.steps = 0UL;
+                t.checksum = 0.0;
+
+                const clock::time_point start = clock::now();
+
+                for (n = 0UL; n + lanes <= points.size(); n += lanes)
+                {
+                    T q;
+                    load(&points[n], &q);
+                    t.checksum += checksum(loop(q, &t.steps));
+                }
+
+                const std::chrono::duration<double> elapsed =
+                    clock::now() - start;
+                t.seconds = elapsed.count();
+
+                if (r == 0U || t.seconds < best.seconds)
+                    best = t;
+            }
+
+            return best;
+        }
+
+        /*  Number of starting points held by one value of each type.         */
+        inline unsigned int lanes(const quaternion *) { return 1U; }
+        inline unsigned int lanes(const complex *) { return 1U; }
+
+        template <template <class> class Batch>
+        inline unsigned int lanes(const lanes_of<Batch> *)
+        {
+            return simd::max_width;
+        }
+
+        /*  Times the unfused and fused loops for number type T and prints    *
+         *  the time per Newton step. Returns false if the loops disagree.    */
+        template <class Poly, class T, class Unfused, class Fused>
+        inline bool
+        compare(const char *type_name, const std::vector<quaternion> &points,
+                Unfused unfused_loop, Fused fused_loop, unsigned int repeats)
+        {
+            const unsigned int n_lanes = lanes(static_cast<const T *>(0));
+            const timing a =
+                time_loop<T>(points, n_lanes, unfused_loop, repeats);
+            const timing b =
+                time_loop<T>(points, n_lanes, fused_loop, repeats);
+            bool same;
+
+            /*  Compared bit for bit. Orbits from 0 divide by zero and end    *
+             *  as NaN, which never compares equal with ==.                   */
+            same = !std::memcmp(&a.checksum, &b.checksum, sizeof(double)) &&
+                   (a.steps == b.steps);
+
+            std::printf("%-8s %-16s %9lu steps  unfused %6.2f ns/step  "
+                        "fused %6.2f ns/step  speedup %.2fx  %s\n",
+                        Poly::name(), type_name, a.steps,
+                        1.0E9 * a.seconds / static_cast<double>(a.steps),
+                        1.0E9 * b.seconds / static_cast<double>(b.steps),
+                        a.seconds / b.seconds,
+                        same ? "identical" : "RESULTS DIFFER");
+            return same;
+        }
+
+        /*  The batched loop on the points of "l", in batches of the back end *
+         *  of the register type V.                                           */
+        template <class Poly, class V, bool is_fused,
+                  template <class> class Batch>
+        inline lanes_of<Batch>
+        run_lanes(lanes_of<Batch> l, double eps_sq, unsigned int max_iters,
+                  unsigned long int *steps)
+        {
+            double *c[lanes_of<Batch>::dims];
+            unsigned int m;
+
+            for (m = 0U; m < lanes_of<Batch>::dims; ++m)
+                c[m] = l.dat[m];
+
+            for (m = 0U; m < simd::max_width; m += V::width)
+            {
+                Batch<V> q = Batch<V>::load(c, m);
+
+                if (is_fused)
+                    fused_batch<Poly>(&q, eps_sq, max_iters, steps);
+                else
+                    unfused_batch<Poly>(&q, eps_sq, max_iters, steps);
+
+                q.store(c, m);
+            }
+
+            return l;
+        }
+
+        /*  Picks one of the four loops above at compile time. V is the       *
+         *  register type of the batched loops.                               */
+        template <class Poly, class V, class T>
+        inline T run(const T &q, double eps_sq, unsigned int max_iters,
+                     unsigned long int *steps, std::false_type, std::false_type)
+        {
+            return unfused<Poly>(q, eps_sq, max_iters, steps);
+        }
+
+        template <class Poly, class V, class T>
+        inline T run(const T &q, double eps_sq, unsigned int max_iters,
+                     unsigned long int *steps, std::true_type, std::false_type)
+        {
+            return fused<Poly>(q, eps_sq, max_iters, steps);
+        }
+
+        template <class Poly, class V, class T>
+        inline T run(const T &q, double eps_sq, unsigned int max_iters,
+                     unsigned long int *steps, std::false_type, std::true_type)
+        {
+            return run_lanes<Poly, V, false>(q, eps_sq, max_iters, steps);
+        }
+
+        template <class Poly, class V, class T>
+        inline T run(const T &q, double eps_sq, unsigned int max_iters,
+                     unsigned long int *steps, std::true_type, std::true_type)
+        {
+            return run_lanes<Poly, V, true>(q, eps_sq, max_iters, steps);
+        }
+
+        /*  One of the loops with fixed parameters, called as loop(q, &steps).*
+         *  The batched loops run in the copy compiled for the instruction    *
+         *  set "isa", single points at the baseline, as in the renderer.     */
+        template <class Poly, class T, bool is_fused, bool is_batch>
+        struct loop {
+            double eps_sq;
+            unsigned int max_iters;
+            isa_level isa;
+
+            loop(double e, unsigned int m, isa_level level)
+                : eps_sq(e), max_iters(m), isa(level)
+            {
+                return;
+            }
+
+            inline T operator () (const T &q, unsigned long int *steps) const
+            {
+#ifdef QNF_ISA_DISPATCH
+                if (is_batch && isa == isa_avx512)
+                    return run_avx512(q, steps);
+
+                if (is_batch && isa == isa_avx2)
+                    return run_avx2(q, steps);
+#endif
+                return run_loop<simd::native::vec>(q, steps);
+            }
+
+            template <class V>
+            inline T run_loop(const T &q, unsigned long int *steps) const
+            {
+                return run<Poly, V>(q, eps_sq, max_iters, steps,
+                                    std::integral_constant<bool, is_fused>(),
+                                    std::integral_constant<bool, is_batch>());
+            }
+
+#ifdef QNF_ISA_DISPATCH
+            QNF_TARGET_AVX2
+            T run_avx2(const T &q, unsigned long int *steps) const
+            {
+                return run_loop<simd::avx2::vec>(q, steps);
+            }
+
+            QNF_TARGET_AVX512
+            T run_avx512(const T &q, unsigned long int *steps) const
+            {
+                return run_loop<simd::avx512::vec>(q, steps);
+            }
+#endif
+        };
+
+        /*  Compares the loops for number type T.                             */
+        template <class Poly, class T, bool is_batch>
+        inline bool
+        compare_type(const char *type_name,
+                     const std::vector<quaternion> &points,
+                     double eps_sq, unsigned int max_iters, isa_level isa)
+        {
+            const unsigned int repeats = 5U;
+            return compare<Poly, T>(
+                type_name, points,
+                loop<Poly, T, false, is_batch>(eps_sq, max_iters, isa),
+                loop<Poly, T, true, is_batch>(eps_sq, max_iters, isa),
+                repeats
+            );
+        }
+
+        /*  The complex types, for real polynomials only.                     */
+        template <class Poly>
+        inline bool
+        compare_complex(const std::vector<quaternion> &points,
+                        double eps_sq, unsigned int max_iters, isa_level isa,
+                        std::true_type)
+        {
+            bool same = compare_type<Poly, complex, false>(
+                "complex", points, eps_sq, max_iters, isa
+            );
+
+            return compare_type<Poly, complex_lanes, true>(
+                "complex_batch", points, eps_sq, max_iters, isa
+            ) && same;
+        }
+
+        template <class Poly>
+        inline bool
+        compare_complex(const std::vector<quaternion> &, double,
+                        unsigned int, isa_level, std::false_type)
+        {
+            return true;
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      newton_step                                                   *
+         *  Purpose:                                                          *
+         *      Times Newton's method written as newton(q) then func(q)       *
+         *      against the fused eval and step, for every number type the    *
+         *      polynomial supports, from points of a frame of the rotation.  *
+         *      The batched loops run in the copy compiled for the            *
+         *      instruction set "isa" with the registers of its back end, see *
+         *      qnf_cpu.hpp, and the single points at the baseline.           *
+         *  Output:                                                           *
+         *      same (bool):                                                  *
+         *          True if both ways give bit-identical orbits.              *
+         **********************************************************************/
+        template <class Poly>
+        inline bool newton_step(double eps_sq, unsigned int max_iters,
+                                isa_level isa = detect_isa())
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+
+            /*  A frame between the axes, so no coordinate is trivially zero. */
+            const std::vector<quaternion> points = sample_points(0.3, 4U);
+            bool same;
+
+            std::printf("Instruction set: %s\n", isa_name(isa));
+
+            same = compare_type<Poly, quaternion, false>(
+                "quaternion", points, eps_sq, max_iters, isa
+            );
+
+            same = compare_type<Poly, quaternion_lanes, true>(
+                "quaternion_batch", points, eps_sq, max_iters, isa
+            ) && same;
+
+            return compare_complex<Poly>(points, eps_sq, max_iters, isa,
+                                         real()) && same;
+        }
+
+        /*  What compare_methods measures for one method.                     */
+        struct method_timing {
+            double seconds;
+            unsigned long int steps, unconverged, samples, differ, pixels;
+        };
+
+        /*  Runs the kernel's own loop from every 4th pixel of the frame v in *
+         *  each direction, and adds up the Newton steps and the orbits that  *
+         *  did not converge. Complex slices for real coefficients, as in the *
+         *  renderer, the root balls included.                               */
+        template <class Kernel>
+        inline void
+        sample_orbits(const Kernel &k, const view &v, method_timing *t,
+                      std::true_type)
+        {
+            unsigned int x, y, steps;
+            double p_norm_sq;
+
+            for (y = 0U; y < v.ysize; y += 4U)
+            {
+                for (x = 0U; x < v.xsize; x += 4U)
+                {
+                    slice plane;
+                    k.iterate(plane.project(v.point(x, y)), &p_norm_sq, &steps);
+                    t->steps += steps;
+                    t->unconverged += (p_norm_sq < k.eps_sq ? 0UL : 1UL);
+                    t->samples += 1UL;
+                }
+            }
+        }
+
+        /*  Without real coefficients the orbits are quaternions.             */
+        template <class Kernel>
+        inline void
+        sample_orbits(const Kernel &k, const view &v, method_timing *t,
+                      std::false_type)
+        {
+            unsigned int x, y, steps;
+            double p_norm_sq;
+
+            for (y = 0U; y < v.ysize; y += 4U)
+            {
+                for (x = 0U; x < v.xsize; x += 4U)
+                {
+                    k.iterate(v.point(x, y), &p_norm_sq, &steps);
+                    t->steps += steps;
+                    t->unconverged += (p_norm_sq < k.eps_sq ? 0UL : 1UL);
+                    t->samples += 1UL;
+                }
+            }
+        }
+
+        /*  Renders the frames "frames" of the rotation with the method       *
+         *  Method and prints its line of the table. The frames of the first  *
+         *  method, Newton's, are kept in "reference" and the others are      *
+         *  compared against them.                                            */
+        template <class Method, class Colorer>
+        inline void
+        time_method(thread_pool &pool, const Colorer &colorer,
+                    const render_options &opts, const char *name,
+                    const std::vector<unsigned int> &frames,
+                    std::vector<framebuffer> &reference)
+        {
+            typedef std::chrono::steady_clock clock;
+            typedef std::integral_constant<bool, Method::real_coefficients>
+                real;
+            typedef std::integral_constant<
+                bool, Method::real_coefficients && Method::is_newton
+            > has_balls;
+            const bool first = reference.empty();
+            kernel<Method, Colorer> k(colorer, opts.eps_sq, opts.max_iters);
+            root_balls<Method> balls;
+            view v = opts.window;
+            const std::vector<tile> tiles =
+                make_tiles(v.xsize, v.ysize, opts.tile_size, opts.tile_size);
+            framebuffer fb(v.xsize, v.ysize);
+            method_timing t;
+            unsigned int n;
+            int max_diff;
+
+            std::memset(&t, 0, sizeof(t));
+            k.balls = maybe_build_balls(balls, opts, has_balls());
+            k.subdivide = opts.subdivide;
+            k.isa = opts.isa;
+            k.precision = opts.precision;
+
+            for (n = 0U; n < frames.size(); ++n)
+            {
+                v.rotate_frame(frames[n], opts.n_frames);
+
+                const clock::time_point start = clock::now();
+
+                pool.parallel_for(
+                    static_cast<unsigned int>(tiles.size()),
+                    [&](unsigned int m) {
+                        k(tiles[m], v, fb);
+                    }
+                );
+
+                const std::chrono::duration<double> elapsed =
+                    clock::now() - start;
+                t.seconds += elapsed.count();
+
+                sample_orbits(k, v, &t, real());
+
+                if (first)
+                    reference.push_back(fb);
+                else
+                    t.differ += count_differences(reference[n], fb,
+                                                  &max_diff, 1);
+
+                t.pixels += static_cast<unsigned long int>(v.xsize) * v.ysize;
+            }
+
+            std::printf("%-10s %6.2f steps/pixel %8.1f ms/frame "
+                        "%6.2f%% unconverged %6.2f%% differ from newton\n",
+                        name,
+                        static_cast<double>(t.steps) / t.samples,
+                        1.0E3 * t.seconds / frames.size(),
+                        100.0 * static_cast<double>(t.unconverged) /
+                                t.samples,
+                        100.0 * static_cast<double>(t.differ) / t.pixels);
+        }
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      compare_methods                                               *
+         *  Purpose:                                                          *
+         *      Renders 8 frames spread over the rotation with each method of *
+         *      qnf_method.hpp and prints, per method, the average number of  *
+         *      steps per pixel, the wall time per frame, the share of the    *
+         *      orbits that did not converge, and the share of the pixels     *
+         *      that differ by more than one level from Newton's method.      *
+         *  Notes:                                                            *
+         *      The frames are rendered with the kernel and the options of    *
+         *      render (instruction set, precision, subdivision, root balls   *
+         *      for Newton's method), but without symmetry or the table. The  *
+         *      steps are counted in the scalar loop from every 16th pixel,   *
+         *      the time covers the whole frame.                              *
+         **********************************************************************/
+        template <class Poly, class Colorer>
+        inline bool compare_methods(thread_pool &pool, const Colorer &colorer,
+                                    const render_options &opts)
+        {
+            const unsigned int n_bench = 8U;
+            std::vector<unsigned int> frames;
+            std::vector<framebuffer> reference;
+            unsigned int n;
+
+            for (n = 0U; n < n_bench; ++n)
+                frames.push_back(n * opts.n_frames / n_bench);
+
+            std::printf("%s, %u frames, %u threads:\n", Poly::name(),
+                        n_bench, pool.size());
+
+            time_method<Poly>(pool, colorer, opts, "newton",
+                              frames, reference);
+            time_method<methods::damped<Poly> >(pool, colorer, opts,
+                                                "damped", frames, reference);
+            time_method<methods::halley<Poly> >(pool, colorer, opts,
+                                                "halley", frames, reference);
+            time_method<methods::schroeder<Poly> >(pool, colorer, opts,
+                                                   "schroeder", frames,
+                                                   reference);
+            return true;
+        }
+    }
+    /*  End of namespace "benchmark".                                         */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
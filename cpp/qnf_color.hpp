@@ -37,6 +37,9 @@
 /*  File data type found here.                                                */
 #include <cstdio>
 
+/*  floor, for the saturation offset.                                         */
+#include <cmath>
+
 /*  Namespace for the project. "Quaternion Newton Fractal."                   */
 namespace qnf {
 
@@ -93,6 +96,24 @@ namespace qnf {
          **********************************************************************/
         inline void write(qnf::ppm &PPM) const;
 
+        /**********************************************************************
+         *  Method:                                                           *
+         *      qnf::write                                                    *
+         *  Purpose:                                                          *
+         *      Writes a color to a pixel of a frame buffer.                  *
+         *  Arguments:                                                        *
+         *      fb (qnf::framebuffer &):                                      *
+         *          The frame buffer.                                         *
+         *      x (unsigned int):                                             *
+         *          The column of the pixel.                                  *
+         *      y (unsigned int):                                             *
+         *          The row of the pixel.                                     *
+         *  Outputs:                                                          *
+         *      None (void).                                                  *
+         **********************************************************************/
+        inline void write(qnf::framebuffer &fb,
+                          unsigned int x, unsigned int y) const;
+
         /**********************************************************************
          *  Operator:                                                         *
          *      *                                                             *
@@ -211,6 +232,30 @@ namespace qnf {
         write(PPM.fp);
     }
 
+    /**************************************************************************
+     *  Method:                                                               *
+     *      qnf::write                                                        *
+     *  Purpose:                                                              *
+     *      Writes a color to a pixel of a frame buffer.                      *
+     *  Arguments:                                                            *
+     *      fb (qnf::framebuffer &):                                          *
+     *          The frame buffer.                                             *
+     *      x (unsigned int):                                                 *
+     *          The column of the pixel.                                      *
+     *      y (unsigned int):                                                 *
+     *          The row of the pixel.                                         *
+     *  Outputs:                                                              *
+     *      None (void).                                                      *
+     **************************************************************************/
+    inline void
+    color::write(qnf::framebuffer &fb, unsigned int x, unsigned int y) const
+    {
+        unsigned char * const px = fb.pixel(x, y);
+        px[0] = red;
+        px[1] = green;
+        px[2] = blue;
+    }
+
     /**************************************************************************
      *  Operator:                                                             *
      *      *                                                                 *
@@ -223,16 +268,20 @@ namespace qnf {
      *      tc (qnf::color).                                                  *
      *          The color *this* with each color channel scaled by t.         *
      *  Method:                                                               *
-     *      Scale each color channel by t and then cast to unsigned char.     *
+     *      Round t down to a multiple of 2^-16 once, then scale each color   *
+     *      channel in integer arithmetic and shift the fraction out.         *
      *  Notes:                                                                *
      *      No checks for overflow are performed. Large or negative values of *
-     *      t may yield unexpected results.                                   *
+     *      t may yield unexpected results. A channel may come out one level  *
+     *      below the exact product t*c truncated, never above it. Halving,   *
+     *      t = 0.5, is exact.                                                *
      **************************************************************************/
     inline color color::operator * (double t) const
     {
-        const unsigned char r = static_cast<unsigned char>(t*red);
-        const unsigned char g = static_cast<unsigned char>(t*green);
-        const unsigned char b = static_cast<unsigned char>(t*blue);
+        const unsigned int s = static_cast<unsigned int>(t * 65536.0);
+        const unsigned char r = static_cast<unsigned char>((s*red) >> 16);
+        const unsigned char g = static_cast<unsigned char>((s*green) >> 16);
+        const unsigned char b = static_cast<unsigned char>((s*blue) >> 16);
         return color(r, g, b);
     }
 
@@ -247,17 +296,14 @@ namespace qnf {
      *  Outputs:                                                              *
      *      None (void).                                                      *
      *  Method:                                                               *
-     *      Scale each color channel by t and then cast to unsigned char. The *
-     *      end result is then stored in *this*.                              *
+     *      Same as the * operator, the result is stored in *this*.           *
      *  Notes:                                                                *
      *      No checks for overflow are performed. Large or negative values of *
      *      t may yield unexpected results.                                   *
      **************************************************************************/
     inline void color::operator *= (double t)
     {
-        red = static_cast<unsigned char>(t*red);
-        green = static_cast<unsigned char>(t*green);
-        blue = static_cast<unsigned char>(t*blue);
+        *this = *this * t;
     }
 
     /**************************************************************************
@@ -272,17 +318,18 @@ namespace qnf {
      *      mix (qnf::color).                                                 *
      *          The average of the color c and *this*.                        *
      *  Method:                                                               *
-     *      Cast each channel to double to avoid overflow. Then average       *
-     *      the values together and cast back to unsigned char.               *
+     *      Add the channels as unsigned ints, which cannot overflow, and     *
+     *      halve with a shift. This rounds down, as the cast did when the    *
+     *      average was taken in double.                                      *
      **************************************************************************/
     inline color color::operator + (const qnf::color &c) const
     {
-        /*  Cast the values to doubles and take the average, component-wise.  */
-        const double x = 0.5 * (double(red) + double(c.red));
-        const double y = 0.5 * (double(green) + double(c.green));
-        const double z = 0.5 * (double(blue) + double(c.blue));
+        /*  Average component-wise in integers.                               */
+        const unsigned int x = (unsigned(red) + unsigned(c.red)) >> 1;
+        const unsigned int y = (unsigned(green) + unsigned(c.green)) >> 1;
+        const unsigned int z = (unsigned(blue) + unsigned(c.blue)) >> 1;
 
-        /*  Cast the double back to unsigned char's and return.               */
+        /*  The averages are at most 255 and fit back into the channels.      */
         const unsigned char r = static_cast<unsigned char>(x);
         const unsigned char g = static_cast<unsigned char>(y);
         const unsigned char b = static_cast<unsigned char>(z);
@@ -304,15 +351,7 @@ namespace qnf {
      **************************************************************************/
     inline void color::operator += (const qnf::color &c)
     {
-        /*  Cast the values to doubles and take the average, component-wise.  */
-        const double x = 0.5 * (double(red) + double(c.red));
-        const double y = 0.5 * (double(green) + double(c.green));
-        const double z = 0.5 * (double(blue) + double(c.blue));
-
-        /*  Cast the double back to unsigned char's and return.               */
-        red = static_cast<unsigned char>(x);
-        green = static_cast<unsigned char>(y);
-        blue = static_cast<unsigned char>(z);
+        *this = *this + c;
     }
 
     /*  Constant colors that are worth having.                                */
@@ -349,117 +388,111 @@ namespace qnf {
     }
     /*  End of namespace "colors".                                            */
 
-    inline color color_wheel(double angle)
-    {
-        /*  There are 1535 possible colors given by the gradient. This scale  *
-         *  factor helps normalize the angle.                                 */
-        const double gradient_factor = 1535 / TWO_PI;
-
-        /*  Scale the angle from (-pi, pi) to (0, 1023).                      */
-        double val = (angle + ONE_PI) * gradient_factor;
-
-        /*  Lastly, a color for the output.                                   */
-        color out;
-
-        /*  Values outside the legal range (angle < -pi). Return blue.        */
-        if (val < 0.0)
-            return colors::blue();
-
-        /*  For 0 <= val < 256 transition from blue to cyan.                  */
-        else if (val < 256.0)
+    /*  The gradient of color_wheel as a table, blue to cyan, green, yellow,  *
+     *  red, magenta and back to blue in six runs of 256 entries. For val     *
+     *  the scaled angle of color_wheel, entries[n] is the color for          *
+     *  n < val < n + 1 and at_integer[n] the color for val = n. The falling  *
+     *  channels of the two differ by one, as they did when color_wheel       *
+     *  computed 256 - (val - start) and truncated it (256 wrapping to 0).    */
+    struct gradient_table {
+        static const unsigned int size = 1536U;
+        color entries[size], at_integer[size];
+
+        gradient_table(void)
         {
-            out.red = 0x00U;
-            out.green = static_cast<unsigned char>(val);
-            out.blue = 0xFFU;
+            unsigned int n;
+
+            for (n = 0U; n < size; ++n)
+            {
+                const unsigned int m = n & 0xFFU;
+                entries[n] = run(n >> 8, m, 0xFFU - m);
+                at_integer[n] = run(n >> 8, m, (0x100U - m) & 0xFFU);
+            }
         }
 
-        /*  For 256 <= val < 512 transition from cyan to green.               */
-        else if (val < 512.0)
+        /*  The color of run k with rising channel up and falling one down.   */
+        static inline color run(unsigned int k, unsigned int up,
+                                unsigned int down)
         {
-            /*  Shift val back to the range (0, 256).                         */
-            val -= 256.0;
-
-            /*  Transition from cyan to green.                                */
-            out.red = 0x00U;
-            out.green = 0xFFU;
-            out.blue = static_cast<unsigned char>(256.0 - val);
-        }
-
-        /*  For 512 <= val < 768 transition from green to yellow.             */
-        else if (val < 768.0)
-        {
-            /*  Shift val back to the range (0, 256).                         */
-            val -= 512.0;
-
-            /*  Transition from green to yellow.                              */
-            out.red = static_cast<unsigned char>(val);
-            out.green = 0xFFU;
-            out.blue = 0x00U;
-        }
-
-        /*  For 768 <= val < 1024 transition from yellow to red.              */
-        else if (val < 1024.0)
-        {
-            /*  Shift val back to the range (0, 256).                         */
-            val -= 768.0;
-
-            /*  Transition from yellow to red.                                */
-            out.red = 0xFFU;
-            out.green = static_cast<unsigned char>(256.0 - val);
-            out.blue = 0x00U;
+            const unsigned char u = static_cast<unsigned char>(up);
+            const unsigned char d = static_cast<unsigned char>(down);
+
+            switch (k)
+            {
+                case 0U:
+                    return color(0x00U, u, 0xFFU);
+                case 1U:
+                    return color(0x00U, 0xFFU, d);
+                case 2U:
+                    return color(u, 0xFFU, 0x00U);
+                case 3U:
+                    return color(0xFFU, d, 0x00U);
+                case 4U:
+                    return color(0xFFU, 0x00U, u);
+                default:
+                    return color(d, 0x00U, 0xFFU);
+            }
         }
+    };
 
-        /*  For 1024 <= val < 1280 transition from red to magenta.            */
-        else if (val < 1280.0)
-        {
-            /*  Shift val back to the range (0, 256).                         */
-            val -= 1024.0;
-
-            /*  Gradient from red to magenta.                                 */
-            out.red = 0xFFU;
-            out.green = 0x00U;
-            out.blue = static_cast<unsigned char>(val);
-        }
+    /*  The table, built on first use.                                        */
+    inline const gradient_table &gradient(void)
+    {
+        static const gradient_table table;
+        return table;
+    }
 
-        /*  Finally transition from magenta back to blue.                     */
-        else if (val < 1536.0)
-        {
-            /*  Shift val back to the range (0, 256).                         */
-            val -= 1280.0;
+    /**************************************************************************
+     *  Function:                                                             *
+     *      color_wheel                                                       *
+     *  Purpose:                                                              *
+     *      Maps an angle in [-pi, pi] to a color of the rainbow gradient.    *
+     *  Arguments:                                                            *
+     *      angle (double):                                                   *
+     *          The angle, e.g. from atan2.                                   *
+     *  Output:                                                               *
+     *      c (qnf::color):                                                   *
+     *          The color. Blue for angles outside [-pi, pi] and for NaN.     *
+     *  Method:                                                               *
+     *      Scale the angle to 0 <= val < 1536 and look the color up in the   *
+     *      gradient table, which holds the colors the six-way branch on val  *
+     *      computed before. Choosing between the two halves of the table is  *
+     *      a select, not a branch.                                           *
+     **************************************************************************/
+    inline color color_wheel(double angle)
+    {
+        /*  There are 1535 possible colors given by the gradient. This scale  *
+         *  factor helps normalize the angle.                                 */
+        const double gradient_factor = 1535 / TWO_PI;
 
-            /*  Transition from magenta to blue.                              */
-            out.red = static_cast<unsigned char>(256.0 - val);
-            out.green = 0x00U;
-            out.blue = 0xFFU;
-        }
+        /*  Scale the angle from (-pi, pi) to (0, 1535).                      */
+        const double val = (angle + ONE_PI) * gradient_factor;
 
-        /*  Values outside the legal range (angle > +pi). Return blue.        */
-        else
+        /*  Values outside the legal range, and NaN. Return blue.             */
+        if (!(val >= 0.0 && val < 1536.0))
             return colors::blue();
 
-        return out;
+        const unsigned int n = static_cast<unsigned int>(val);
+        const gradient_table &table = gradient();
+        return (val == double(n) ? table.at_integer[n] : table.entries[n]);
     }
 
-    inline double clamp(double x)
+    /*  Clamps an integer to the range of a color channel.                    */
+    inline unsigned char clamp_channel(int x)
     {
-        if (x < 0.0)
-            return 0.0;
-
-        if (x > 255.0)
-            return 255.0;
-
-        return x;
+        return static_cast<unsigned char>(x < 0 ? 0 : (x > 255 ? 255 : x));
     }
 
+    /*  Lightens (val > 0) or darkens (val < 0) a color by 255*val levels.    *
+     *  Since the channels are integers, truncating c + 255*val is the same   *
+     *  as adding floor(255*val), so the offset is computed once and the      *
+     *  channels are shifted and clamped in integer arithmetic.               */
     inline color saturate(const color &c, double val)
     {
-        const double r = clamp(c.red + 255.0*val);
-        const double g = clamp(c.green + 255.0*val);
-        const double b = clamp(c.blue + 255.0*val);
-
-        const unsigned char red = static_cast<unsigned char>(r);
-        const unsigned char green = static_cast<unsigned char>(g);
-        const unsigned char blue = static_cast<unsigned char>(b);
+        const int shift = static_cast<int>(std::floor(255.0*val));
+        const unsigned char red = clamp_channel(int(c.red) + shift);
+        const unsigned char green = clamp_channel(int(c.green) + shift);
+        const unsigned char blue = clamp_channel(int(c.blue) + shift);
         return color(red, green, blue);
     }
 
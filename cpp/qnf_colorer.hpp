@@ -0,0 +1,134 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the coloring policies, which turn the end of a Newton orbit  *
+ *      into the color of a pixel.                                            *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_COLORER_HPP
+#define QNF_COLORER_HPP
+
+/*  sqrt and atan2 are found here.                                            */
+#include <cmath>
+
+/*  Quaternions and colors.                                                   */
+#include "qnf_quaternion.hpp"
+#include "qnf_color.hpp"
+
+/*  Polynomial atan2, for the fast colorer.                                   */
+#include "qnf_fast_math.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  A colorer is a struct with                                            *
+     *      qnf::color operator () (const qnf::quaternion &q,                 *
+     *                              double p_norm_sq) const;                  *
+     *  where q is the last point of the orbit and p_norm_sq is |p(q)|^2.     *
+     *  Orbits that did not converge are passed with p_norm_sq = HUGE_VAL.    */
+    namespace colorers {
+
+        /*  Black for points that do not converge, gray for the real roots,   *
+         *  and for the other roots a color on the sphere of directions of    *
+         *  the imaginary part: hue from the angle in the i-j plane and       *
+         *  brightness from the elevation towards k.                          */
+        struct sphere {
+            double eps, eps_sq;
+
+            sphere(double tol = 1.0E-8) : eps(tol), eps_sq(tol*tol)
+            {
+                return;
+            }
+
+            inline color
+            operator () (const quaternion &q, double p_norm_sq) const
+            {
+                /*  Adding zero turns -0 into +0. Orbits that differ only in  *
+                 *  the signs of zero components then get the same color,     *
+                 *  where atan2(+-0, -1) = +-pi would otherwise split them.   */
+                const double x = q.dat[1] + 0.0;
+                const double y = q.dat[2] + 0.0;
+                const double z = q.dat[3] + 0.0;
+                const double rho_sq = x*x + y*y;
+
+                /*  NaN, from an orbit that landed on 0, did not converge.    */
+                if (!(p_norm_sq <= eps_sq))
+                    return colors::black();
+
+                else if (rho_sq + z*z < eps_sq)
+                    return colors::white() * 0.5;
+                else
+                {
+                    const double rho = std::sqrt(rho_sq);
+                    const double phi = std::atan2(z, rho);
+                    const double theta = std::atan2(y, x);
+                    return sphere_color(phi, theta);
+                }
+            }
+        };
+
+        /*  The same coloring with fast_atan2 in place of std::atan2. The     *
+         *  angles are off by less than 4E-8, so a pixel only changes color   *
+         *  when an angle lies that close to a step of the gradient or of the *
+         *  saturation, which --verify counts. Nothing in it branches apart   *
+         *  from the two tests on the residual and the distance to the axis.  */
+        struct sphere_fast {
+            double eps, eps_sq;
+
+            sphere_fast(double tol = 1.0E-8) : eps(tol), eps_sq(tol*tol)
+            {
+                return;
+            }
+
+            inline color
+            operator () (const quaternion &q, double p_norm_sq) const
+            {
+                /*  +0.0 turns -0 into +0 as in sphere.                       */
+                const double x = q.dat[1] + 0.0;
+                const double y = q.dat[2] + 0.0;
+                const double z = q.dat[3] + 0.0;
+                const double rho_sq = x*x + y*y;
+
+                /*  NaN, from an orbit that landed on 0, did not converge.    */
+                if (!(p_norm_sq <= eps_sq))
+                    return colors::black();
+
+                else if (rho_sq + z*z < eps_sq)
+                    return colors::white() * 0.5;
+                else
+                {
+                    const double rho = std::sqrt(rho_sq);
+                    const double phi = fast_atan2(z, rho);
+                    const double theta = fast_atan2(y, x);
+                    return sphere_color(phi, theta);
+                }
+            }
+        };
+    }
+    /*  End of namespace "colorers".                                          */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,349 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides complex numbers, single and batched. A polynomial with real  *
+ *      coefficients maps the plane spanned by 1 and a unit imaginary         *
+ *      quaternion n into itself, and that plane is a copy of the complex     *
+ *      numbers (n*n = -1). Newton's method can run there on two components.  *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_COMPLEX_HPP
+#define QNF_COMPLEX_HPP
+
+/*  sqrt function found here. Used for computing norms.                       */
+#include <cmath>
+
+/*  Quaternions, for moving between the complex plane and a slice of R^4.     */
+#include "qnf_quaternion.hpp"
+
+/*  SIMD registers and masks, used by the batched type.                       */
+#include "qnf_simd.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Struct for working with complex numbers with parts of type T. The     *
+     *  interface matches that of qnf::basic_quaternion so that the same      *
+     *  polynomial code runs on both.                                         */
+    template <class T>
+    struct basic_complex {
+        /*  Contiguous array for the real and imaginary parts.                */
+        T dat[2];
+
+        /*  Empty constructor. Set the complex number to the origin.          */
+        basic_complex(void)
+        {
+            dat[0] = T(0);
+            dat[1] = T(0);
+        }
+
+        /*  Constructor from the real and imaginary parts.                    */
+        basic_complex(T a, T b)
+        {
+            dat[0] = a;
+            dat[1] = b;
+        }
+
+        /*  Conversion from the other precision, rounding both parts.         */
+        template <class U>
+        basic_complex(const basic_complex<U> &z)
+        {
+            dat[0] = static_cast<T>(z.dat[0]);
+            dat[1] = static_cast<T>(z.dat[1]);
+        }
+
+        /*  Complex addition, which is vector addition in R^2.                */
+        inline basic_complex operator + (const basic_complex &z) const
+        {
+            return basic_complex(dat[0] + z.dat[0], dat[1] + z.dat[1]);
+        }
+
+        /*  Complex subtraction, which is vector subtraction in R^2.          */
+        inline basic_complex operator - (const basic_complex &z) const
+        {
+            return basic_complex(dat[0] - z.dat[0], dat[1] - z.dat[1]);
+        }
+
+        /*  Addition with a real number. Adds to the real part.               */
+        inline basic_complex operator + (T a) const
+        {
+            return basic_complex(dat[0] + a, dat[1]);
+        }
+
+        /*  Subtraction with a real number. Subtracts from the real part.     */
+        inline basic_complex operator - (T a) const
+        {
+            return basic_complex(dat[0] - a, dat[1]);
+        }
+
+        /*  Scalar multiplication, which is computed component-wise.          */
+        inline basic_complex operator * (T a) const
+        {
+            return basic_complex(a*dat[0], a*dat[1]);
+        }
+
+        /*  Complex multiplication. Requires 4 real multiplications.          */
+        inline basic_complex operator * (const basic_complex &z) const
+        {
+            const T a = dat[0]*z.dat[0] - dat[1]*z.dat[1];
+            const T b = dat[0]*z.dat[1] + dat[1]*z.dat[0];
+            return basic_complex(a, b);
+        }
+
+        /*  The square of the Euclidean norm (R^2 norm) of a complex number.  */
+        inline T norm_sq(void) const
+        {
+            return dat[0]*dat[0] + dat[1]*dat[1];
+        }
+
+        /*  The Euclidean norm (R^2 norm) of a complex number.                */
+        inline T norm(void) const
+        {
+            return std::sqrt(this->norm_sq());
+        }
+
+        /*  Squares a complex number. 3 real multiplications.                 */
+        inline basic_complex square(void) const
+        {
+            const T a = dat[0]*dat[0] - dat[1]*dat[1];
+            const T b = T(2)*dat[0]*dat[1];
+            return basic_complex(a, b);
+        }
+
+        /*  Cubes a complex number. This is quaternion::cube restricted to    *
+         *  the plane, which needs 6 real multiplications.                    */
+        inline basic_complex cube(void) const
+        {
+            const T rsq = dat[0]*dat[0];
+            const T vsq = dat[1]*dat[1];
+            const T factor = T(3)*rsq - vsq;
+            const T a = (rsq - T(3)*vsq) * dat[0];
+            const T b = factor * dat[1];
+            return basic_complex(a, b);
+        }
+
+        /*  Computes the complex conjugate, which negates the imaginary part. */
+        inline basic_complex conjugate(void) const
+        {
+            return basic_complex(dat[0], -dat[1]);
+        }
+
+        /*  Complex division. Requires 6 real multiplications and a division, *
+         *  versus 16 multiplications for quaternion division.                */
+        inline basic_complex operator / (const basic_complex &z) const
+        {
+            const T a = dat[0]*z.dat[0] + dat[1]*z.dat[1];
+            const T b = dat[1]*z.dat[0] - dat[0]*z.dat[1];
+            const T factor = T(1) / z.norm_sq();
+            return basic_complex(a*factor, b*factor);
+        }
+    };
+    /*  End of basic_complex struct.                                          */
+
+    /*  Double and single precision complex numbers.                          */
+    typedef basic_complex<double> complex;
+    typedef basic_complex<float> complexf;
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      slice                                                             *
+     *  Purpose:                                                              *
+     *      The plane through the real axis containing a quaternion q. Write  *
+     *      q = a + v with v imaginary. If v != 0 then n = v / |v| is a unit  *
+     *      imaginary quaternion and q is the complex number a + |v| i under  *
+     *      the identification i <-> n. A polynomial with real coefficients   *
+     *      commutes with this identification, so its Newton orbit starting   *
+     *      at q can be computed in the complex plane and mapped back.        *
+     *  Notes:                                                                *
+     *      For real q the direction is set to zero. Real points stay real    *
+     *      under a real polynomial, so lifting back is still correct.        *
+     **************************************************************************/
+    struct slice {
+        /*  The unit imaginary direction n, or zero if q is real.             */
+        double n[3];
+
+        /*  Projects q to the complex plane and remembers the direction.      */
+        inline complex project(const quaternion &q)
+        {
+            const double r = std::sqrt(q.dat[1]*q.dat[1] +
+                                       q.dat[2]*q.dat[2] +
+                                       q.dat[3]*q.dat[3]);
+
+            if (r == 0.0)
+            {
+                n[0] = n[1] = n[2] = 0.0;
+                return complex(q.dat[0], 0.0);
+            }
+
+            n[0] = q.dat[1] / r;
+            n[1] = q.dat[2] / r;
+            n[2] = q.dat[3] / r;
+            return complex(q.dat[0], r);
+        }
+
+        /*  Maps x + yi back to the quaternion x + y n.                       */
+        inline quaternion lift(const complex &z) const
+        {
+            const double y = z.dat[1];
+            return quaternion(z.dat[0], y*n[0], y*n[1], y*n[2]);
+        }
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      basic_complex_batch                                               *
+     *  Purpose:                                                              *
+     *      V::width complex numbers stored as structure-of-arrays, the       *
+     *      batched counterpart of qnf::basic_complex. V is simd::vec for     *
+     *      double precision (complex_batch) and simd::vecf for single        *
+     *      precision (complex_batchf), which holds twice as many lanes, or   *
+     *      their counterparts of another back end in qnf_simd.hpp.           *
+     **************************************************************************/
+    template <class V>
+    struct basic_complex_batch {
+        typedef V vec_type;
+        typedef typename simd::traits<V>::scalar scalar;
+        typedef typename simd::traits<V>::mask mask_type;
+
+        V a, b;
+
+        static const unsigned int width = V::width;
+
+        /*  Number of components, the arrays load and store take.             */
+        static const unsigned int dims = 2U;
+
+        basic_complex_batch(void) { return; }
+
+        basic_complex_batch(const V &a0, const V &b0) : a(a0), b(b0)
+        {
+            return;
+        }
+
+        /*  Lanes first to first + width - 1 of the real parts c[0] and the   *
+         *  imaginary parts c[1].                                             */
+        static inline basic_complex_batch
+        load(const scalar *const *c, unsigned int first)
+        {
+            return basic_complex_batch(V::load(c[0] + first),
+                                       V::load(c[1] + first));
+        }
+
+        /*  Stores the lanes back to where load took them from.               */
+        inline void store(scalar *const *c, unsigned int first) const
+        {
+            simd::store(c[0] + first, a);
+            simd::store(c[1] + first, b);
+        }
+
+        inline basic_complex_batch
+        operator + (const basic_complex_batch &z) const
+        {
+            return basic_complex_batch(a + z.a, b + z.b);
+        }
+
+        inline basic_complex_batch
+        operator - (const basic_complex_batch &z) const
+        {
+            return basic_complex_batch(a - z.a, b - z.b);
+        }
+
+        inline basic_complex_batch operator + (scalar r) const
+        {
+            return basic_complex_batch(a + V(r), b);
+        }
+
+        inline basic_complex_batch operator - (scalar r) const
+        {
+            return basic_complex_batch(a - V(r), b);
+        }
+
+        inline basic_complex_batch operator * (scalar r) const
+        {
+            const V s(r);
+            return basic_complex_batch(s*a, s*b);
+        }
+
+        inline basic_complex_batch
+        operator * (const basic_complex_batch &z) const
+        {
+            return basic_complex_batch(a*z.a - b*z.b, a*z.b + b*z.a);
+        }
+
+        inline V norm_sq(void) const
+        {
+            return a*a + b*b;
+        }
+
+        inline basic_complex_batch square(void) const
+        {
+            const V two(2.0);
+            return basic_complex_batch(a*a - b*b, two*a*b);
+        }
+
+        inline basic_complex_batch cube(void) const
+        {
+            const V three(3.0);
+            const V rsq = a*a;
+            const V vsq = b*b;
+            const V factor = three*rsq - vsq;
+            return basic_complex_batch((rsq - three*vsq) * a, factor * b);
+        }
+
+        inline basic_complex_batch
+        operator / (const basic_complex_batch &z) const
+        {
+            const V a0 = a*z.a + b*z.b;
+            const V b0 = b*z.a - a*z.b;
+            const V factor = V(1.0) / z.norm_sq();
+            return basic_complex_batch(a0*factor, b0*factor);
+        }
+
+        /*  Lane-wise m ? p : q.                                              */
+        static inline basic_complex_batch
+        select(const mask_type &m, const basic_complex_batch &p,
+               const basic_complex_batch &q)
+        {
+            return basic_complex_batch(simd::select(m, p.a, q.a),
+                                       simd::select(m, p.b, q.b));
+        }
+
+        /*  Copies lane n out as a scalar complex number.                     */
+        inline basic_complex<scalar> lane(unsigned int n) const
+        {
+            scalar da[width], db[width];
+            simd::store(da, a);
+            simd::store(db, b);
+            return basic_complex<scalar>(da[n], db[n]);
+        }
+    };
+    /*  End of basic_complex_batch struct.                                    */
+
+    /*  Batches of doubles and of floats.                                     */
+    typedef basic_complex_batch<simd::vec> complex_batch;
+    typedef basic_complex_batch<simd::vecf> complex_batchf;
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
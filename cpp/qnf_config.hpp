@@ -0,0 +1,230 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Reads render settings from JSON files, as command line flags.         *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_CONFIG_HPP
+#define QNF_CONFIG_HPP
+
+/*  snprintf and fprintf.                                                     */
+#include <cstdio>
+
+/*  strcmp, for spotting --config.                                            */
+#include <cstring>
+
+/*  The JSON reader.                                                          */
+#include "qnf_json.hpp"
+#include <string>
+#include <vector>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      arguments                                                         *
+     *  Purpose:                                                              *
+     *      The command line with every "--config file" replaced by the flags *
+     *      in the file, so that a program parses both the same way, and the  *
+     *      flags after --config override those from the file.                *
+     *  Notes:                                                                *
+     *      A config file is a JSON object. Each member "key": value becomes  *
+     *      the flag --key followed by the value. true gives the bare flag,   *
+     *      false and null give nothing, and an array gives its elements as   *
+     *      separate arguments:                                               *
+     *          {"size": [1920, 1080], "frames": 128, "no-symmetry": true}    *
+     *      is the same as --size 1920 1080 --frames 128 --no-symmetry. A     *
+     *      config file may name others with "config", up to max_depth deep.  *
+     **************************************************************************/
+    struct arguments {
+        std::vector<std::string> text;
+        std::vector<char *> pointers;
+
+        static inline unsigned int max_depth(void)
+        {
+            return 8U;
+        }
+
+        /*  Appends one argument for a number or a string. Returns false for  *
+         *  the other kinds.                                                  */
+        inline bool add(const json::value &v)
+        {
+            char number[32];
+
+            switch (v.kind)
+            {
+                case json::value::string_kind:
+                    text.push_back(v.text);
+                    return true;
+                case json::value::number_kind:
+                    std::snprintf(number, sizeof(number), "%.17g", v.number);
+                    text.push_back(number);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /*  Appends the flags of the config file "path".                      */
+        inline bool read(const char *path, unsigned int depth)
+        {
+            json::value doc;
+
+            if (depth >= max_depth())
+            {
+                std::fprintf(stderr, "%s: config files nested too deep.\n",
+                             path);
+                return false;
+            }
+
+            if (!json::read_file(path, &doc))
+                return false;
+
+            return add_members(doc, path, depth);
+        }
+
+        /*  Appends the flags of the object "doc", read from "path".          */
+        inline bool add_members(const json::value &doc, const char *path,
+                                unsigned int depth)
+        {
+            std::size_t n, m;
+            bool valid;
+
+            if (doc.kind != json::value::object_kind)
+            {
+                std::fprintf(stderr, "%s: expected a JSON object.\n", path);
+                return false;
+            }
+
+            for (n = 0U; n < doc.keys.size(); ++n)
+            {
+                const json::value &v = doc.items[n];
+                const std::string &key = doc.keys[n];
+
+                if (v.kind == json::value::null_kind ||
+                    (v.kind == json::value::bool_kind && !v.boolean))
+                    continue;
+
+                if (key == "config")
+                {
+                    if (v.kind != json::value::string_kind ||
+                        !read(v.text.c_str(), depth + 1U))
+                        return false;
+
+                    continue;
+                }
+
+                text.push_back("--" + key);
+
+                if (v.kind == json::value::bool_kind)
+                    continue;
+
+                if (v.kind == json::value::array_kind)
+                {
+                    valid = true;
+
+                    for (m = 0U; m < v.items.size() && valid; ++m)
+                        valid = add(v.items[m]);
+                }
+                else
+                    valid = add(v);
+
+                if (!valid)
+                {
+                    std::fprintf(stderr, "%s: \"%s\" may only hold numbers "
+                                 "and strings.\n", path, key.c_str());
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /*  Builds the expanded command line from argc and argv. Prints why   *
+         *  and returns false if a config file could not be read.             */
+        inline bool expand(int argc, char **argv)
+        {
+            int arg;
+
+            text.clear();
+            pointers.clear();
+
+            for (arg = 0; arg < argc; ++arg)
+            {
+                if (arg > 0 && !std::strcmp(argv[arg], "--config") &&
+                    arg + 1 < argc)
+                {
+                    if (!read(argv[++arg], 0U))
+                        return false;
+                }
+                else
+                    text.push_back(argv[arg]);
+            }
+
+            point();
+            return true;
+        }
+
+        /*  Builds a command line from the object "doc", e.g. a job of a      *
+         *  batch read from "path", with "program" as argv[0].                */
+        inline bool expand(const char *program, const json::value &doc,
+                           const char *path)
+        {
+            text.assign(1U, program);
+            pointers.clear();
+
+            if (!add_members(doc, path, 0U))
+                return false;
+
+            point();
+            return true;
+        }
+
+        /*  Sets up argv. Only now, text does not move any more.              */
+        inline void point(void)
+        {
+            std::size_t n;
+
+            for (n = 0U; n < text.size(); ++n)
+                pointers.push_back(&text[n][0]);
+
+            pointers.push_back(0);
+        }
+
+        inline int argc(void) const
+        {
+            return static_cast<int>(pointers.size()) - 1;
+        }
+
+        inline char **argv(void)
+        {
+            return &pointers[0];
+        }
+    };
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,148 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the instruction set levels the tile kernels are compiled     *
+ *      for, and picks the best one the processor supports at run time.       *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_CPU_HPP
+#define QNF_CPU_HPP
+
+/*  strcmp, for parsing the names of the levels.                              */
+#include <cstring>
+
+/*  GCC and clang on x86 can compile single functions for a newer instruction *
+ *  set than the rest of the program with the target attribute, and check     *
+ *  the processor with __builtin_cpu_supports. Elsewhere only the baseline    *
+ *  the compiler targets is available.                                        */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define QNF_ISA_DISPATCH
+
+/*  flatten inlines the whole call tree, the Newton step and the quaternion   *
+ *  arithmetic, into the marked function, so all of it is compiled for the    *
+ *  marked instruction set and not just the outer loop. This is also what     *
+ *  lets the function use the registers of its level's back end in            *
+ *  qnf_simd.hpp, which must not be passed to unmarked code. Only mark the    *
+ *  Newton loops: every copy is compiled for every polynomial and method, and *
+ *  a flattened tile, coloring and telemetry included, takes many times       *
+ *  longer to build than the rest of the program.                             */
+#define QNF_TARGET_AVX2 \
+__attribute__((target("avx2,fma"), flatten))
+
+#define QNF_TARGET_AVX512 \
+__attribute__((target("avx512f"), flatten))
+#endif
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  The instruction set levels, from oldest to newest. isa_baseline is    *
+     *  whatever the compiler was told to target, e.g. plain x86-64 if no     *
+     *  -march flag was given. Each level runs the back end of qnf_simd.hpp   *
+     *  made for it, 4 lanes of doubles in ymm registers for AVX2 and 8 in    *
+     *  zmm registers for AVX-512.                                            */
+    enum isa_level {
+        isa_baseline,
+        isa_avx2,
+        isa_avx512
+    };
+
+    /*  True if the processor can run the kernels compiled for "level".       */
+    inline bool isa_supported(isa_level level)
+    {
+#ifdef QNF_ISA_DISPATCH
+        __builtin_cpu_init();
+
+        switch (level)
+        {
+            case isa_avx2:
+                return __builtin_cpu_supports("avx2") &&
+                       __builtin_cpu_supports("fma");
+
+            case isa_avx512:
+                return __builtin_cpu_supports("avx512f");
+
+            default:
+                return true;
+        }
+#else
+        return level == isa_baseline;
+#endif
+    }
+
+    /*  The newest level the processor supports.                              */
+    inline isa_level detect_isa(void)
+    {
+        if (isa_supported(isa_avx512))
+            return isa_avx512;
+
+        if (isa_supported(isa_avx2))
+            return isa_avx2;
+
+        return isa_baseline;
+    }
+
+    /*  Name of a level, as accepted by parse_isa.                            */
+    inline const char *isa_name(isa_level level)
+    {
+        switch (level)
+        {
+            case isa_avx2:
+                return "avx2";
+
+            case isa_avx512:
+                return "avx512";
+
+            default:
+                return "baseline";
+        }
+    }
+
+    /*  Reads a level from its name. "auto" is detect_isa(). Returns false    *
+     *  for unknown names.                                                    */
+    inline bool parse_isa(const char *name, isa_level *level)
+    {
+        if (!std::strcmp(name, "auto"))
+            *level = detect_isa();
+
+        else if (!std::strcmp(name, "avx2"))
+            *level = isa_avx2;
+
+        else if (!std::strcmp(name, "avx512"))
+            *level = isa_avx512;
+
+        else if (!std::strcmp(name, "baseline"))
+            *level = isa_baseline;
+
+        else
+            return false;
+
+        return true;
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
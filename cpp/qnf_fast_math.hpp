@@ -0,0 +1,113 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides polynomial approximations of elementary functions for the    *
+ *      coloring, accurate to well below one color level.                     *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_FAST_MATH_HPP
+#define QNF_FAST_MATH_HPP
+
+/*  Multiples of pi, for moving atan back out of the first octant.            */
+#include "qnf_pi.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      fast_atan                                                         *
+     *  Purpose:                                                              *
+     *      Computes atan(x) for 0 <= x <= 1.                                 *
+     *  Arguments:                                                            *
+     *      x (double):                                                       *
+     *          A real number in [0, 1].                                      *
+     *  Output:                                                               *
+     *      atan_x (double):                                                  *
+     *          The arctangent of x.                                          *
+     *  Method:                                                               *
+     *      Odd polynomial of degree 15, fitted to atan on [0, 1] by          *
+     *      iteratively reweighted least squares (Lawson's algorithm), which  *
+     *      approaches the minimax polynomial. Evaluated by Horner's method   *
+     *      in x^2.                                                           *
+     *  Error:                                                                *
+     *      |fast_atan(x) - atan(x)| < 4E-8 on [0, 1], measured on 2E5 evenly *
+     *      spaced points. One color level is about 4E-3 radians.             *
+     **************************************************************************/
+    inline double fast_atan(double x)
+    {
+        const double x2 = x*x;
+        return x * (0.9999993364053561 +
+               x2 * (-0.3332986363626077 +
+               x2 * (0.19946594607993176 +
+               x2 * (-0.13908760773491488 +
+               x2 * (0.09642505299949888 +
+               x2 * (-0.05591622330681206 +
+               x2 * (0.02186548138388471 +
+               x2 * -0.004055223570574237)))))));
+    }
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      fast_atan2                                                        *
+     *  Purpose:                                                              *
+     *      Computes the angle of the point (x, y), like std::atan2.          *
+     *  Arguments:                                                            *
+     *      y (double):                                                       *
+     *          The vertical component.                                       *
+     *      x (double):                                                       *
+     *          The horizontal component.                                     *
+     *  Output:                                                               *
+     *      theta (double):                                                   *
+     *          The angle in [-pi, pi], with the same error as fast_atan.     *
+     *  Method:                                                               *
+     *      Reduce to the first octant by taking min(|x|, |y|) / max(|x|, |y|)*
+     *      and undo the reduction with the identities                        *
+     *          atan(1/t) = pi/2 - atan(t),                                   *
+     *          atan2(y, -x) = pi - atan2(y, x),                              *
+     *          atan2(-y, x) = -atan2(y, x).                                  *
+     *      Each step is a select, not a branch, so a loop over pixels can be *
+     *      vectorized.                                                       *
+     *  Notes:                                                                *
+     *      The signs of zeros are treated as positive: (0, +-0) gives 0 and  *
+     *      (-1, +-0) gives +pi. The colorers turn -0 into +0 before calling. *
+     **************************************************************************/
+    inline double fast_atan2(double y, double x)
+    {
+        const double ax = (x < 0.0 ? -x : x);
+        const double ay = (y < 0.0 ? -y : y);
+        const double hi = (ax < ay ? ay : ax);
+        const double lo = (ax < ay ? ax : ay);
+        const double t = (hi > 0.0 ? lo / hi : 0.0);
+        double r = fast_atan(t);
+
+        r = (ax < ay ? HALF_PI - r : r);
+        r = (x < 0.0 ? ONE_PI - r : r);
+        return (y < 0.0 ? -r : r);
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,507 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a small JSON writer and reader, for results that other       *
+ *      programs read and for reading them back.                              *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_JSON_HPP
+#define QNF_JSON_HPP
+
+/*  fprintf, fputc and friends, and strtod.                                   */
+#include <cstdio>
+#include <cstdlib>
+
+/*  strcmp, for looking keys up.                                              */
+#include <cstring>
+
+/*  isfinite, JSON has no NaN or infinity.                                    */
+#include <cmath>
+#include <string>
+#include <vector>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Another namespace to avoid name conflicts with these helpers.         */
+    namespace json {
+
+        /**********************************************************************
+         *  Struct:                                                           *
+         *      writer                                                        *
+         *  Purpose:                                                          *
+         *      Writes a JSON document to a FILE pointer as it is built,      *
+         *      taking care of the commas. Objects and arrays opened with     *
+         *      "lines" set put each member on a line of its own, the others  *
+         *      stay on one line, so a document can be a readable table or a  *
+         *      single line of a JSON lines file.                             *
+         *  Notes:                                                            *
+         *      Keys are passed inside objects and null inside arrays. NaN    *
+         *      and infinite numbers are written as null.                     *
+         **********************************************************************/
+        struct writer {
+            FILE *fp;
+
+            /*  One entry per open object or array: whether it has members    *
+             *  yet, and whether they go on lines of their own.               */
+            std::vector<bool> empty, lines;
+
+            writer(FILE *out) : fp(out)
+            {
+                return;
+            }
+
+            /*  Writes the comma, line break and key that go before a value.  */
+            inline void member(const char *key)
+            {
+                if (!empty.empty())
+                {
+                    if (!empty.back())
+                        std::fputc(',', fp);
+
+                    if (lines.back())
+                        std::fprintf(fp, "\n%*s", 2 * int(lines.size()), "");
+                    else if (!empty.back())
+                        std::fputc(' ', fp);
+
+                    empty.back() = false;
+                }
+
+                if (key)
+                {
+                    string(key);
+                    std::fputs(": ", fp);
+                }
+            }
+
+            /*  A quoted string with ", \ and control characters escaped.     */
+            inline void string(const char *s)
+            {
+                std::fputc('"', fp);
+
+                for (; *s; ++s)
+                {
+                    const unsigned char c = static_cast<unsigned char>(*s);
+
+                    if (c == '"' || c == '\\')
+                        std::fprintf(fp, "\\%c", c);
+                    else if (c < 0x20U)
+                        std::fprintf(fp, "\\u%04x", c);
+                    else
+                        std::fputc(c, fp);
+                }
+
+                std::fputc('"', fp);
+            }
+
+            inline void begin_object(const char *key = 0, bool on_lines = false)
+            {
+                member(key);
+                std::fputc('{', fp);
+                empty.push_back(true);
+                lines.push_back(on_lines);
+            }
+
+            inline void begin_array(const char *key = 0, bool on_lines = false)
+            {
+                member(key);
+                std::fputc('[', fp);
+                empty.push_back(true);
+                lines.push_back(on_lines);
+            }
+
+            /*  Closes the innermost object or array.                         */
+            inline void end(char bracket)
+            {
+                const bool broken = lines.back() && !empty.back();
+                empty.pop_back();
+                lines.pop_back();
+
+                if (broken)
+                    std::fprintf(fp, "\n%*s", 2 * int(lines.size()), "");
+
+                std::fputc(bracket, fp);
+            }
+
+            inline void end_object(void)
+            {
+                end('}');
+            }
+
+            inline void end_array(void)
+            {
+                end(']');
+            }
+
+            inline void field(const char *key, const char *s)
+            {
+                member(key);
+                string(s);
+            }
+
+            inline void field(const char *key, double x)
+            {
+                member(key);
+
+                if (std::isfinite(x))
+                    std::fprintf(fp, "%.9g", x);
+                else
+                    std::fputs("null", fp);
+            }
+
+            inline void field(const char *key, unsigned long int n)
+            {
+                member(key);
+                std::fprintf(fp, "%lu", n);
+            }
+
+            inline void field(const char *key, unsigned int n)
+            {
+                field(key, static_cast<unsigned long int>(n));
+            }
+
+            inline void field(const char *key, bool b)
+            {
+                member(key);
+                std::fputs(b ? "true" : "false", fp);
+            }
+        };
+
+        /*  A parsed JSON value. Objects keep their keys in order, in "keys", *
+         *  parallel to the values in "items".                                */
+        struct value {
+            enum kind_type {
+                null_kind, bool_kind, number_kind,
+                string_kind, array_kind, object_kind
+            };
+
+            kind_type kind;
+            bool boolean;
+            double number;
+            std::string text;
+            std::vector<std::string> keys;
+            std::vector<value> items;
+
+            value(void) : kind(null_kind), boolean(false), number(0.0)
+            {
+                return;
+            }
+
+            /*  The member "key" of an object, or null if there is none.      */
+            inline const value *find(const char *key) const
+            {
+                std::size_t n;
+
+                for (n = 0U; n < keys.size(); ++n)
+                    if (!std::strcmp(keys[n].c_str(), key))
+                        return &items[n];
+
+                return 0;
+            }
+        };
+
+        /*  Recursive descent over a nul-terminated string. Holds the line    *
+         *  for error messages.                                               */
+        struct parser {
+            const char *s;
+            unsigned int line;
+
+            parser(const char *text) : s(text), line(1U)
+            {
+                return;
+            }
+
+            inline void skip_space(void)
+            {
+                while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n')
+                {
+                    if (*s == '\n')
+                        ++line;
+
+                    ++s;
+                }
+            }
+
+            /*  Consumes "word" if the text continues with it.                */
+            inline bool literal(const char *word)
+            {
+                const std::size_t n = std::strlen(word);
+
+                if (std::strncmp(s, word, n))
+                    return false;
+
+                s += n;
+                return true;
+            }
+
+            /*  A string after its opening quote. \u escapes are kept only    *
+             *  for ASCII, which is all this project writes.                  */
+            inline bool parse_string(std::string *out)
+            {
+                out->clear();
+
+                while (*s && *s != '"')
+                {
+                    char c = *s++;
+
+                    if (c == '\\')
+                    {
+                        c = *s++;
+
+                        switch (c)
+                        {
+                            case 'n':
+                                c = '\n';
+                                break;
+                            case 't':
+                                c = '\t';
+                                break;
+                            case 'r':
+                                c = '\r';
+                                break;
+                            case 'b':
+                                c = '\b';
+                                break;
+                            case 'f':
+                                c = '\f';
+                                break;
+                            case 'u':
+                            {
+                                char hex[5] = {0, 0, 0, 0, 0};
+                                unsigned int n;
+
+                                for (n = 0U; n < 4U && *s; ++n)
+                                    hex[n] = *s++;
+
+                                c = static_cast<char>(
+                                    std::strtoul(hex, 0, 16) & 0x7FUL
+                                );
+                                break;
+                            }
+                            case '\0':
+                                return false;
+                            default:
+                                break;
+                        }
+                    }
+
+                    out->push_back(c);
+                }
+
+                if (*s != '"')
+                    return false;
+
+                ++s;
+                return true;
+            }
+
+            inline bool parse(value *v)
+            {
+                skip_space();
+
+                if (*s == '{')
+                {
+                    ++s;
+                    v->kind = value::object_kind;
+                    skip_space();
+
+                    if (*s == '}')
+                    {
+                        ++s;
+                        return true;
+                    }
+
+                    for (;;)
+                    {
+                        std::string key;
+                        skip_space();
+
+                        if (*s++ != '"' || !parse_string(&key))
+                            return false;
+
+                        skip_space();
+
+                        if (*s++ != ':')
+                            return false;
+
+                        v->keys.push_back(key);
+                        v->items.push_back(value());
+
+                        if (!parse(&v->items.back()))
+                            return false;
+
+                        skip_space();
+
+                        if (*s == '}')
+                        {
+                            ++s;
+                            return true;
+                        }
+
+                        if (*s++ != ',')
+                            return false;
+                    }
+                }
+
+                if (*s == '[')
+                {
+                    ++s;
+                    v->kind = value::array_kind;
+                    skip_space();
+
+                    if (*s == ']')
+                    {
+                        ++s;
+                        return true;
+                    }
+
+                    for (;;)
+                    {
+                        v->items.push_back(value());
+
+                        if (!parse(&v->items.back()))
+                            return false;
+
+                        skip_space();
+
+                        if (*s == ']')
+                        {
+                            ++s;
+                            return true;
+                        }
+
+                        if (*s++ != ',')
+                            return false;
+                    }
+                }
+
+                if (*s == '"')
+                {
+                    ++s;
+                    v->kind = value::string_kind;
+                    return parse_string(&v->text);
+                }
+
+                if (literal("true"))
+                {
+                    v->kind = value::bool_kind;
+                    v->boolean = true;
+                    return true;
+                }
+
+                if (literal("false"))
+                {
+                    v->kind = value::bool_kind;
+                    v->boolean = false;
+                    return true;
+                }
+
+                if (literal("null"))
+                {
+                    v->kind = value::null_kind;
+                    return true;
+                }
+
+                {
+                    char *end;
+                    v->number = std::strtod(s, &end);
+
+                    if (end == s)
+                        return false;
+
+                    v->kind = value::number_kind;
+                    s = end;
+                    return true;
+                }
+            }
+        };
+
+        /**********************************************************************
+         *  Function:                                                         *
+         *      parse                                                         *
+         *  Purpose:                                                          *
+         *      Parses a JSON document.                                       *
+         *  Arguments:                                                        *
+         *      text (const char *):                                          *
+         *          The document, nul-terminated.                             *
+         *      out (value *):                                                *
+         *          The parsed value.                                         *
+         *      error_line (unsigned int *):                                  *
+         *          If not null, the line the parser stopped at on failure.   *
+         *  Output:                                                           *
+         *      success (bool):                                               *
+         *          False if the text is not a single JSON value.             *
+         **********************************************************************/
+        inline bool parse(const char *text, value *out,
+                          unsigned int *error_line = 0)
+        {
+            parser p(text);
+            bool success;
+
+            *out = value();
+            success = p.parse(out);
+            p.skip_space();
+            success = success && (*p.s == '\0');
+
+            if (!success && error_line)
+                *error_line = p.line;
+
+            return success;
+        }
+
+        /*  Reads and parses the file "path". Prints why it failed if it does.*/
+        inline bool read_file(const char *path, value *out)
+        {
+            FILE *fp = std::fopen(path, "rb");
+            std::string text;
+            char buffer[4096];
+            std::size_t n;
+            unsigned int line;
+
+            if (!fp)
+            {
+                std::fprintf(stderr, "Could not open %s.\n", path);
+                return false;
+            }
+
+            while ((n = std::fread(buffer, 1U, sizeof(buffer), fp)) > 0U)
+                text.append(buffer, n);
+
+            std::fclose(fp);
+
+            if (!parse(text.c_str(), out, &line))
+            {
+                std::fprintf(stderr, "%s:%u: not valid JSON.\n", path, line);
+                return false;
+            }
+
+            return true;
+        }
+    }
+    /*  End of namespace "json".                                              */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
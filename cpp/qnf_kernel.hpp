@@ -0,0 +1,1552 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the tile kernels, which run Newton's method for every pixel  *
+ *      of a tile and color the results.                                      *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_KERNEL_HPP
+#define QNF_KERNEL_HPP
+
+/*  HUGE_VAL, passed to the colorer for points that do not converge.          */
+#include <cmath>
+
+/*  memcpy and memcmp, for copying and comparing pixels.                      */
+#include <cstring>
+#include <vector>
+
+/*  std::min and std::max.                                                    */
+#include <algorithm>
+
+/*  The counters of orbit_stats, and the largest float and double.            */
+#include <atomic>
+#include <limits>
+
+/*  std::integral_constant, used to pick the kernel at compile time.          */
+#include <type_traits>
+
+/*  Number types, single and batched.                                         */
+#include "qnf_quaternion.hpp"
+#include "qnf_quaternion_batch.hpp"
+#include "qnf_complex.hpp"
+
+/*  Tiles, frame buffers, the view, the basin table, the root balls, and      *
+ *  conjugate_by_j.                                                           */
+#include "qnf_thread_pool.hpp"
+#include "qnf_ppm.hpp"
+#include "qnf_view.hpp"
+#include "qnf_basin_table.hpp"
+#include "qnf_root_ball.hpp"
+#include "qnf_symmetry.hpp"
+
+/*  The instruction set levels operator () dispatches between.                */
+#include "qnf_cpu.hpp"
+
+/*  Per-pixel result files.                                                   */
+#include "qnf_result.hpp"
+
+/*  Per-frame counts of the pixels.                                           */
+#include "qnf_telemetry.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  How tiles are split before iterating, see kernel::tile_subdivide.     */
+    enum subdivision {
+        subdivide_none,
+        subdivide_color,
+        subdivide_fast
+    };
+
+    /*  The precision Newton's method runs in, see kernel::tile_single.       */
+    enum precision_mode {
+        precision_double,
+        precision_single,
+        precision_mixed
+    };
+
+    /*  True for batches of complex doubles, whatever the back end, the only  *
+     *  batches kernel::iterate finishes in the root balls.                   */
+    template <class Batch>
+    struct has_balls : std::false_type {};
+
+    template <class V>
+    struct has_balls< basic_complex_batch<V> >
+        : std::is_same<typename simd::traits<V>::scalar, double> {};
+
+    /*  Orbits Newton's method gave up on before max_iters. Kernels running   *
+     *  at the same time add to the same counters.                            */
+    struct orbit_stats {
+
+        /*  Orbits that came back to within a hair of an earlier point, a     *
+         *  cycle or a fixed point that is not a root.                        */
+        std::atomic<unsigned long int> cycling;
+
+        /*  Orbits too far out to come back in the steps left, or that        *
+         *  overflowed after dividing by a derivative near zero.              */
+        std::atomic<unsigned long int> escaping;
+
+        /*  Newton steps the two saved, up to max_iters for each orbit.       */
+        std::atomic<unsigned long int> steps_saved;
+
+        /*  Orbits that converged, and were finished the moment they entered *
+         *  one of the root balls.                                            */
+        std::atomic<unsigned long int> in_ball;
+
+        orbit_stats(void)
+            : cycling(0UL), escaping(0UL), steps_saved(0UL), in_ball(0UL)
+        {
+            return;
+        }
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      kernel                                                            *
+     *  Purpose:                                                              *
+     *      Renders tiles of a frame for the polynomial Poly, colored by      *
+     *      Colorer. Both are template parameters, so eval, step and the      *
+     *      coloring are inlined into the loops and each combination gets     *
+     *      its own specialized code.                                         *
+     *      Poly and Colorer work on doubles. Poly is also run on floats in   *
+     *      the single and mixed precision kernels.                           *
+     *  Method:                                                               *
+     *      Newton's method stops once |p(q)|^2 < eps_sq, and also gives up   *
+     *      early on orbits that cannot converge any more, which otherwise    *
+     *      take all max_iters steps:                                         *
+     *          Cycles. As in Brent's algorithm, the point after 2^m steps    *
+     *          is kept, and the orbit stops once it comes back to within     *
+     *          cycle_factor * eps of it. Detects any cycle, or fixed point   *
+     *          that is not a root, a few periods after the orbit falls in.   *
+     *          Newton's method steps by p(q) / p'(q) and eps bounds p(q), so *
+     *          an orbit near a simple root has converged first.              *
+     *          Escapes. Far from the roots a step shrinks q by about         *
+     *          (d - 1) / d, d the degree, so an orbit with                   *
+     *              |q|^2 > escape_sq ((d - 1) / d)^(-2n)                     *
+     *          cannot get back to |q|^2 < escape_sq in the n steps it has    *
+     *          left. This also catches infinities and NaN, from dividing by  *
+     *          a derivative at or near zero. The other methods of            *
+     *          qnf_method.hpp shrink q by Poly::far_ratio() instead.         *
+     *      Both are checked every fourth step, and end black, like the orbit *
+     *      would have after max_iters, so the frames do not change.          *
+     *      With real coefficients the complex orbits also stop as soon as    *
+     *      they enter one of the root_balls with enough steps left, and end  *
+     *      at the root itself. The colorers only look at the direction of    *
+     *      the imaginary part, which is the same for the root and a point    *
+     *      that converged to it, so this does not change the frames either.  *
+     *  Notes:                                                                *
+     *      Poly may also be one of the methods of qnf_method.hpp, a          *
+     *      polynomial with another step. Only Newton's method gets balls.    *
+     *      The complex-slice and table kernels only exist for polynomials    *
+     *      with real coefficients. They are never instantiated for the       *
+     *      others, which need not support complex arithmetic.                *
+     **************************************************************************/
+    template <class Poly, class Colorer>
+    struct kernel {
+        Colorer colorer;
+        double eps_sq;
+        unsigned int max_iters;
+
+        /*  Basin table to look pixels up in, or null to iterate them all.    */
+        const basin_table<Poly> *table;
+
+        /*  Discs about the roots to finish complex orbits in, or null.       */
+        const root_balls<Poly> *balls;
+
+        /*  If set, each pixel is also colored for conjugate_by_j of its      *
+         *  final point and stored here. See qnf::frame_symmetry.             */
+        framebuffer *mirror;
+
+        /*  Render tiles by Mariani-Silver subdivision, see tile_subdivide.   */
+        subdivision subdivide;
+
+        /*  The instruction set the tiles are rendered with. Defaults to the  *
+         *  newest one the processor supports.                                */
+        isa_level isa;
+
+        /*  Run Newton's method in double, in single precision, or in single  *
+         *  precision with the doubtful pixels run again in double.           */
+        precision_mode precision;
+
+        /*  The tolerance of the single precision iteration. Rounding p(q) to *
+         *  a float leaves an error of about 1E-7 |q|^3, so residuals much    *
+         *  below 1E-12 are noise. The rest is left to the polish in double.  */
+        double single_eps_sq;
+
+        /*  If set, the end of every orbit is also stored here, see           *
+         *  qnf::pixel_result. The tile kernels then count the Newton steps   *
+         *  of each pixel, which they skip otherwise.                         */
+        result_file *results;
+
+        /*  Stop orbits that cycle or escape, see Method above. Only turned   *
+         *  off to check that it does not change the frames.                  */
+        bool stop_early;
+
+        /*  If set, the orbits stopped early are counted here.                */
+        orbit_stats *stats;
+
+        /*  If set, every pixel colored is counted here, and the colorer is   *
+         *  timed on a sample of them. The Newton steps are then counted as   *
+         *  for results.                                                      */
+        frame_counters *telemetry;
+
+        /*  An orbit has cycled once it is within cycle_factor * tol_sq (the  *
+         *  squares of the distances) of the point kept, see Method above.    */
+        static inline double cycle_factor(void)
+        {
+            return 1.0E-4;
+        }
+
+        /*  |q|^2 beyond which an orbit is far from every root. Generous, the *
+         *  roots of the polynomials here have |q| <= 2.                      */
+        static inline double escape_sq(void)
+        {
+            return 1.0E4;
+        }
+
+        /*  A lower bound for |N(q)|^2 / |q|^2 with |q|^2 > escape_sq, N the  *
+         *  step. Poly::far_ratio()^2, ((d - 1) / d)^2 for Newton's method,   *
+         *  up to terms in 1 / |q|^2, with a 2% margin for those.             */
+        static inline double contraction(void)
+        {
+            const double ratio = Poly::far_ratio();
+            return 0.98 * ratio * ratio;
+        }
+
+        /*  escape_sq / contraction()^n for n = 0 to max_iters, the |q|^2     *
+         *  above which an orbit with n steps to go cannot converge any more. *
+         *  Tabulated, since pow in the loops doubled the time of a frame.    */
+        std::vector<double> escape_limits;
+
+        /*  The entry of escape_limits for "left" steps to go, capped at the  *
+         *  largest Scalar so that overflows are caught too.                  */
+        template <class Scalar>
+        inline Scalar escape_limit(unsigned int left) const
+        {
+            const double cap = std::numeric_limits<Scalar>::max();
+            const double limit =
+                (left < escape_limits.size() ? escape_limits[left]
+                    : escape_sq() * std::pow(contraction(), -double(left)));
+            return static_cast<Scalar>(limit < cap ? limit : cap);
+        }
+
+        kernel(const Colorer &c, double eps_sq_in, unsigned int max_iters_in,
+               const basin_table<Poly> *table_in = 0)
+            : colorer(c), eps_sq(eps_sq_in), max_iters(max_iters_in),
+              table(table_in), balls(0), mirror(0), subdivide(subdivide_none),
+              isa(detect_isa()), precision(precision_double),
+              single_eps_sq(std::max(eps_sq_in, 1.0E-10)), results(0),
+              stop_early(true), stats(0), telemetry(0),
+              escape_limits(max_iters_in + 1U)
+        {
+            unsigned int n;
+
+            for (n = 0U; n <= max_iters; ++n)
+                escape_limits[n] =
+                    escape_sq() * std::pow(contraction(), -double(n));
+        }
+
+        /*  Colors the pixel (x, y) from the final point q and |p(q)|^2,      *
+         *  reached after "steps" Newton steps.                               */
+        inline void put(framebuffer &fb, unsigned int x, unsigned int y,
+                        const quaternion &q, double p_norm_sq,
+                        unsigned int steps) const
+        {
+            if (telemetry)
+                put_counted(fb, x, y, q, p_norm_sq, steps);
+            else
+                put_pixel(fb, x, y, q, p_norm_sq, steps);
+        }
+
+        /*  put, with the pixel counted and the colorer timed if sampled.     */
+        inline void put_counted(framebuffer &fb, unsigned int x,
+                                unsigned int y, const quaternion &q,
+                                double p_norm_sq, unsigned int steps) const
+        {
+            typedef std::chrono::steady_clock clock;
+
+            if (frame_counters::sampled(x, y))
+            {
+                const clock::time_point start = clock::now();
+                put_pixel(fb, x, y, q, p_norm_sq, steps);
+
+                const std::chrono::duration<double> elapsed =
+                    clock::now() - start;
+
+                /*  A thread preempted in between would count its time off    *
+                 *  the processor, 256 times over.                            */
+                if (elapsed.count() < frame_counters::max_sample())
+                {
+                    pixel_counts &c = telemetry->local();
+                    c.color_seconds += elapsed.count();
+                    ++c.color_samples;
+                }
+            }
+            else
+                put_pixel(fb, x, y, q, p_norm_sq, steps);
+
+            telemetry->count(q, p_norm_sq, steps);
+        }
+
+        inline void put_pixel(framebuffer &fb, unsigned int x, unsigned int y,
+                              const quaternion &q, double p_norm_sq,
+                              unsigned int steps) const
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+            colorer(q, p_norm_sq).write(fb, x, y);
+
+            if (mirror)
+                colorer(conjugate_by_j(q), p_norm_sq).write(*mirror, x, y);
+
+            if (results)
+                results->at(x, y).set(q, p_norm_sq, steps,
+                                      result_root(q, p_norm_sq, real()));
+        }
+
+        /*  The root index of a pixel_result. With real coefficients the      *
+         *  final point x + yn lies on the sphere of roots through x + |y|i.  */
+        inline unsigned int
+        result_root(const quaternion &q, double p_norm_sq,
+                    std::true_type) const
+        {
+            const double y_sq = q.dat[1]*q.dat[1] + q.dat[2]*q.dat[2] +
+                                q.dat[3]*q.dat[3];
+            const complex z(q.dat[0], std::sqrt(y_sq));
+
+            if (!(p_norm_sq < eps_sq))
+                return 0U;
+
+            return nearest_root<Poly>(z) + 1U;
+        }
+
+        /*  Without real coefficients the roots are not known.                */
+        inline unsigned int
+        result_root(const quaternion &, double p_norm_sq, std::false_type) const
+        {
+            return (p_norm_sq < eps_sq ? unsigned(pixel_result::unknown_root)
+                                       : 0U);
+        }
+
+        /*  Adds the per-lane counts of newton_batch to *stats.               */
+        template <class V>
+        inline void add_stats(const V &cycling, const V &escaping,
+                              const V &saved, const V &in_ball) const
+        {
+            typedef typename simd::traits<V>::scalar scalar;
+            scalar c[V::width], e[V::width], s[V::width], b[V::width];
+            unsigned long int n_cycling = 0UL, n_escaping = 0UL, n_saved = 0UL;
+            unsigned long int n_ball = 0UL;
+            unsigned int n;
+
+            simd::store(c, cycling);
+            simd::store(e, escaping);
+            simd::store(s, saved);
+            simd::store(b, in_ball);
+
+            for (n = 0U; n < V::width; ++n)
+            {
+                n_cycling += static_cast<unsigned long int>(c[n]);
+                n_escaping += static_cast<unsigned long int>(e[n]);
+                n_saved += static_cast<unsigned long int>(s[n]);
+                n_ball += static_cast<unsigned long int>(b[n]);
+            }
+
+            if (n_ball > 0UL)
+                stats->in_ball += n_ball;
+
+            /*  Most batches converge, skip the atomics for them.             */
+            if (n_cycling + n_escaping == 0UL)
+                return;
+
+            stats->cycling += n_cycling;
+            stats->escaping += n_escaping;
+            stats->steps_saved += n_saved;
+        }
+
+        /*  The array to count Newton steps in, or null if neither results    *
+         *  nor telemetry are kept and the counting can be skipped.           */
+        inline unsigned int *counting(unsigned int *steps) const
+        {
+            return (results || telemetry ? steps : 0);
+        }
+
+        /*  Runs Newton's method from a single point, for any number type.    *
+         *  The powers of q computed for p(q) are reused by the next step.    *
+         *  The number of steps taken goes to *steps if it is not null.       */
+        template <class Number>
+        inline Number iterate(Number q, double *p_norm_sq,
+                              unsigned int *steps = 0) const
+        {
+            const double cycle_sq = cycle_factor() * eps_sq;
+            typename Poly::template powers<Number> w;
+            Number p = Poly::eval(q, &w);
+            Number kept = q;
+            unsigned int iters;
+
+            for (iters = 0U; iters < max_iters; ++iters)
+            {
+                if (p.norm_sq() < eps_sq)
+                    break;
+
+                q = Poly::step(q, w);
+                p = Poly::eval(q, &w);
+
+                /*  Entered a root ball: q becomes the root and p zero.       */
+                if (!(p.norm_sq() < eps_sq))
+                    ball_step(q, p, max_iters - iters - 1U);
+
+                /*  Cycled, or too far out to come back in the steps left,    *
+                 *  checked every fourth step as in newton_batch.             */
+                if (stop_early && (iters & 3U) == 3U &&
+                    !(p.norm_sq() < eps_sq))
+                {
+                    const unsigned int left = max_iters - iters - 1U;
+                    const bool cycled = (q - kept).norm_sq() < cycle_sq;
+
+                    if (cycled || !(q.norm_sq() < escape_limit<double>(left)))
+                    {
+                        if (stats && left > 0U)
+                        {
+                            (cycled ? stats->cycling : stats->escaping)++;
+                            stats->steps_saved += left;
+                        }
+
+                        ++iters;
+                        break;
+                    }
+                }
+
+                /*  Keep the points after 1, 2, 4, 8, ... steps.              */
+                if ((iters & (iters + 1U)) == 0U)
+                    kept = q;
+            }
+
+            if (steps)
+                *steps = iters;
+
+            *p_norm_sq = p.norm_sq();
+            return q;
+        }
+
+        /*  If the complex orbit z has entered one of the root balls with at  *
+         *  least balls->steps steps left, sets z to the root and p to 0.     */
+        inline void ball_step(complex &z, complex &p, unsigned int left) const
+        {
+            if (!balls || left < balls->steps ||
+                !(p.norm_sq() < balls->residual_sq))
+                return;
+
+            z = balls->nearest(z);
+            p = complex(0.0, 0.0);
+
+            if (stats)
+                stats->in_ball++;
+        }
+
+        /*  Same for the lanes of a batch that have not stopped, given their  *
+         *  residuals r. These are marked done, and 1 is returned in them for *
+         *  ball_finish to move them onto their roots after the loop. Only    *
+         *  complex batches of doubles have balls, see has_balls.             */
+        template <class Batch>
+        inline typename Batch::vec_type
+        ball_step(const Batch &, const typename Batch::vec_type &r,
+                  typename Batch::mask_type &done, unsigned int left) const
+        {
+            return ball_lanes(r, done, left, has_balls<Batch>());
+        }
+
+        template <class V, class Mask>
+        inline V ball_lanes(const V &r, Mask &done, unsigned int left,
+                            std::true_type) const
+        {
+            const V zero(0.0), one(1.0);
+            V entered;
+            Mask in;
+
+            if (!balls || left < balls->steps)
+                return zero;
+
+            in = simd::less(r, V(balls->residual_sq));
+            entered = simd::select(done, zero, simd::select(in, one, zero));
+            done = done | in;
+            return entered;
+        }
+
+        /*  Quaternions, and orbits in single precision, have no balls.       */
+        template <class V, class Mask>
+        inline V ball_lanes(const V &, Mask &, unsigned int,
+                            std::false_type) const
+        {
+            return V(0.0F);
+        }
+
+        /*  Sets the lanes of z with entered = 1 to their roots, and p to 0.  */
+        template <class Batch>
+        inline void ball_finish(Batch &z, Batch &p,
+                                const typename Batch::vec_type &entered) const
+        {
+            ball_finish(z, p, entered, has_balls<Batch>());
+        }
+
+        template <class Batch, class V>
+        inline void ball_finish(Batch &z, Batch &p, const V &entered,
+                                std::true_type) const
+        {
+            const unsigned int width = Batch::width;
+            double flag[width], a[width], b[width], pa[width], pb[width];
+            unsigned int n;
+
+            if (!balls)
+                return;
+
+            simd::store(flag, entered);
+            simd::store(a, z.a);
+            simd::store(b, z.b);
+            simd::store(pa, p.a);
+            simd::store(pb, p.b);
+
+            for (n = 0U; n < width; ++n)
+            {
+                if (flag[n] > 0.5)
+                {
+                    const complex root = balls->nearest(complex(a[n], b[n]));
+                    a[n] = root.dat[0];
+                    b[n] = root.dat[1];
+                    pa[n] = 0.0;
+                    pb[n] = 0.0;
+                }
+            }
+
+            z = Batch(V::load(a), V::load(b));
+            p = Batch(V::load(pa), V::load(pb));
+        }
+
+        template <class Batch, class V>
+        inline void ball_finish(Batch &, Batch &, const V &,
+                                std::false_type) const
+        {
+            return;
+        }
+
+        /*  Scalar orbits other than complex ones have no balls either.       */
+        template <class Number>
+        inline void ball_step(Number &, Number &, unsigned int) const
+        {
+            return;
+        }
+
+        /**********************************************************************
+         *  Method:                                                           *
+         *      iterate_lanes                                                 *
+         *  Purpose:                                                          *
+         *      Runs Newton's method on "count" points stored component by    *
+         *      component, in batches of the back end of "isa". A lane stops  *
+         *      updating the moment its residual drops below tol_sq, exactly  *
+         *      where the scalar loop would break, and a batch stops once     *
+         *      every lane has converged (or after n_iters steps).            *
+         *  Arguments:                                                        *
+         *      c (Scalar * const *):                                         *
+         *          The Batch<V>::dims arrays of components, replaced by the  *
+         *          final points. Scalar is double or float.                  *
+         *      res (Scalar *):                                               *
+         *          The residuals |p(q)|^2 of the final points.               *
+         *      count (unsigned int):                                         *
+         *          Number of points, a multiple of simd::max_width.          *
+         *      tol_sq (double):                                              *
+         *          The tolerance, eps_sq for double precision.               *
+         *      n_iters (unsigned int):                                       *
+         *          The most steps to take.                                   *
+         *      steps (unsigned int *):                                       *
+         *          If not null, gets the number of steps of each point.      *
+         *  Notes:                                                            *
+         *      The points go in and out through memory since the registers   *
+         *      of the AVX2 and AVX-512 back ends only exist in the copies    *
+         *      compiled for them (see QNF_TARGET_AVX2), while the tile loops *
+         *      around this and the coloring stay at the baseline.            *
+         **********************************************************************/
+        template <template <class> class Batch, class Scalar>
+        inline void iterate_lanes(Scalar *const *c, Scalar *res,
+                                  unsigned int count, double tol_sq,
+                                  unsigned int n_iters,
+                                  unsigned int *steps = 0) const
+        {
+#ifdef QNF_ISA_DISPATCH
+            if (isa == isa_avx512)
+            {
+                lanes_avx512<Batch>(c, res, count, tol_sq, n_iters, steps);
+                return;
+            }
+
+            if (isa == isa_avx2)
+            {
+                lanes_avx2<Batch>(c, res, count, tol_sq, n_iters, steps);
+                return;
+            }
+#endif
+            typedef typename simd::native::reg<Scalar>::type V;
+            newton_lanes<Batch, V>(c, res, count, tol_sq, n_iters, steps);
+        }
+
+#ifdef QNF_ISA_DISPATCH
+        /*  newton_lanes with the 4-lane ymm back end, compiled for AVX2 and  *
+         *  FMA.                                                              */
+        template <template <class> class Batch, class Scalar>
+        QNF_TARGET_AVX2
+        void lanes_avx2(Scalar *const *c, Scalar *res, unsigned int count,
+                        double tol_sq, unsigned int n_iters,
+                        unsigned int *steps) const
+        {
+            typedef typename simd::avx2::reg<Scalar>::type V;
+            newton_lanes<Batch, V>(c, res, count, tol_sq, n_iters, steps);
+        }
+
+        /*  newton_lanes with the 8-lane zmm back end, compiled for AVX-512.  */
+        template <template <class> class Batch, class Scalar>
+        QNF_TARGET_AVX512
+        void lanes_avx512(Scalar *const *c, Scalar *res, unsigned int count,
+                          double tol_sq, unsigned int n_iters,
+                          unsigned int *steps) const
+        {
+            typedef typename simd::avx512::reg<Scalar>::type V;
+            newton_lanes<Batch, V>(c, res, count, tol_sq, n_iters, steps);
+        }
+#endif
+
+        /*  The points of iterate_lanes, V::width at a time.                  */
+        template <template <class> class Batch, class V>
+        inline void newton_lanes(typename simd::traits<V>::scalar *const *c,
+                                 typename simd::traits<V>::scalar *res,
+                                 unsigned int count, double tol_sq,
+                                 unsigned int n_iters,
+                                 unsigned int *steps) const
+        {
+            unsigned int m;
+
+            for (m = 0U; m < count; m += V::width)
+            {
+                Batch<V> p, q = Batch<V>::load(c, m);
+                newton_batch(&q, &p, tol_sq, n_iters, steps ? steps + m : 0);
+                q.store(c, m);
+                simd::store(res + m, p.norm_sq());
+            }
+        }
+
+        /*  The loop of iterate_lanes for the batch *q_io, replaced by the    *
+         *  final points. Takes pointers, not values: registers wider than    *
+         *  those of the baseline have no agreed way to be passed by value.   */
+        template <class Batch>
+        inline void newton_batch(Batch *q_io, Batch *p_out, double tol_sq,
+                                 unsigned int n_iters,
+                                 unsigned int *steps) const
+        {
+            typedef typename Batch::vec_type vec_type;
+            typedef typename Batch::mask_type mask_type;
+            typedef typename Batch::scalar scalar;
+            const vec_type tol(static_cast<scalar>(tol_sq));
+            const vec_type cycle_sq(static_cast<scalar>(cycle_factor()*tol_sq));
+            const vec_type zero(scalar(0)), half(scalar(0.5)), one(scalar(1));
+            typename Poly::template powers<Batch> w;
+            Batch q = *q_io;
+            Batch p = Poly::eval(q, &w);
+            Batch kept = q;
+            mask_type done = simd::less(p.norm_sq(), tol);
+            vec_type count = zero, cycling = zero, escaping = zero;
+            vec_type saved = zero, in_ball = zero, residual;
+            unsigned int iters, n;
+
+            for (iters = 0U; iters < n_iters; ++iters)
+            {
+                const unsigned int left = n_iters - iters - 1U;
+
+                if (simd::all(done))
+                    break;
+
+                if (steps)
+                    count = count + simd::select(done, zero, one);
+
+                q = Batch::select(done, q, Poly::step(q, w));
+                p = Batch::select(done, p, Poly::eval(q, &w));
+                residual = p.norm_sq();
+                done = done | simd::less(residual, tol);
+
+                /*  Lanes that entered a root ball stop, see ball_finish.     */
+                if (tol_sq >= eps_sq)
+                    in_ball = in_ball + ball_step(q, residual, done, left);
+
+                /*  Every fourth step, the lanes still running that cycled or *
+                 *  escaped. Checking each step costs a quarter of the time   *
+                 *  of a frame where nearly every orbit converges quickly.    *
+                 *  There is no mask negation, so !(|q|^2 < limit), true for  *
+                 *  NaN, goes through a select.                               */
+                if (stop_early && (iters & 3U) == 3U)
+                {
+                    const vec_type limit(escape_limit<scalar>(left));
+                    const mask_type cycled =
+                        simd::less((q - kept).norm_sq(), cycle_sq);
+                    const mask_type escaped = simd::less(
+                        half, simd::select(simd::less(q.norm_sq(), limit),
+                                           zero, one)
+                    );
+
+                    if (stats && left > 0U)
+                    {
+                        const vec_type c = simd::select(cycled, one, zero);
+                        const vec_type e = simd::select(escaped, one - c, zero);
+                        cycling = cycling + simd::select(done, zero, c);
+                        escaping = escaping + simd::select(done, zero, e);
+                        saved = saved + simd::select(done, zero, c + e) *
+                                        vec_type(static_cast<scalar>(left));
+                    }
+
+                    done = done | cycled | escaped;
+                }
+
+                /*  Keep the points after 1, 2, 4, 8, ... steps.              */
+                if ((iters & (iters + 1U)) == 0U)
+                    kept = q;
+            }
+
+            ball_finish(q, p, in_ball);
+
+            if (stats)
+                add_stats(cycling, escaping, saved, in_ball);
+
+            if (steps)
+            {
+                scalar c[Batch::width];
+                simd::store(c, count);
+
+                for (n = 0U; n < Batch::width; ++n)
+                    steps[n] = static_cast<unsigned int>(c[n]);
+            }
+
+            *q_io = q;
+            *p_out = p;
+        }
+
+        /*  Runs Newton's method for every pixel of the tile t in full        *
+         *  4-dimensional quaternion arithmetic and stores the colors in the  *
+         *  frame buffer. Rows are processed simd::max_width pixels at a      *
+         *  time, see iterate_lanes.                                          */
+        void tile_4d(const tile &t, const view &v, framebuffer &fb) const
+        {
+            const unsigned int width = simd::max_width;
+            unsigned int x, y, n;
+            double p_norm_sq;
+
+            for (y = t.y0; y < t.y1; ++y)
+            {
+                for (x = t.x0; x + width <= t.x1; x += width)
+                {
+                    double a[width], x1[width], y1[width], z1[width];
+                    double res[width];
+                    double *const c[4] = {a, x1, y1, z1};
+                    unsigned int steps[width] = {0U};
+
+                    for (n = 0U; n < width; ++n)
+                    {
+                        const quaternion q0 = v.point(x + n, y);
+                        a[n] = q0.dat[0];
+                        x1[n] = q0.dat[1];
+                        y1[n] = q0.dat[2];
+                        z1[n] = q0.dat[3];
+                    }
+
+                    iterate_lanes<basic_quaternion_batch>(
+                        c, res, width, eps_sq, max_iters, counting(steps)
+                    );
+
+                    for (n = 0U; n < width; ++n)
+                    {
+                        const quaternion q(a[n], x1[n], y1[n], z1[n]);
+                        put(fb, x + n, y, q, res[n], steps[n]);
+                    }
+                }
+
+                /*  Leftover pixels at the right edge of the tile.            */
+                for (; x < t.x1; ++x)
+                {
+                    unsigned int steps = 0U;
+                    const quaternion q =
+                        iterate(v.point(x, y), &p_norm_sq, &steps);
+                    put(fb, x, y, q, p_norm_sq, steps);
+                }
+            }
+        }
+
+        /*  Same as tile_4d, for polynomials with real coefficients. Each     *
+         *  starting point is projected to the complex plane through it (see  *
+         *  qnf::slice), Newton's method runs on two components instead of    *
+         *  four, and only the final point is lifted back for coloring.       */
+        void tile_slice(const tile &t, const view &v, framebuffer &fb) const
+        {
+            const unsigned int width = simd::max_width;
+            unsigned int x, y, n;
+            double p_norm_sq;
+
+            for (y = t.y0; y < t.y1; ++y)
+            {
+                for (x = t.x0; x + width <= t.x1; x += width)
+                {
+                    slice planes[width];
+                    double re[width], im[width], res[width];
+                    double *const c[2] = {re, im};
+                    unsigned int steps[width] = {0U};
+
+                    for (n = 0U; n < width; ++n)
+                    {
+                        const complex w = planes[n].project(v.point(x + n, y));
+                        re[n] = w.dat[0];
+                        im[n] = w.dat[1];
+                    }
+
+                    iterate_lanes<basic_complex_batch>(
+                        c, res, width, eps_sq, max_iters, counting(steps)
+                    );
+
+                    for (n = 0U; n < width; ++n)
+                    {
+                        const quaternion q =
+                            planes[n].lift(complex(re[n], im[n]));
+                        put(fb, x + n, y, q, res[n], steps[n]);
+                    }
+                }
+
+                /*  Leftover pixels at the right edge of the tile.            */
+                for (; x < t.x1; ++x)
+                {
+                    slice plane;
+                    unsigned int steps = 0U;
+                    const complex z0 = plane.project(v.point(x, y));
+                    const complex z = iterate(z0, &p_norm_sq, &steps);
+                    put(fb, x, y, plane.lift(z), p_norm_sq, steps);
+                }
+            }
+        }
+
+        /*  Colors the pixel (x, y), whose point lies in the plane "plane",   *
+         *  from its basin as read from the table. "steps" is reported as the *
+         *  Newton steps of the pixel, e.g. to the telemetry.                 */
+        inline void write_basin(framebuffer &fb, unsigned int x, unsigned int y,
+                                const slice &plane, int basin,
+                                unsigned int steps) const
+        {
+            if (basin == 0)
+                put(fb, x, y, quaternion(), HUGE_VAL, steps);
+            else
+            {
+                const unsigned int k = static_cast<unsigned int>(basin) - 1U;
+                put(fb, x, y, plane.lift(Poly::root(k)), 0.0, steps);
+            }
+        }
+
+        /*  Renders the tile t using the basin table. Pixels in uniform cells *
+         *  are a lookup plus the coloring. The rest, the basin boundaries,   *
+         *  are gathered and iterated directly in batches as in tile_slice.   */
+        void tile_table(const tile &t, const view &v, framebuffer &fb) const
+        {
+            const unsigned int width = simd::max_width;
+            unsigned int x, y, n, queued;
+            double p_norm_sq;
+
+            for (y = t.y0; y < t.y1; ++y)
+            {
+                slice planes[width];
+                unsigned int xs[width], steps[width] = {0U};
+                double re[width], im[width], res[width];
+                double *const c[2] = {re, im};
+                queued = 0U;
+
+                for (x = t.x0; x < t.x1; ++x)
+                {
+                    slice plane;
+                    const complex w = plane.project(v.point(x, y));
+                    const int basin = table->lookup(w.dat[0], w.dat[1]);
+
+                    if (basin >= 0)
+                    {
+                        const double steps =
+                            table->iterations(w.dat[0], w.dat[1]);
+                        write_basin(fb, x, y, plane, basin,
+                                    static_cast<unsigned int>(steps + 0.5));
+                        continue;
+                    }
+
+                    planes[queued] = plane;
+                    xs[queued] = x;
+                    re[queued] = w.dat[0];
+                    im[queued] = w.dat[1];
+                    ++queued;
+
+                    if (queued == width)
+                    {
+                        iterate_lanes<basic_complex_batch>(
+                            c, res, width, eps_sq, max_iters, counting(steps)
+                        );
+
+                        for (n = 0U; n < width; ++n)
+                        {
+                            const quaternion q =
+                                planes[n].lift(complex(re[n], im[n]));
+                            put(fb, xs[n], y, q, res[n], steps[n]);
+                        }
+
+                        queued = 0U;
+                    }
+                }
+
+                /*  Boundary pixels left over at the end of the row.          */
+                for (n = 0U; n < queued; ++n)
+                {
+                    const complex z0 = complex(re[n], im[n]);
+                    const complex z = iterate(z0, &p_norm_sq, &steps[n]);
+                    put(fb, xs[n], y, planes[n].lift(z), p_norm_sq, steps[n]);
+                }
+            }
+        }
+
+        /*  Markers in the root index array of tile_subdivide, next to 0 for  *
+         *  orbits that did not converge and 1 + k for Poly::root(k).         */
+        enum {
+            unknown_root = 0xFE,
+            pending = 0xFF
+        };
+
+        /*  Rectangles whose border is not uniform and whose interior has at  *
+         *  most this many pixels are iterated instead of split further.      */
+        enum {
+            min_interior = 16
+        };
+
+        /*  Root index of a final point z with residual p_norm_sq.            */
+        inline unsigned char
+        root_index(const complex &z, double p_norm_sq) const
+        {
+            if (!(p_norm_sq < eps_sq))
+                return 0U;
+
+            return static_cast<unsigned char>(nearest_root<Poly>(z) + 1U);
+        }
+
+        /*  Iterates the listed pixels of the tile t in batches, colors them, *
+         *  and stores their root indices in "roots", indexed from the top    *
+         *  left of t. A short last batch is padded with its last pixel, the  *
+         *  lists are short and the scalar loop would be most of the cost.    *
+         *  Real coefficients: the complex-slice reduction.                   */
+        void compute_pixels(const tile &t, const view &v, framebuffer &fb,
+                            unsigned char *roots, const unsigned int *xs,
+                            const unsigned int *ys, unsigned int count,
+                            std::true_type) const
+        {
+            const unsigned int width = simd::max_width;
+            const unsigned int w = t.x1 - t.x0;
+            unsigned int m, n;
+
+            for (m = 0U; m < count; m += width)
+            {
+                slice planes[width];
+                double re[width], im[width], res[width];
+                double *const c[2] = {re, im};
+                unsigned int steps[width] = {0U};
+
+                for (n = 0U; n < width; ++n)
+                {
+                    const unsigned int k = std::min(m + n, count - 1U);
+                    const quaternion q = v.point(xs[k], ys[k]);
+                    const complex c = planes[n].project(q);
+                    re[n] = c.dat[0];
+                    im[n] = c.dat[1];
+                }
+
+                iterate_lanes<basic_complex_batch>(c, res, width, eps_sq,
+                                                   max_iters, counting(steps));
+
+                for (n = 0U; n < width && m + n < count; ++n)
+                {
+                    const unsigned int x = xs[m + n], y = ys[m + n];
+                    const complex zn(re[n], im[n]);
+                    put(fb, x, y, planes[n].lift(zn), res[n], steps[n]);
+                    roots[(y - t.y0)*w + (x - t.x0)] = root_index(zn, res[n]);
+                }
+            }
+        }
+
+        /*  Same without real coefficients, in 4 dimensions. The roots are    *
+         *  not known, so converged pixels are only marked unknown_root.      */
+        void compute_pixels(const tile &t, const view &v, framebuffer &fb,
+                            unsigned char *roots, const unsigned int *xs,
+                            const unsigned int *ys, unsigned int count,
+                            std::false_type) const
+        {
+            const unsigned int width = simd::max_width;
+            const unsigned int w = t.x1 - t.x0;
+            unsigned int m, n;
+
+            for (m = 0U; m < count; m += width)
+            {
+                double a[width], x1[width], y1[width], z1[width], res[width];
+                double *const c[4] = {a, x1, y1, z1};
+                unsigned int steps[width] = {0U};
+
+                for (n = 0U; n < width; ++n)
+                {
+                    const unsigned int k = std::min(m + n, count - 1U);
+                    const quaternion q0 = v.point(xs[k], ys[k]);
+                    a[n] = q0.dat[0];
+                    x1[n] = q0.dat[1];
+                    y1[n] = q0.dat[2];
+                    z1[n] = q0.dat[3];
+                }
+
+                iterate_lanes<basic_quaternion_batch>(
+                    c, res, width, eps_sq, max_iters, counting(steps)
+                );
+
+                for (n = 0U; n < width && m + n < count; ++n)
+                {
+                    const unsigned int x = xs[m + n], y = ys[m + n];
+                    const quaternion q(a[n], x1[n], y1[n], z1[n]);
+                    put(fb, x, y, q, res[n], steps[n]);
+                    roots[(y - t.y0)*w + (x - t.x0)] =
+                        (res[n] < eps_sq ? unsigned(unknown_root) : 0U);
+                }
+            }
+        }
+
+        /*  Colors the interior of r pixel by pixel from the root "basin",    *
+         *  lifted along each pixel's own direction as in the basin table.    *
+         *  No steps are taken for these pixels, and none are reported.       */
+        inline void fill_basin(const tile &r, const view &v, framebuffer &fb,
+                               unsigned char basin, std::true_type) const
+        {
+            unsigned int x, y;
+
+            for (y = r.y0 + 1U; y + 1U < r.y1; ++y)
+            {
+                for (x = r.x0 + 1U; x + 1U < r.x1; ++x)
+                {
+                    slice plane;
+                    plane.project(v.point(x, y));
+                    write_basin(fb, x, y, plane, basin, 0U);
+                }
+            }
+        }
+
+        /*  Without real coefficients there are no roots to lift. The fast    *
+         *  mode is never used then.                                          */
+        inline void fill_basin(const tile &, const view &, framebuffer &,
+                               unsigned char, std::false_type) const
+        {
+            return;
+        }
+
+        /*  Copies the color of the corner (r.x0, r.y0) into the interior of  *
+         *  r, in fb and, if set, in the mirror buffer.                       */
+        inline void fill_color(const tile &r, framebuffer &fb) const
+        {
+            unsigned int x, y;
+            unsigned char rgb[3], mirror_rgb[3];
+
+            std::memcpy(rgb, fb.pixel(r.x0, r.y0), 3U);
+
+            if (mirror)
+                std::memcpy(mirror_rgb, mirror->pixel(r.x0, r.y0), 3U);
+
+            for (y = r.y0 + 1U; y + 1U < r.y1; ++y)
+            {
+                for (x = r.x0 + 1U; x + 1U < r.x1; ++x)
+                {
+                    std::memcpy(fb.pixel(x, y), rgb, 3U);
+
+                    if (mirror)
+                        std::memcpy(mirror->pixel(x, y), mirror_rgb, 3U);
+                }
+            }
+        }
+
+        /*  True if the border pixel (x, y) matches the corner (r.x0, r.y0):  *
+         *  same root index and, unless only roots are compared, the same     *
+         *  color in fb and in the mirror buffer.                             */
+        inline bool same_as_corner(const tile &r, const tile &t,
+                                   const framebuffer &fb,
+                                   const unsigned char *roots,
+                                   unsigned int x, unsigned int y,
+                                   bool roots_only) const
+        {
+            const unsigned int w = t.x1 - t.x0;
+            const unsigned char corner = roots[(r.y0 - t.y0)*w + r.x0 - t.x0];
+
+            if (roots[(y - t.y0)*w + (x - t.x0)] != corner)
+                return false;
+
+            if (roots_only)
+                return true;
+
+            if (std::memcmp(fb.pixel(x, y), fb.pixel(r.x0, r.y0), 3U))
+                return false;
+
+            if (mirror && std::memcmp(mirror->pixel(x, y),
+                                      mirror->pixel(r.x0, r.y0), 3U))
+                return false;
+
+            return true;
+        }
+
+        /*  True if the whole border of r matches its top left corner.        */
+        inline bool uniform_border(const tile &r, const tile &t,
+                                   const framebuffer &fb,
+                                   const unsigned char *roots,
+                                   bool roots_only) const
+        {
+            unsigned int x, y;
+
+            for (x = r.x0; x < r.x1; ++x)
+                if (!same_as_corner(r, t, fb, roots, x, r.y0, roots_only) ||
+                    !same_as_corner(r, t, fb, roots, x, r.y1 - 1U, roots_only))
+                    return false;
+
+            for (y = r.y0 + 1U; y + 1U < r.y1; ++y)
+                if (!same_as_corner(r, t, fb, roots, r.x0, y, roots_only) ||
+                    !same_as_corner(r, t, fb, roots, r.x1 - 1U, y, roots_only))
+                    return false;
+
+            return true;
+        }
+
+        /**********************************************************************
+         *  Method:                                                           *
+         *      tile_subdivide                                                *
+         *  Purpose:                                                          *
+         *      Renders the tile t by Mariani-Silver subdivision. The border  *
+         *      of a rectangle is iterated first. If every border pixel went  *
+         *      to the same root the interior is filled without iterating,    *
+         *      otherwise the rectangle is cut in half across its longer side *
+         *      and the two halves, which share the new cut, are handled the  *
+         *      same way.                                                     *
+         *  Arguments:                                                        *
+         *      t (const qnf::tile &):                                        *
+         *          The tile to render.                                       *
+         *      v (const qnf::view &):                                        *
+         *          The plane and window of the frame.                        *
+         *      fb (qnf::framebuffer &):                                      *
+         *          The frame buffer.                                         *
+         *      fast (bool):                                                  *
+         *          Color mode (false) fills only if the border also has one  *
+         *          single color, which is then copied. A border in one basin *
+         *          but with several colors is iterated inside instead of     *
+         *          split. Fast mode (true) fills whenever the root is the    *
+         *          same and colors each interior pixel from the root lifted  *
+         *          along its own direction, like the basin table, unless the *
+         *          rectangle touches the line where the plane folds (see     *
+         *          view::folds). There it uses the color check. Fast mode    *
+         *          needs real coefficients and is ignored otherwise.         *
+         *  Output:                                                           *
+         *      iterated (unsigned long int):                                 *
+         *          The number of pixels Newton's method was run for.         *
+         *  Notes:                                                            *
+         *      The Julia set of Newton's method for a polynomial is          *
+         *      connected (Shishikura), so every basin component is simply    *
+         *      connected and a closed curve inside one basin component       *
+         *      encloses only points of that component. Fast mode applies     *
+         *      this to the projection of the rectangle to the complex plane, *
+         *      which only encloses the projected interior if the plane does  *
+         *      not fold over inside it. Near the fold the interior projects  *
+         *      below its border, towards the real axis, and a different      *
+         *      basin can reach it there. The border is also only sampled at  *
+         *      pixels, and a filament thinner than a pixel may cross it      *
+         *      unseen, so neither mode is exact. Fast mode also differs by   *
+         *      the rounding of the lifted root. --verify counts the pixels   *
+         *      each mode gets wrong.                                         *
+         **********************************************************************/
+        unsigned long int
+        tile_subdivide(const tile &t, const view &v, framebuffer &fb,
+                       bool fast) const
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+            const unsigned int w = t.x1 - t.x0;
+            const bool roots_only = fast && Poly::real_coefficients;
+            std::vector<unsigned char> roots(w * (t.y1 - t.y0), pending);
+            std::vector<unsigned int> xs, ys;
+            std::vector<tile> stack(1U, t);
+            unsigned long int iterated;
+            unsigned int x, y;
+
+            /*  The border of the whole tile.                                 */
+            for (x = t.x0; x < t.x1; ++x)
+            {
+                xs.push_back(x);
+                ys.push_back(t.y0);
+
+                if (t.y1 - 1U > t.y0)
+                {
+                    xs.push_back(x);
+                    ys.push_back(t.y1 - 1U);
+                }
+            }
+
+            for (y = t.y0 + 1U; y + 1U < t.y1; ++y)
+            {
+                xs.push_back(t.x0);
+                ys.push_back(y);
+
+                if (t.x1 - 1U > t.x0)
+                {
+                    xs.push_back(t.x1 - 1U);
+                    ys.push_back(y);
+                }
+            }
+
+            compute_pixels(t, v, fb, &roots[0], &xs[0], &ys[0],
+                           static_cast<unsigned int>(xs.size()), real());
+            iterated = xs.size();
+
+            while (!stack.empty())
+            {
+                const tile r = stack.back();
+                const unsigned int rw = r.x1 - r.x0, rh = r.y1 - r.y0;
+                tile a = r, b = r;
+                stack.pop_back();
+
+                /*  No interior left, every pixel of r is on its border.      */
+                if (rw <= 2U || rh <= 2U)
+                    continue;
+
+                const bool same_root =
+                    uniform_border(r, t, fb, &roots[0], true);
+
+                if (same_root && roots_only &&
+                    !v.folds(r.x0, r.y0, r.x1 - 1U, r.y1 - 1U))
+                {
+                    fill_basin(r, v, fb, roots[(r.y0 - t.y0)*w + r.x0 - t.x0],
+                               real());
+                    continue;
+                }
+
+                if (same_root && uniform_border(r, t, fb, &roots[0], false))
+                {
+                    fill_color(r, fb);
+                    continue;
+                }
+
+                xs.clear();
+                ys.clear();
+
+                /*  Splitting a small rectangle saves less than it costs. So  *
+                 *  does splitting one inside a single basin whose colors     *
+                 *  vary, the halves would not have one color either.         */
+                if (same_root || (rw - 2U) * (rh - 2U) <= min_interior)
+                {
+                    for (y = r.y0 + 1U; y + 1U < r.y1; ++y)
+                    {
+                        for (x = r.x0 + 1U; x + 1U < r.x1; ++x)
+                        {
+                            xs.push_back(x);
+                            ys.push_back(y);
+                        }
+                    }
+
+                    compute_pixels(t, v, fb, &roots[0], &xs[0], &ys[0],
+                                   static_cast<unsigned int>(xs.size()),
+                                   real());
+                    iterated += xs.size();
+                    continue;
+                }
+
+                /*  Cut across the longer side, through the middle.           */
+                if (rw >= rh)
+                {
+                    const unsigned int xm = r.x0 + rw/2U;
+                    a.x1 = xm + 1U;
+                    b.x0 = xm;
+
+                    for (y = r.y0 + 1U; y + 1U < r.y1; ++y)
+                    {
+                        xs.push_back(xm);
+                        ys.push_back(y);
+                    }
+                }
+                else
+                {
+                    const unsigned int ym = r.y0 + rh/2U;
+                    a.y1 = ym + 1U;
+                    b.y0 = ym;
+
+                    for (x = r.x0 + 1U; x + 1U < r.x1; ++x)
+                    {
+                        xs.push_back(x);
+                        ys.push_back(ym);
+                    }
+                }
+
+                compute_pixels(t, v, fb, &roots[0], &xs[0], &ys[0],
+                               static_cast<unsigned int>(xs.size()), real());
+                iterated += xs.size();
+                stack.push_back(a);
+                stack.push_back(b);
+            }
+
+            return iterated;
+        }
+
+        /*  Number of steps in double that finish an orbit computed in single *
+         *  precision, see Poly::polish_steps.                                */
+        enum {
+            polish_steps = Poly::polish_steps
+        };
+
+        /*  Runs Newton's method on the simd::max_widthf points cf, stored    *
+         *  component by component as in iterate_lanes, in single precision,  *
+         *  then finishes each orbit with up to polish_steps steps in double. *
+         *  The final points go to c and their residuals to res. doubtful[n]  *
+         *  is set for points that did not converge in single precision or in *
+         *  the polish, the ones where the float orbit may have gone          *
+         *  somewhere else. If steps is not null it gets the steps of both    *
+         *  phases added up.                                                  */
+        template <template <class> class Batch>
+        inline void iterate_single(float *const *cf, double *const *c,
+                                   double *res, bool *doubtful,
+                                   unsigned int *steps) const
+        {
+            const unsigned int width = simd::max_widthf;
+            const unsigned int dims = Batch<simd::vec>::dims;
+            float res_single[width];
+            unsigned int polish[width];
+            unsigned int d, n;
+
+            {
+                const simd::flush_denormals ftz;
+                iterate_lanes<Batch>(cf, res_single, width, single_eps_sq,
+                                     max_iters, steps);
+            }
+
+            for (d = 0U; d < dims; ++d)
+                for (n = 0U; n < width; ++n)
+                    c[d][n] = static_cast<double>(cf[d][n]);
+
+            iterate_lanes<Batch>(c, res, width, eps_sq, polish_steps,
+                                 steps ? polish : 0);
+
+            for (n = 0U; n < width; ++n)
+            {
+                if (steps)
+                    steps[n] += polish[n];
+
+                doubtful[n] = !(res_single[n] < single_eps_sq) ||
+                              !(res[n] < eps_sq);
+            }
+        }
+
+        /**********************************************************************
+         *  Method:                                                           *
+         *      tile_single                                                   *
+         *  Purpose:                                                          *
+         *      Renders the tile t with Newton's method in single precision,  *
+         *      twice as many pixels per register as in double. The starting  *
+         *      points are computed in double and rounded, and each orbit is  *
+         *      finished in double (see iterate_single), so converged pixels  *
+         *      are colored from a point as accurate as in tile_slice.        *
+         *  Arguments:                                                        *
+         *      t (const qnf::tile &):                                        *
+         *          The tile to render.                                       *
+         *      v (const qnf::view &):                                        *
+         *          The plane and window of the frame.                        *
+         *      fb (qnf::framebuffer &):                                      *
+         *          The frame buffer.                                         *
+         *      mixed (bool):                                                 *
+         *          If set, the doubtful pixels are run again from the start  *
+         *          in double, as in tile_slice and tile_4d.                  *
+         *  Output:                                                           *
+         *      rerun (unsigned long int):                                    *
+         *          The number of pixels that were run again in double.       *
+         *  Notes:                                                            *
+         *      Near the boundaries of the basins the orbit depends on the    *
+         *      last bits of the starting point, and a float orbit may go to  *
+         *      another root than the double one without being doubtful.      *
+         *      --verify counts these pixels.                                 *
+         **********************************************************************/
+        unsigned long int
+        tile_single(const tile &t, const view &v, framebuffer &fb,
+                    bool mixed, std::true_type) const
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+            const unsigned int width = simd::max_widthf;
+            std::vector<unsigned int> xs, ys;
+            unsigned int x, y, n;
+
+            for (y = t.y0; y < t.y1; ++y)
+            {
+                for (x = t.x0; x < t.x1; x += width)
+                {
+                    slice planes[width];
+                    float re[width], im[width];
+                    float *const cf[2] = {re, im};
+                    double zr[width], zi[width], res[width];
+                    double *const c[2] = {zr, zi};
+                    bool doubtful[width];
+                    unsigned int steps[width] = {0U};
+
+                    /*  A short last batch is padded with the last pixel.     */
+                    for (n = 0U; n < width; ++n)
+                    {
+                        const unsigned int xn = std::min(x + n, t.x1 - 1U);
+                        const complex w = planes[n].project(v.point(xn, y));
+                        re[n] = static_cast<float>(w.dat[0]);
+                        im[n] = static_cast<float>(w.dat[1]);
+                    }
+
+                    iterate_single<basic_complex_batch>(cf, c, res, doubtful,
+                                                        counting(steps));
+
+                    for (n = 0U; n < width && x + n < t.x1; ++n)
+                    {
+                        if (mixed && doubtful[n])
+                        {
+                            xs.push_back(x + n);
+                            ys.push_back(y);
+                            continue;
+                        }
+
+                        const complex zn(zr[n], zi[n]);
+                        put(fb, x + n, y, planes[n].lift(zn), res[n],
+                            steps[n]);
+                    }
+                }
+            }
+
+            if (!xs.empty())
+            {
+                std::vector<unsigned char> roots((t.x1 - t.x0)*(t.y1 - t.y0));
+                compute_pixels(t, v, fb, &roots[0], &xs[0], &ys[0],
+                               static_cast<unsigned int>(xs.size()), real());
+            }
+
+            return xs.size();
+        }
+
+        /*  Same without real coefficients, in 4 dimensions.                  */
+        unsigned long int
+        tile_single(const tile &t, const view &v, framebuffer &fb,
+                    bool mixed, std::false_type) const
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+            const unsigned int width = simd::max_widthf;
+            std::vector<unsigned int> xs, ys;
+            unsigned int x, y, n;
+
+            for (y = t.y0; y < t.y1; ++y)
+            {
+                for (x = t.x0; x < t.x1; x += width)
+                {
+                    float a[width], x1[width], y1[width], z1[width];
+                    float *const cf[4] = {a, x1, y1, z1};
+                    double qa[width], qx[width], qy[width], qz[width];
+                    double *const c[4] = {qa, qx, qy, qz};
+                    double res[width];
+                    bool doubtful[width];
+                    unsigned int steps[width] = {0U};
+
+                    for (n = 0U; n < width; ++n)
+                    {
+                        const unsigned int xn = std::min(x + n, t.x1 - 1U);
+                        const quaternion q0 = v.point(xn, y);
+                        a[n] = static_cast<float>(q0.dat[0]);
+                        x1[n] = static_cast<float>(q0.dat[1]);
+                        y1[n] = static_cast<float>(q0.dat[2]);
+                        z1[n] = static_cast<float>(q0.dat[3]);
+                    }
+
+                    iterate_single<basic_quaternion_batch>(
+                        cf, c, res, doubtful, counting(steps)
+                    );
+
+                    for (n = 0U; n < width && x + n < t.x1; ++n)
+                    {
+                        if (mixed && doubtful[n])
+                        {
+                            xs.push_back(x + n);
+                            ys.push_back(y);
+                            continue;
+                        }
+
+                        const quaternion q(qa[n], qx[n], qy[n], qz[n]);
+                        put(fb, x + n, y, q, res[n], steps[n]);
+                    }
+                }
+            }
+
+            if (!xs.empty())
+            {
+                std::vector<unsigned char> roots((t.x1 - t.x0)*(t.y1 - t.y0));
+                compute_pixels(t, v, fb, &roots[0], &xs[0], &ys[0],
+                               static_cast<unsigned int>(xs.size()), real());
+            }
+
+            return xs.size();
+        }
+
+        /*  Picks the kernel: subdivision if it was asked for, the basin      *
+         *  table if there is one, single or mixed precision if asked for,    *
+         *  otherwise the complex-slice reduction whenever the polynomial has *
+         *  real coefficients, and the 4-dimensional iteration if it does     *
+         *  not. Its Newton loops run in the copy compiled for "isa".         */
+        inline void operator () (const tile &t, const view &v,
+                                 framebuffer &fb) const
+        {
+            typedef std::integral_constant<bool, Poly::real_coefficients> real;
+            render_tile(t, v, fb, real());
+        }
+
+    private:
+        inline void render_tile(const tile &t, const view &v, framebuffer &fb,
+                                std::true_type) const
+        {
+            if (subdivide != subdivide_none)
+                tile_subdivide(t, v, fb, subdivide == subdivide_fast);
+            else if (table)
+                tile_table(t, v, fb);
+            else if (precision != precision_double)
+                tile_single(t, v, fb, precision == precision_mixed,
+                            std::true_type());
+            else
+                tile_slice(t, v, fb);
+        }
+
+        inline void render_tile(const tile &t, const view &v, framebuffer &fb,
+                                std::false_type) const
+        {
+            if (subdivide != subdivide_none)
+                tile_subdivide(t, v, fb, false);
+            else if (precision != precision_double)
+                tile_single(t, v, fb, precision == precision_mixed,
+                            std::false_type());
+            else
+                tile_4d(t, v, fb);
+        }
+    };
+    /*  End of kernel struct.                                                 */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,234 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the root-finding methods the fractals can be rendered with:  *
+ *      Newton's method, damped Newton, Halley's and Schroder's methods.      *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_METHOD_HPP
+#define QNF_METHOD_HPP
+
+/*  strcmp, used for looking methods up by name.                              */
+#include <cstring>
+
+/*  The polynomials the methods wrap.                                         */
+#include "qnf_polynomial.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  A method is a polynomial whose step has been replaced. methods::X<P>  *
+     *  derives from P, so it has P's name, roots, powers and eval, and is    *
+     *  handed to the kernel and the renderer in place of P. Besides step     *
+     *  and the unfused newton it sets                                        *
+     *      static const bool is_newton;                                      *
+     *      static double far_ratio(void);                                    *
+     *  the first false, as the root balls only hold for Newton's method, and *
+     *  the second to |step(q)| / |q| for large q, which bounds how fast an   *
+     *  orbit can come back from far away. A method that converges slower     *
+     *  than Newton's also sets polish_steps. Every method has                *
+     *      static const char *method_name(void);                             *
+     *  to select it at run time. Newton's method is the polynomial itself,   *
+     *  named "newton".                                                       *
+     *                                                                        *
+     *  The methods cost about the same per step: the steps are simplified    *
+     *  to a single division, plus a product for Halley's method. What        *
+     *  differs is the number of steps. Near a simple root of a polynomial    *
+     *  with real coefficients Newton's method squares the error, Halley's    *
+     *  cubes it, damped Newton only multiplies it by 1 - h, and Schroder's   *
+     *  method, made for multiple roots, is quadratic like Newton's. These    *
+     *  orders rest on p' being the derivative, which fails for q^3 - j:      *
+     *  there every method converges linearly, see qnf_polynomial.hpp. Far    *
+     *  from the roots Newton's method shrinks q by (d - 1) / d, d the        *
+     *  degree, Halley's by (d - 1) / (d + 1), damped Newton by 1 - h / d,    *
+     *  and Schroder's method sends q close to 0 in one step. The basins, and *
+     *  so the frames, differ between the methods, --bench counts by how many *
+     *  pixels.                                                               */
+    namespace methods {
+
+        /*  q - h p(q) / p'(q), h = 7/8. Each step goes most of the way to    *
+         *  the Newton point, which calms the orbits that jump across the     *
+         *  basins, but the convergence is only linear with ratio 1/8.        */
+        template <class Poly>
+        struct damped : Poly {
+            static const bool is_newton = false;
+
+            static inline double damping(void)
+            {
+                return 0.875;
+            }
+
+            static inline const char *method_name(void)
+            {
+                return "damped";
+            }
+
+            static inline double far_ratio(void)
+            {
+                return 1.0 - damping() / Poly::degree;
+            }
+
+            /*  Each step shrinks the error about 8 times, 6 steps cover the  *
+             *  3 digits from single precision to eps, see polish_steps in    *
+             *  qnf_polynomial.hpp, unless Poly already needs more.           */
+            static const unsigned int polish_steps =
+                Poly::polish_steps < 6U ? 6U : Poly::polish_steps;
+
+            /*  q + h (N(q) - q), N the Newton step.                          */
+            template <class T>
+            static inline T
+            step(const T &q, const typename Poly::template powers<T> &w)
+            {
+                return q + (Poly::step(q, w) - q) * damping();
+            }
+
+            template <class T>
+            static inline T newton(const T &q)
+            {
+                typename Poly::template powers<T> w;
+                Poly::eval(q, &w);
+                return step(q, w);
+            }
+        };
+
+        /*  Halley's method, q - 2pp' / (2p'^2 - pp''), cubic convergence     *
+         *  with real coefficients.                                           */
+        template <class Poly>
+        struct halley : Poly {
+            static const bool is_newton = false;
+
+            static inline const char *method_name(void)
+            {
+                return "halley";
+            }
+
+            static inline double far_ratio(void)
+            {
+                return double(Poly::degree - 1U) / (Poly::degree + 1U);
+            }
+
+            template <class T>
+            static inline T
+            step(const T &q, const typename Poly::template powers<T> &w)
+            {
+                return Poly::halley_step(q, w);
+            }
+
+            template <class T>
+            static inline T newton(const T &q)
+            {
+                typename Poly::template powers<T> w;
+                Poly::eval(q, &w);
+                return step(q, w);
+            }
+        };
+
+        /*  Schroder's method, q - pp' / (p'^2 - pp''), which is Newton's     *
+         *  method for p / p' and, with real coefficients, converges          *
+         *  quadratically to multiple roots too. Large q land near 0, so only *
+         *  overflows count as escapes.                                       */
+        template <class Poly>
+        struct schroeder : Poly {
+            static const bool is_newton = false;
+
+            static inline const char *method_name(void)
+            {
+                return "schroeder";
+            }
+
+            static inline double far_ratio(void)
+            {
+                return 0.0;
+            }
+
+            template <class T>
+            static inline T
+            step(const T &q, const typename Poly::template powers<T> &w)
+            {
+                return Poly::schroeder_step(q, w);
+            }
+
+            template <class T>
+            static inline T newton(const T &q)
+            {
+                typename Poly::template powers<T> w;
+                Poly::eval(q, &w);
+                return step(q, w);
+            }
+        };
+    }
+    /*  End of namespace "methods".                                           */
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      visit_method                                                      *
+     *  Purpose:                                                              *
+     *      Selects a method by name at run time and hands the polynomial     *
+     *      Poly wrapped in it, as a type, to visitor.run_method<Method>().   *
+     *      Like visit_polynomial, everything the visitor instantiates is     *
+     *      compiled separately for each method.                              *
+     *  Arguments:                                                            *
+     *      name (const char *):                                              *
+     *          The name of the method, e.g. "halley".                        *
+     *      visitor (Visitor &):                                              *
+     *          Struct with a member template                                 *
+     *          "template <class Method> R run_method()".                     *
+     *      result (R *):                                                     *
+     *          The value returned by visitor.run_method<Method>().           *
+     *  Output:                                                               *
+     *      found (bool):                                                     *
+     *          False if no method has this name.                             *
+     *  Notes:                                                                *
+     *      Newton's method is handed over as Poly itself.                    *
+     **************************************************************************/
+    template <class Poly, class Visitor, class R>
+    inline bool visit_method(const char *name, Visitor &visitor, R *result)
+    {
+        if (!std::strcmp(name, "newton"))
+            *result = visitor.template run_method<Poly>();
+
+        else if (!std::strcmp(name, methods::damped<Poly>::method_name()))
+            *result = visitor.template run_method<methods::damped<Poly> >();
+
+        else if (!std::strcmp(name, methods::halley<Poly>::method_name()))
+            *result = visitor.template run_method<methods::halley<Poly> >();
+
+        else if (!std::strcmp(name, methods::schroeder<Poly>::method_name()))
+            *result =
+                visitor.template run_method<methods::schroeder<Poly> >();
+
+        else
+            return false;
+
+        return true;
+    }
+
+    /*  The names accepted by visit_method, for usage messages.               */
+    static const char * const method_names =
+        "newton, damped, halley, schroeder";
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
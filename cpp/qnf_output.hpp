@@ -0,0 +1,447 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the output back ends for an animation: streaming frames into *
+ *      the encoder through a pipe, or writing one PPM file per frame.        *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_OUTPUT_HPP
+#define QNF_OUTPUT_HPP
+
+/*  PPM files and the frame buffer.                                           */
+#include "qnf_ppm.hpp"
+
+/*  popen, pclose, remove, and system are found here.                         */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <string>
+#include <vector>
+
+/*  fcntl, used to enlarge the pipe buffer on Linux.                          */
+#include <fcntl.h>
+
+/*  The writer thread of the asynchronous back end.                           */
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*  Commands for the encoder, as printf formats with %s for the name of the   *
+ *  animation, "fractal" by default. The file back end reads the numbered     *
+ *  PPM files, the pipe back end reads a stream of concatenated PPMs on stdin.*/
+#ifdef WEBP
+#define ANIMATION_COMMAND \
+"ffmpeg -framerate 23 -i %s_%%03d.ppm -loop 0 -lossless 1 %s.webp"
+#define STREAM_COMMAND \
+"ffmpeg -y -loglevel error -f image2pipe -c:v ppm -framerate 23 -i - "\
+"-loop 0 -lossless 1 %s.webp"
+#else
+#define ANIMATION_COMMAND \
+"ffmpeg -framerate 23 -i %s_%%03d.ppm -plays 0 %s.apng"
+#define STREAM_COMMAND \
+"ffmpeg -y -loglevel error -f image2pipe -c:v ppm -framerate 23 -i - "\
+"-plays 0 %s.apng"
+#endif
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Namespace for the animation back ends. Each provides                  *
+     *      bool begin(void);                                                 *
+     *      bool write_frame(unsigned int frame, const qnf::framebuffer &fb); *
+     *      bool finish(void);                                                *
+     *      void abort(void);                                                 *
+     *  so the render loop can be written once as a template. A false return *
+     *  from write_frame means the output is broken and rendering can stop.   *
+     *  A render that fails calls abort instead of finish, which ends the     *
+     *  output without encoding and keeps whatever frames are on disk.        */
+    namespace output {
+
+        /*  STREAM_COMMAND for the animation "name".                          */
+        inline std::string stream_command(const char *name)
+        {
+            std::vector<char> command(sizeof(STREAM_COMMAND) +
+                                      std::strlen(name));
+            std::sprintf(&command[0], STREAM_COMMAND, name);
+            return std::string(&command[0]);
+        }
+
+        /*  ANIMATION_COMMAND for the animation "name".                       */
+        inline std::string animation_command(const char *name)
+        {
+            std::vector<char> command(sizeof(ANIMATION_COMMAND) +
+                                      2U * std::strlen(name));
+            std::sprintf(&command[0], ANIMATION_COMMAND, name, name);
+            return std::string(&command[0]);
+        }
+
+        /**********************************************************************
+         *  Struct:                                                           *
+         *      encoder_pipe                                                  *
+         *  Purpose:                                                          *
+         *      Starts the encoder once as a child process and streams every  *
+         *      frame to its stdin as a P6 image the moment it is rendered.   *
+         *      The encoder works on frame N while frame N + 1 is computed,   *
+         *      and nothing is written to disk except the final animation.    *
+         **********************************************************************/
+        struct encoder_pipe {
+            std::string command;
+            FILE *fp;
+            bool failed;
+
+            encoder_pipe(const std::string &cmd = stream_command("fractal"))
+                : command(cmd), fp(0), failed(false)
+            {
+                return;
+            }
+
+            inline bool begin(void)
+            {
+                /*  If the encoder dies, report the failed write instead of   *
+                 *  being killed by SIGPIPE.                                  */
+                std::signal(SIGPIPE, SIG_IGN);
+
+                fp = popen(command.c_str(), "w");
+
+                if (!fp)
+                {
+                    std::puts("ERROR: popen failed to start the encoder.");
+                    return false;
+                }
+
+#ifdef F_SETPIPE_SZ
+                /*  A pipe buffer the size of a frame lets write_frame return *
+                 *  right away instead of waiting for the encoder to drain    *
+                 *  it. This is best effort, the kernel may refuse.           */
+                fcntl(fileno(fp), F_SETPIPE_SZ, 1 << 22);
+#endif
+                return true;
+            }
+
+            inline bool write_frame(unsigned int frame, const framebuffer &fb)
+            {
+                const std::size_t n_bytes = fb.size();
+                (void)frame;
+
+                if (!fp || failed)
+                    return false;
+
+                std::fprintf(fp, "P6\n%u %u\n255\n", fb.xsize, fb.ysize);
+
+                if (std::fwrite(fb.row(0U), 1UL, n_bytes, fp) != n_bytes)
+                {
+                    std::puts("ERROR: the encoder closed its input early.");
+                    failed = true;
+                }
+
+                return !failed;
+            }
+
+            inline bool finish(void)
+            {
+                int status;
+
+                if (!fp)
+                    return false;
+
+                status = pclose(fp);
+                fp = 0;
+                return !failed && status == 0;
+            }
+
+            /*  The encoder only sees the end of its input, the frames it got *
+             *  are all there is to keep.                                     */
+            inline void abort(void)
+            {
+                if (!fp)
+                    return;
+
+                pclose(fp);
+                fp = 0;
+                std::puts("ERROR: the render failed, the animation is "
+                          "incomplete.");
+            }
+        };
+
+        /**********************************************************************
+         *  Struct:                                                           *
+         *      ppm_files                                                     *
+         *  Purpose:                                                          *
+         *      Writes each frame to name_%03u.ppm, fractal_%03u.ppm by       *
+         *      default. If "encode" is set, finish() runs ANIMATION_COMMAND  *
+         *      on the files and then deletes them. Only the files this back  *
+         *      end wrote are removed, other PPMs in the working directory    *
+         *      are left alone, and if the encoder fails the frames are kept  *
+         *      so they can be encoded again by hand.                         *
+         **********************************************************************/
+        struct ppm_files {
+            bool encode;
+            std::string name;
+            std::vector<std::string> names;
+
+            ppm_files(bool encode_frames = true,
+                      const char *animation = "fractal")
+                : encode(encode_frames), name(animation)
+            {
+                return;
+            }
+
+            inline bool begin(void)
+            {
+                names.clear();
+                return true;
+            }
+
+            inline bool write_frame(unsigned int frame, const framebuffer &fb)
+            {
+                char number[16];
+                std::string file;
+                bool success;
+                std::sprintf(number, "_%03u.ppm", frame);
+                file = name + number;
+                qnf::ppm PPM = qnf::ppm(file.c_str());
+
+                if (!PPM.fp)
+                    return false;
+
+                PPM.init(fb.xsize, fb.ysize, 6);
+                PPM.write(fb);
+
+                /*  Flush first, so a full disk shows up in ferror and the    *
+                 *  encoder never sees a truncated frame.                     */
+                success = std::fflush(PPM.fp) == 0 && !std::ferror(PPM.fp);
+                PPM.close();
+                names.push_back(file);
+
+                if (!success)
+                    std::printf("ERROR: could not write %s.\n", file.c_str());
+
+                return success;
+            }
+
+            inline bool finish(void)
+            {
+                std::size_t n;
+                int status;
+
+                if (!encode)
+                    return true;
+
+                status = std::system(animation_command(name.c_str()).c_str());
+
+                if (status != 0)
+                {
+                    std::printf("ERROR: the encoder failed, the frames %s_*.ppm "
+                                "were kept.\n", name.c_str());
+                    return false;
+                }
+
+                for (n = 0UL; n < names.size(); ++n)
+                    std::remove(names[n].c_str());
+
+                return true;
+            }
+
+            /*  Keeps the frames written so far and does not encode them.     */
+            inline void abort(void)
+            {
+                if (encode && !names.empty())
+                    std::printf("ERROR: the render failed, the frames "
+                                "%s_*.ppm were kept and not encoded.\n",
+                                name.c_str());
+            }
+        };
+
+        /**********************************************************************
+         *  Struct:                                                           *
+         *      async                                                         *
+         *  Purpose:                                                          *
+         *      Wraps another back end and calls it from a writer thread of   *
+         *      its own. write_frame copies the frame into a ring of "slots"  *
+         *      buffers and returns, so the disk or the encoder works on      *
+         *      frame N while frames N + 1 onwards are computed. Once the     *
+         *      ring is full write_frame waits for the writer, which bounds   *
+         *      the memory to "slots" frames. Frames reach the wrapped back   *
+         *      end in the order they were given, with the same numbers.      *
+         *  Notes:                                                            *
+         *      A failure of the wrapped back end is reported by the next     *
+         *      call to write_frame, and by finish.                           *
+         **********************************************************************/
+        template <class Output>
+        struct async {
+            Output &out;
+
+            /*  Frame number and buffer of each slot. Slot "head" is the next *
+             *  to be written, "count" slots from there on are full.          */
+            std::vector<unsigned int> frames;
+            std::vector<framebuffer> ring;
+            unsigned int head, count;
+            bool failed, done;
+
+            std::mutex lock;
+            std::condition_variable changed;
+            std::thread writer;
+
+            async(Output &o, unsigned int slots = 4U)
+                : out(o), frames(slots > 0U ? slots : 1U),
+                  ring(frames.size(), framebuffer(0U, 0U)),
+                  head(0U), count(0U), failed(false), done(false)
+            {
+                return;
+            }
+
+            ~async(void)
+            {
+                if (writer.joinable())
+                    stop();
+            }
+
+            inline bool begin(void)
+            {
+                if (!out.begin())
+                    return false;
+
+                head = 0U;
+                count = 0U;
+                failed = false;
+                done = false;
+                writer = std::thread(&async::drain, this);
+                return true;
+            }
+
+            inline bool write_frame(unsigned int frame, const framebuffer &fb)
+            {
+                const unsigned int n_slots =
+                    static_cast<unsigned int>(ring.size());
+                unsigned int slot;
+
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+
+                    while (count == n_slots && !failed)
+                        changed.wait(guard);
+
+                    if (failed)
+                        return false;
+
+                    slot = (head + count) % n_slots;
+                }
+
+                /*  The writer does not touch a slot until it is counted, so  *
+                 *  the copy needs no lock. It reuses the slot's memory.      */
+                ring[slot].xsize = fb.xsize;
+                ring[slot].ysize = fb.ysize;
+                ring[slot].data.assign(fb.data.begin(), fb.data.end());
+                frames[slot] = frame;
+
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    ++count;
+                }
+
+                changed.notify_all();
+                return true;
+            }
+
+            inline bool finish(void)
+            {
+                stop();
+                return out.finish() && !failed;
+            }
+
+            /*  Drops the frames still in the ring, waits for the writer, and *
+             *  aborts the wrapped back end.                                  */
+            inline void abort(void)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    count = 0U;
+                }
+
+                stop();
+                out.abort();
+            }
+
+            /*  Writes the frames as they arrive, until stop() is called and  *
+             *  the ring is empty, or the wrapped back end fails.             */
+            inline void drain(void)
+            {
+                const unsigned int n_slots =
+                    static_cast<unsigned int>(ring.size());
+
+                while (true)
+                {
+                    unsigned int slot;
+                    bool written;
+
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+
+                        while (count == 0U && !done)
+                            changed.wait(guard);
+
+                        if (count == 0U)
+                            return;
+
+                        slot = head;
+                    }
+
+                    written = out.write_frame(frames[slot], ring[slot]);
+
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        head = (head + 1U) % n_slots;
+                        --count;
+                        failed = failed || !written;
+                    }
+
+                    changed.notify_all();
+
+                    if (!written)
+                        return;
+                }
+            }
+
+            /*  Lets the writer empty the ring and waits for it to exit.      */
+            inline void stop(void)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    done = true;
+                }
+
+                changed.notify_all();
+
+                if (writer.joinable())
+                    writer.join();
+            }
+        };
+    }
+    /*  End of namespace "output".                                            */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
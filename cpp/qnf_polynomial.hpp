@@ -0,0 +1,466 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the polynomials whose Newton fractals are rendered.          *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_POLYNOMIAL_HPP
+#define QNF_POLYNOMIAL_HPP
+
+/*  strcmp, used for looking polynomials up by name.                          */
+#include <cstring>
+
+/*  Complex numbers, used for the roots of real polynomials.                  */
+#include "qnf_complex.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  A polynomial is a struct with                                         *
+     *      static const bool real_coefficients;                              *
+     *      static const unsigned int degree;                                 *
+     *      template <class T> struct powers;                                 *
+     *      template <class T> static T eval(const T &q, powers<T> *w);       *
+     *      template <class T> static T step(const T &q, const powers<T> &w); *
+     *  where eval returns p(q) and saves the powers of q it computed in w,   *
+     *  and step is one step of Newton's method from q, reusing the powers in *
+     *  w instead of computing them again. The loop                           *
+     *      p = eval(q, &w);                                                  *
+     *      while (|p| >= eps) {q = step(q, w); p = eval(q, &w);}             *
+     *  thus evaluates each power of q once per iteration. T may be           *
+     *  qnf::quaternion or qnf::quaternion_batch and, if real_coefficients is *
+     *  true, qnf::complex or qnf::complex_batch too, or the float versions   *
+     *  of these. The renderer detects real coefficients through this flag   *
+     *  and then iterates in the complex plane containing the starting point. *
+     *                                                                        *
+     *  Deriving from polynomials::fused<Poly> adds the unfused pair          *
+     *      template <class T> static T func(const T &q);                     *
+     *      template <class T> static T newton(const T &q);                   *
+     *  for code that needs only one of the two.                              *
+     *                                                                        *
+     *  The steps of two cubically and quadratically convergent relatives of  *
+     *  Newton's method, simplified like step, are also given,                *
+     *      template <class T>                                                *
+     *      static T halley_step(const T &q, const powers<T> &w);             *
+     *      template <class T>                                                *
+     *      static T schroeder_step(const T &q, const powers<T> &w);          *
+     *  and are selected through the wrappers in qnf_method.hpp.              *
+     *                                                                        *
+     *  The degree bounds how fast an orbit comes back from far away, for     *
+     *  large q a step of Newton's method is close to q (degree - 1)/degree.  *
+     *                                                                        *
+     *  Real polynomials also list their complex roots,                       *
+     *      static const unsigned int n_roots;                                *
+     *      static qnf::complex root(unsigned int k);                         *
+     *  Non-real roots come in conjugate pairs and both are listed. In the    *
+     *  quaternions each non-real root z = x + yi is a whole 2-sphere of      *
+     *  roots x + yn, |n| = 1. An orbit starting at a + rn (r > 0) that       *
+     *  converges to the complex root x + yi ends at the quaternion x + yn.   *
+     *  With the roots comes                                                  *
+     *      static double root_radius(unsigned int k);                        *
+     *  the radius of a disc about root(k) from which Newton's method         *
+     *  converges to it quadratically. By Smale's gamma theorem this is       *
+     *      (3 - sqrt(7)) / (2 gamma),                                        *
+     *      gamma = max_{m >= 2} |p^(m)(r) / (m! p'(r))|^(1 / (m - 1))        *
+     *  for the root r. The values below are rounded down, see root_balls.    *
+     *                                                                        *
+     *  Every polynomial also has a name, used to select it at run time:      *
+     *      static const char *name(void);                                    *
+     *  and says whether its coefficients commute with j,                     *
+     *      static const bool commutes_with_j;                                *
+     *  which is true for real coefficients and for coefficients in           *
+     *  span{1, j}. Newton's method then commutes with q -> j q j^-1, which   *
+     *  lets the renderer derive frames from each other (qnf_symmetry.hpp).   */
+    namespace polynomials {
+
+        /*  func and newton written in terms of eval and step. When inlined   *
+         *  the compiler drops the powers that are not used.                  */
+        template <class Poly>
+        struct fused {
+
+            /*  step is Newton's method. Far from the roots it takes q to     *
+             *  about q (degree - 1) / degree, which the kernel uses to stop  *
+             *  escaping orbits, and the root balls of qnf_root_ball.hpp      *
+             *  apply to it. The wrappers in qnf_method.hpp replace these.    */
+            static const bool is_newton = true;
+
+            static inline double far_ratio(void)
+            {
+                return double(Poly::degree - 1U) / Poly::degree;
+            }
+
+            /*  Steps in double that finish an orbit run in single precision, *
+             *  from |p|^2 < 1E-10 to 1E-16. With real coefficients Newton's  *
+             *  method doubles the correct digits, two steps do, one more for *
+             *  safety. Polynomials that converge slower set their own.       */
+            static const unsigned int polish_steps = 3U;
+
+            template <class T>
+            static inline T func(const T &q)
+            {
+                typename Poly::template powers<T> w;
+                return Poly::eval(q, &w);
+            }
+
+            template <class T>
+            static inline T newton(const T &q)
+            {
+                typename Poly::template powers<T> w;
+                Poly::eval(q, &w);
+                return Poly::step(q, w);
+            }
+        };
+
+        /*  The polynomial z^3 - 1.                                           */
+        struct cube_minus_one : fused<cube_minus_one> {
+            static const bool real_coefficients = true;
+            static const unsigned int degree = 3U;
+            static const bool commutes_with_j = true;
+            static const unsigned int n_roots = 3U;
+
+            static inline const char *name(void)
+            {
+                return "z3-1";
+            }
+
+            /*  The cube roots of unity.                                      */
+            static inline complex root(unsigned int k)
+            {
+                const double half_sqrt_3 = 0.8660254037844386;
+
+                if (k == 0U)
+                    return complex(1.0, 0.0);
+
+                return complex(-0.5, (k == 1U ? half_sqrt_3 : -half_sqrt_3));
+            }
+
+            /*  gamma = max(|3r / 3r^2|, |1 / 3r^2|^(1/2)) = 1 at every root. */
+            static inline double root_radius(unsigned int)
+            {
+                return 0.1771;
+            }
+
+            /*  q^3 is shared by p(q) and the step. q^2 is only needed by     *
+             *  the step, which is skipped once q has converged.              */
+            template <class T>
+            struct powers {
+                T q3;
+            };
+
+            template <class T>
+            static inline T eval(const T &q, powers<T> *w)
+            {
+                w->q3 = q.cube();
+                return w->q3 - 1.0;
+            }
+
+            /*  q - (q^3 - 1) / (3q^2) simplified to (2q^3 + 1) / (3q^2).     */
+            template <class T>
+            static inline T step(const T &q, const powers<T> &w)
+            {
+                T num = w.q3*2.0 + 1.0;
+                T den = q.square() * 3.0;
+                return num / den;
+            }
+
+            /*  q - 2pp' / (2p'^2 - pp'') = (q^3 + 2)q / (2q^3 + 1).          */
+            template <class T>
+            static inline T halley_step(const T &q, const powers<T> &w)
+            {
+                T num = (w.q3 + 2.0) * q;
+                T den = w.q3*2.0 + 1.0;
+                return num / den;
+            }
+
+            /*  q - pp' / (p'^2 - pp'') = 3q / (q^3 + 2).                     */
+            template <class T>
+            static inline T schroeder_step(const T &q, const powers<T> &w)
+            {
+                T num = q * 3.0;
+                T den = w.q3 + 2.0;
+                return num / den;
+            }
+        };
+
+        /*  The polynomial z^4 - 1.                                           */
+        struct fourth_minus_one : fused<fourth_minus_one> {
+            static const bool real_coefficients = true;
+            static const unsigned int degree = 4U;
+            static const bool commutes_with_j = true;
+            static const unsigned int n_roots = 4U;
+
+            static inline const char *name(void)
+            {
+                return "z4-1";
+            }
+
+            /*  The fourth roots of unity, 1, i, -1, -i.                      */
+            static inline complex root(unsigned int k)
+            {
+                static const double re[4] = {1.0, 0.0, -1.0, 0.0};
+                static const double im[4] = {0.0, 1.0, 0.0, -1.0};
+                return complex(re[k], im[k]);
+            }
+
+            /*  gamma = |6r^2 / 4r^3| = 3/2 at every root.                    */
+            static inline double root_radius(unsigned int)
+            {
+                return 0.1180;
+            }
+
+            template <class T>
+            struct powers {
+                T q4;
+            };
+
+            template <class T>
+            static inline T eval(const T &q, powers<T> *w)
+            {
+                w->q4 = q.square().square();
+                return w->q4 - 1.0;
+            }
+
+            /*  q - (q^4 - 1) / (4q^3) simplified to (3q^4 + 1) / (4q^3).     */
+            template <class T>
+            static inline T step(const T &q, const powers<T> &w)
+            {
+                T num = w.q4*3.0 + 1.0;
+                T den = q.cube() * 4.0;
+                return num / den;
+            }
+
+            /*  q - 2pp' / (2p'^2 - pp'') = (3q^4 + 5)q / (5q^4 + 3).         */
+            template <class T>
+            static inline T halley_step(const T &q, const powers<T> &w)
+            {
+                T num = (w.q4*3.0 + 5.0) * q;
+                T den = w.q4*5.0 + 3.0;
+                return num / den;
+            }
+
+            /*  q - pp' / (p'^2 - pp'') = 4q / (q^4 + 3).                     */
+            template <class T>
+            static inline T schroeder_step(const T &q, const powers<T> &w)
+            {
+                T num = q * 4.0;
+                T den = w.q4 + 3.0;
+                return num / den;
+            }
+        };
+
+        /*  The polynomial z^3 - 2z + 2. Newton's method started at 0 falls   *
+         *  into the 2-cycle 0 -> 1 -> 0, so its fractal has open regions of  *
+         *  points that never converge.                                       */
+        struct cube_minus_two_z_plus_two : fused<cube_minus_two_z_plus_two> {
+            static const bool real_coefficients = true;
+            static const unsigned int degree = 3U;
+            static const bool commutes_with_j = true;
+            static const unsigned int n_roots = 3U;
+
+            static inline const char *name(void)
+            {
+                return "z3-2z+2";
+            }
+
+            /*  One real root and a conjugate pair, from Cardano's formula.   */
+            static inline complex root(unsigned int k)
+            {
+                const double im = 0.5897428050222054;
+
+                if (k == 0U)
+                    return complex(-1.7692923542386314, 0.0);
+
+                return complex(0.8846461771193157, (k == 1U ? im : -im));
+            }
+
+            /*  gamma = |3r / (3r^2 - 2)| is 0.7181 at the real root and      *
+             *  0.9947 at the other two.                                      */
+            static inline double root_radius(unsigned int k)
+            {
+                return (k == 0U ? 0.2466 : 0.1780);
+            }
+
+            template <class T>
+            struct powers {
+                T q3;
+            };
+
+            template <class T>
+            static inline T eval(const T &q, powers<T> *w)
+            {
+                w->q3 = q.cube();
+                return w->q3 - q*2.0 + 2.0;
+            }
+
+            /*  q - (q^3 - 2q + 2) / (3q^2 - 2) = (2q^3 - 2) / (3q^2 - 2).    */
+            template <class T>
+            static inline T step(const T &q, const powers<T> &w)
+            {
+                T num = w.q3*2.0 - 2.0;
+                T den = q.square()*3.0 - 2.0;
+                return num / den;
+            }
+
+            /*  q - 2pp' / (2p'^2 - pp'') works out to                        *
+             *      (3q^5 + 2q^3 - 12q^2 + 4) / (6q^4 - 6q^2 - 6q + 4).       */
+            template <class T>
+            static inline T halley_step(const T &q, const powers<T> &w)
+            {
+                const T q2 = q.square();
+                T num = q2 * (w.q3*3.0 + q*2.0 - 12.0) + 4.0;
+                T den = (q2.square() - q2 - q)*6.0 + 4.0;
+                return num / den;
+            }
+
+            /*  q - pp' / (p'^2 - pp'') works out to                          *
+             *      (8q^3 - 18q^2 + 4) / (3q^4 - 12q + 4).                    */
+            template <class T>
+            static inline T schroeder_step(const T &q, const powers<T> &w)
+            {
+                const T q2 = q.square();
+                T num = w.q3*8.0 - q2*18.0 + 4.0;
+                T den = q2.square()*3.0 - q*12.0 + 4.0;
+                return num / den;
+            }
+        };
+
+        /*  The polynomial q^3 - j. The constant is not real, so the plane    *
+         *  through a point and the real axis is not preserved and Newton's   *
+         *  method has to run in all four dimensions. 3q^2 is then only the   *
+         *  derivative along the directions that commute with q, and all of   *
+         *  the methods converge linearly: near the roots each step shrinks   *
+         *  |p| about 0.88 times.                                             */
+        struct cube_minus_j : fused<cube_minus_j> {
+            static const bool real_coefficients = false;
+            static const unsigned int degree = 3U;
+            static const bool commutes_with_j = true;
+
+            /*  From |p|^2 < 1E-10 to 1E-16 at 0.88 per step takes up to 55   *
+             *  steps, from 2000 random starting points, one more for safety. */
+            static const unsigned int polish_steps = 56U;
+
+            static inline const char *name(void)
+            {
+                return "q3-j";
+            }
+
+            template <class T>
+            struct powers {
+                T q3;
+            };
+
+            template <class T>
+            static inline T eval(const T &q, powers<T> *w)
+            {
+                w->q3 = q.cube();
+                return w->q3 - quaternion(0.0, 0.0, 1.0, 0.0);
+            }
+
+            /*  q - (q^3 - j)(3q^2)^-1 = (2q^3 + j)(3q^2)^-1, since q         *
+             *  commutes with its own powers.                                 */
+            template <class T>
+            static inline T step(const T &q, const powers<T> &w)
+            {
+                T num = w.q3*2.0 + quaternion(0.0, 0.0, 1.0, 0.0);
+                T den = q.square() * 3.0;
+                return num / den;
+            }
+
+            /*  With u = p p'^-1 = (q^3 - j) q^-2 / 3, Halley's method is     *
+             *      q - u (1 - u p'' (2p')^-1)^-1.                            *
+             *  u p'' (2p')^-1 = (q^3 - j) q^-3 / 3, so the bracket is        *
+             *  (2q^3 + j) q^-3 / 3 and the step                              *
+             *      q - (q^3 - j) q (2q^3 + j)^-1.                            *
+             *  q stays between the two factors, j does not commute with q.   */
+            template <class T>
+            static inline T halley_step(const T &q, const powers<T> &w)
+            {
+                const quaternion j(0.0, 0.0, 1.0, 0.0);
+                T num = (w.q3 - j) * q;
+                T den = w.q3*2.0 + j;
+                return q - num / den;
+            }
+
+            /*  q - u (1 - u p'' p'^-1)^-1, where the bracket is              *
+             *  (q^3 + 2j) q^-3 / 3, is q - (q^3 - j) q (q^3 + 2j)^-1.        */
+            template <class T>
+            static inline T schroeder_step(const T &q, const powers<T> &w)
+            {
+                const quaternion j(0.0, 0.0, 1.0, 0.0);
+                T num = (w.q3 - j) * q;
+                T den = w.q3 + j*2.0;
+                return q - num / den;
+            }
+        };
+    }
+    /*  End of namespace "polynomials".                                       */
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      visit_polynomial                                                  *
+     *  Purpose:                                                              *
+     *      Selects a polynomial by name at run time and hands it, as a type, *
+     *      to visitor.run<Poly>(). Everything the visitor instantiates is    *
+     *      compiled separately for each polynomial.                          *
+     *  Arguments:                                                            *
+     *      name (const char *):                                              *
+     *          The name of the polynomial, e.g. "z3-1".                      *
+     *      visitor (Visitor &):                                              *
+     *          Struct with a member template "template <class Poly> R run()".*
+     *      result (R *):                                                     *
+     *          The value returned by visitor.run<Poly>().                    *
+     *  Output:                                                               *
+     *      found (bool):                                                     *
+     *          False if no polynomial has this name.                         *
+     **************************************************************************/
+    template <class Visitor, class R>
+    inline bool visit_polynomial(const char *name, Visitor &visitor, R *result)
+    {
+        if (!std::strcmp(name, polynomials::cube_minus_one::name()))
+            *result = visitor.template run<polynomials::cube_minus_one>();
+
+        else if (!std::strcmp(name, polynomials::fourth_minus_one::name()))
+            *result = visitor.template run<polynomials::fourth_minus_one>();
+
+        else if (!std::strcmp(name,
+                              polynomials::cube_minus_two_z_plus_two::name()))
+            *result = visitor.template
+                run<polynomials::cube_minus_two_z_plus_two>();
+
+        else if (!std::strcmp(name, polynomials::cube_minus_j::name()))
+            *result = visitor.template run<polynomials::cube_minus_j>();
+
+        else
+            return false;
+
+        return true;
+    }
+
+    /*  The names accepted by visit_polynomial, for usage messages.           */
+    static const char * const polynomial_names = "z3-1, z4-1, z3-2z+2, q3-j";
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
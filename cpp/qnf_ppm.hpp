@@ -34,9 +34,114 @@
 /*  File data type found here.                                                */
 #include <cstdio>
 
+/*  Storage for the frame buffer.                                             */
+#include <vector>
+
 /*  Namespace for the project. "Quaternion Newton Fractal."                   */
 namespace qnf {
 
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      framebuffer                                                       *
+     *  Purpose:                                                              *
+     *      An in-memory RGB image laid out exactly like the body of a binary *
+     *      (P6) PPM file: rows from top to bottom, three bytes per pixel.    *
+     *      The renderer fills it directly and the whole frame (or a band of  *
+     *      rows) is then written with a single fwrite. Allocate it once and  *
+     *      reuse it for every frame.                                         *
+     *                                                                        *
+     *      A buffer may also hold only the rows first_row through            *
+     *      first_row + ysize - 1 of a taller image, a band. Pixels are still *
+     *      addressed by their row in the image, so the kernels fill a band   *
+     *      exactly as they would the whole frame.                            *
+     **************************************************************************/
+    struct framebuffer {
+
+        /*  Number of pixels in the x and y axes.                             */
+        unsigned int xsize, ysize;
+
+        /*  The row of the image held by the first row of data, 0 unless the  *
+         *  buffer holds a band.                                              */
+        unsigned int first_row;
+
+        /*  The RGB bytes, 3*xsize*ysize of them.                             */
+        std::vector<unsigned char> data;
+
+        /*  Creates a frame buffer with the dimensions in "setup".            */
+        framebuffer(void);
+
+        /*  Creates a frame buffer with x by y pixels.                        */
+        framebuffer(unsigned int x, unsigned int y);
+
+        /*  Creates a band of the rows y0 <= row < y0 + y of an image x       *
+         *  pixels wide.                                                      */
+        framebuffer(unsigned int x, unsigned int y, unsigned int y0);
+
+        /*  Pointer to the three bytes of the pixel (x, y).                   */
+        inline unsigned char *pixel(unsigned int x, unsigned int y);
+        inline const unsigned char *pixel(unsigned int x, unsigned int y) const;
+
+        /*  Pointer to the start of row y.                                    */
+        inline unsigned char *row(unsigned int y);
+        inline const unsigned char *row(unsigned int y) const;
+
+        /*  Number of bytes in the buffer.                                    */
+        inline std::size_t size(void) const;
+    };
+
+    /*  Frame buffer with the default dimensions.                             */
+    inline framebuffer::framebuffer(void)
+        : xsize(qnf::setup::xsize),
+          ysize(qnf::setup::ysize),
+          first_row(0U),
+          data(3UL * qnf::setup::xsize * qnf::setup::ysize)
+    {
+        return;
+    }
+
+    /*  Frame buffer with x by y pixels.                                      */
+    inline framebuffer::framebuffer(unsigned int x, unsigned int y)
+        : xsize(x), ysize(y), first_row(0U), data(3UL * x * y)
+    {
+        return;
+    }
+
+    /*  Band of y rows starting at row y0.                                    */
+    inline framebuffer::framebuffer(unsigned int x, unsigned int y,
+                                    unsigned int y0)
+        : xsize(x), ysize(y), first_row(y0), data(3UL * x * y)
+    {
+        return;
+    }
+
+    inline unsigned char *framebuffer::pixel(unsigned int x, unsigned int y)
+    {
+        return &data[3UL * (static_cast<std::size_t>(y - first_row) * xsize +
+                            x)];
+    }
+
+    inline const unsigned char *
+    framebuffer::pixel(unsigned int x, unsigned int y) const
+    {
+        return &data[3UL * (static_cast<std::size_t>(y - first_row) * xsize +
+                            x)];
+    }
+
+    inline unsigned char *framebuffer::row(unsigned int y)
+    {
+        return pixel(0U, y);
+    }
+
+    inline const unsigned char *framebuffer::row(unsigned int y) const
+    {
+        return pixel(0U, y);
+    }
+
+    inline std::size_t framebuffer::size(void) const
+    {
+        return data.size();
+    }
+
     /*  Struct for working with PPM files.                                    */
     struct ppm {
 
@@ -52,6 +157,12 @@ namespace qnf {
         /*  Method for initializing the PPM using the values in "setup".      */
         inline void init(void);
 
+        /*  Writes every row of a frame buffer to the PPM.                    */
+        inline void write(const framebuffer &fb);
+
+        /*  Writes the rows y0 <= y < y1 of a frame buffer to the PPM.        */
+        inline void write(const framebuffer &fb, unsigned int y0, unsigned int y1);
+
         /*  Method for closing the file pointer for the PPM.                  */
         inline void close(void);
     };
@@ -143,6 +254,42 @@ namespace qnf {
         init(qnf::setup::xsize, qnf::setup::ysize, 6);
     }
 
+    /**************************************************************************
+     *  Method:                                                               *
+     *      write                                                             *
+     *  Purpose:                                                              *
+     *      Writes a band of rows from a frame buffer to the PPM with a       *
+     *      single call to fwrite. The header must already have been written  *
+     *      with init, and bands must be written from top to bottom.          *
+     *  Arguments:                                                            *
+     *      fb (const qnf::framebuffer &):                                    *
+     *          The image data.                                               *
+     *      y0 (unsigned int):                                                *
+     *          The first row to write.                                       *
+     *      y1 (unsigned int):                                                *
+     *          One past the last row to write.                               *
+     *  Outputs:                                                              *
+     *      None (void).                                                      *
+     **************************************************************************/
+    inline void
+    ppm::write(const framebuffer &fb, unsigned int y0, unsigned int y1)
+    {
+        const std::size_t n_bytes = 3UL * fb.xsize * (y1 - y0);
+
+        /*  Nothing to write to if fopen failed.                              */
+        if (!fp || n_bytes == 0UL)
+            return;
+
+        if (std::fwrite(fb.row(y0), 1UL, n_bytes, fp) != n_bytes)
+            std::puts("ERROR: fwrite failed to write the full frame buffer.");
+    }
+
+    /*  Writes the entire frame buffer.                                       */
+    inline void ppm::write(const framebuffer &fb)
+    {
+        write(fb, 0U, fb.ysize);
+    }
+
     /**************************************************************************
      *  Function:                                                             *
      *      close                                                             *
@@ -0,0 +1,354 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      A pyramid of tiles for zooming into a frame, with a cache of the      *
+ *      tiles rendered so far in memory and on disk.                          *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_PYRAMID_HPP
+#define QNF_PYRAMID_HPP
+
+/*  snprintf, and reading and writing the tile files.                         */
+#include <cstdio>
+
+/*  ldexp, for the size of a tile at each level.                              */
+#include <cmath>
+
+/*  The in-memory cache.                                                      */
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/*  mkdir, for the disk cache. POSIX, like the result files.                  */
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/*  render_view, and the views, frame buffers and options it takes.           */
+#include "qnf.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      tile_address                                                      *
+     *  Purpose:                                                              *
+     *      A tile of the pyramid of frame "frame" of an n_frames frame turn. *
+     *      Level 0 is the whole window of the render options in one tile.    *
+     *      Each level halves the tiles of the one before in both directions, *
+     *      so level z has 2^z by 2^z tiles, (x, y) with x, y < 2^z, and tile *
+     *      (x, y) of level z covers the tiles (2x, 2y) to (2x + 1, 2y + 1)   *
+     *      of level z + 1. Every tile has the pixels of the window.          *
+     *  Notes:                                                                *
+     *      "tag" stands for everything else that changes the pixels: the     *
+     *      polynomial, the method and the render settings, see settings_tag. *
+     *      Tiles of different tags never share a cache entry.                *
+     **************************************************************************/
+    struct tile_address {
+        std::string tag;
+        unsigned int zoom, x, y;
+        unsigned int frame, n_frames;
+
+        /*  Deeper levels would need x and y beyond 32 bits. The pixels of    *
+         *  level 31 of the default window are already 2^-38 apart.           */
+        static inline unsigned int max_zoom(void)
+        {
+            return 31U;
+        }
+
+        /*  True if the tile exists: zoom, x and y are in range and frame is  *
+         *  one of the n_frames.                                              */
+        inline bool valid(void) const
+        {
+            return zoom <= max_zoom() && (x >> zoom) == 0U &&
+                   (y >> zoom) == 0U && frame < n_frames;
+        }
+
+        /*  The name of the tile, also its file name in the disk cache.       */
+        inline std::string name(void) const
+        {
+            char text[64];
+
+            std::snprintf(text, sizeof(text), "_f%u-%u_z%u_%u_%u.ppm",
+                          frame, n_frames, zoom, x, y);
+
+            return tag + text;
+        }
+
+        /*  The view of the tile: window with its pixels 2^zoom times finer,  *
+         *  moved to the tile, and turned to the frame. The scaling by a      *
+         *  power of two is exact.                                            */
+        inline view tile_view(const view &window) const
+        {
+            const double scale = std::ldexp(1.0, -static_cast<int>(zoom));
+            view v = window;
+
+            v.pxfact = window.pxfact * scale;
+            v.pyfact = window.pyfact * scale;
+            v.x_start = window.x_start + v.pxfact *
+                        (static_cast<double>(window.xsize) * x);
+            v.y_start = window.y_start + v.pyfact *
+                        (static_cast<double>(window.ysize) * y);
+            v.rotate_frame(frame, n_frames);
+            return v;
+        }
+    };
+
+    /*  A tag for tiles from the polynomial, the method and a text of the     *
+     *  other settings that change the pixels, e.g. eps and the window. The   *
+     *  settings go in as a 64-bit FNV-1a hash, so the file names stay short  *
+     *  and a change of any setting starts a new set of tiles.                */
+    inline std::string settings_tag(const char *poly, const char *method,
+                                    const std::string &settings)
+    {
+        unsigned long long int hash = 14695981039346656037ULL;
+        char text[32];
+        std::size_t n;
+
+        for (n = 0U; n < settings.size(); ++n)
+        {
+            hash ^= static_cast<unsigned char>(settings[n]);
+            hash *= 1099511628211ULL;
+        }
+
+        std::snprintf(text, sizeof(text), "_%016llx", hash);
+        return std::string(poly) + "_" + method + text;
+    }
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      tile_cache                                                        *
+     *  Purpose:                                                              *
+     *      The tiles rendered so far. The most recently used "capacity" of   *
+     *      them are kept in memory, and every tile is also written to a PPM  *
+     *      file in "dir", so that it outlives the process.                   *
+     *  Notes:                                                                *
+     *      find and insert lock the cache and may be called from several     *
+     *      threads. A tile missing from both is rendered outside the lock by *
+     *      the caller, see pyramid_tile, so two threads asking for the same  *
+     *      new tile at once both render it.                                  *
+     *                                                                        *
+     *      A file is written under a temporary name and then renamed, so a   *
+     *      reader never sees half a tile. Files of the wrong size are        *
+     *      ignored, and replaced once the tile is rendered again.            *
+     **************************************************************************/
+    struct tile_cache {
+        typedef std::pair<std::string, framebuffer> entry;
+        typedef std::list<entry> entry_list;
+
+        std::mutex lock;
+
+        /*  The directory of tile files. Empty to keep tiles in memory only.  */
+        std::string dir;
+
+        /*  The most tiles held in memory.                                    */
+        std::size_t capacity;
+
+        /*  The tiles in memory, most recently used first, and by name.       */
+        entry_list recent;
+        std::map<std::string, entry_list::iterator> index;
+
+        /*  Tiles found in memory, found on disk, and not found at all.       */
+        std::atomic<unsigned long int> memory_hits, disk_hits, misses;
+
+        /*  Numbers the temporary files, so threads do not share one.         */
+        std::atomic<unsigned long int> writes;
+
+        tile_cache(const char *d, std::size_t cap)
+            : dir(d ? d : ""), capacity(cap), memory_hits(0UL),
+              disk_hits(0UL), misses(0UL), writes(0UL)
+        {
+            if (!dir.empty())
+                ::mkdir(dir.c_str(), 0755);
+        }
+
+        /*  Copies the tile "name" into fb, which must already have the size  *
+         *  of a tile. Returns false if it is neither in memory nor on disk.  */
+        inline bool find(const std::string &name, framebuffer &fb)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                const std::map<std::string, entry_list::iterator>::iterator
+                    it = index.find(name);
+
+                if (it != index.end())
+                {
+                    recent.splice(recent.begin(), recent, it->second);
+                    fb.data = it->second->second.data;
+                    ++memory_hits;
+                    return true;
+                }
+            }
+
+            if (dir.empty() || !read(name, fb))
+            {
+                ++misses;
+                return false;
+            }
+
+            ++disk_hits;
+            remember(name, fb);
+            return true;
+        }
+
+        /*  Adds a newly rendered tile, in memory and on disk.                */
+        inline void insert(const std::string &name, const framebuffer &fb)
+        {
+            if (!dir.empty())
+                write(name, fb);
+
+            remember(name, fb);
+        }
+
+        /*  Puts a copy of the tile in front, dropping the least recently     *
+         *  used tile if memory is full.                                      */
+        inline void remember(const std::string &name, const framebuffer &fb)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            if (capacity == 0U || index.count(name))
+                return;
+
+            if (recent.size() >= capacity)
+            {
+                index.erase(recent.back().first);
+                recent.pop_back();
+            }
+
+            recent.push_front(entry(name, fb));
+            index[name] = recent.begin();
+        }
+
+        /*  Reads the tile file "name" into fb if it has fb's size.           */
+        inline bool read(const std::string &name, framebuffer &fb) const
+        {
+            const std::string path = dir + "/" + name;
+            FILE *fp = std::fopen(path.c_str(), "rb");
+            unsigned int x, y, max_value;
+            bool success;
+
+            if (!fp)
+                return false;
+
+            success = std::fscanf(fp, "P6 %u %u %u", &x, &y, &max_value) == 3 &&
+                      x == fb.xsize && y == fb.ysize && max_value == 255U &&
+                      std::fgetc(fp) != EOF &&
+                      std::fread(fb.row(0U), 1UL, fb.size(), fp) == fb.size();
+
+            std::fclose(fp);
+            return success;
+        }
+
+        /*  Writes the tile file "name" under a temporary name, then renames  *
+         *  it. A failure only costs the disk copy, with a message.           */
+        inline void write(const std::string &name, const framebuffer &fb)
+        {
+            const std::string path = dir + "/" + name;
+            char suffix[32];
+            std::string temporary;
+            FILE *fp;
+            bool success;
+
+            std::snprintf(suffix, sizeof(suffix), ".%lu.tmp", writes++);
+            temporary = path + suffix;
+            fp = std::fopen(temporary.c_str(), "wb");
+
+            if (!fp)
+            {
+                std::fprintf(stderr, "Could not write %s.\n", path.c_str());
+                return;
+            }
+
+            std::fprintf(fp, "P6\n%u %u\n255\n", fb.xsize, fb.ysize);
+            success =
+                std::fwrite(fb.row(0U), 1UL, fb.size(), fp) == fb.size();
+            success = (std::fclose(fp) == 0) && success;
+
+            if (!success || std::rename(temporary.c_str(), path.c_str()))
+            {
+                std::fprintf(stderr, "Could not write %s.\n", path.c_str());
+                std::remove(temporary.c_str());
+            }
+        }
+    };
+
+    /**************************************************************************
+     *  Function:                                                             *
+     *      pyramid_tile                                                      *
+     *  Purpose:                                                              *
+     *      Gets a tile of the pyramid from the cache, or renders it and adds *
+     *      it to the cache.                                                  *
+     *  Template Parameters:                                                  *
+     *      Poly:                                                             *
+     *          The polynomial, see qnf_polynomial.hpp.                       *
+     *      Colorer:                                                          *
+     *          The coloring policy, see qnf_colorer.hpp.                     *
+     *  Arguments:                                                            *
+     *      pool (qnf::thread_pool &):                                        *
+     *          Threads the pixels of a new tile are spread over.             *
+     *      colorer (const Colorer &):                                        *
+     *          Colors the pixels.                                            *
+     *      cache (qnf::tile_cache &):                                        *
+     *          The tiles rendered so far.                                    *
+     *      a (const qnf::tile_address &):                                    *
+     *          The tile. Its tag must stand for Poly, Colorer and opts.      *
+     *      opts (const qnf::render_options &):                               *
+     *          The window of level 0 and its size, which every tile has,     *
+     *          and the convergence parameters.                               *
+     *      fb (qnf::framebuffer &):                                          *
+     *          Receives the tile. Resized to the window if needed.           *
+     *  Output:                                                               *
+     *      rendered (bool):                                                  *
+     *          True if the tile was rendered, false if it came from the      *
+     *          cache or does not exist (see tile_address::valid).            *
+     **************************************************************************/
+    template <class Poly, class Colorer>
+    inline bool pyramid_tile(thread_pool &pool, const Colorer &colorer,
+                             tile_cache &cache, const tile_address &a,
+                             const render_options &opts, framebuffer &fb)
+    {
+        const std::string name = a.name();
+
+        if (!a.valid())
+            return false;
+
+        if (fb.xsize != opts.window.xsize || fb.ysize != opts.window.ysize ||
+            fb.first_row != 0U)
+            fb = framebuffer(opts.window.xsize, opts.window.ysize);
+
+        if (cache.find(name, fb))
+            return false;
+
+        render_view<Poly>(pool, colorer, a.tile_view(opts.window), opts, fb);
+        cache.insert(name, fb);
+        return true;
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -34,22 +34,24 @@
 /*  Namespace for the project. "Quaternion Newton Fractal."                   */
 namespace qnf {
 
-    /*  Struct for working with quaternions.                                  */
-    struct quaternion {
+    /*  Struct for working with quaternions with components of type T,        *
+     *  float or double. qnf::quaternion is the double precision version.     */
+    template <class T>
+    struct basic_quaternion {
         /*  Contiguous array for the four components of a quaternion.         */
-        double dat[4];
+        T dat[4];
 
         /*  Empty constructor. Set the quaternion to the origin.              */
-        quaternion(void)
+        basic_quaternion(void)
         {
-            dat[0] = 0.0;
-            dat[1] = 0.0;
-            dat[2] = 0.0;
-            dat[3] = 0.0;
+            dat[0] = T(0);
+            dat[1] = T(0);
+            dat[2] = T(0);
+            dat[3] = T(0);
         }
 
         /*  Constructor from four real numbers, the individual components.    */
-        quaternion(double a, double x, double y, double z)
+        basic_quaternion(T a, T x, T y, T z)
         {
             dat[0] = a;
             dat[1] = x;
@@ -57,18 +59,30 @@ namespace qnf {
             dat[3] = z;
         }
 
+        /*  Conversion from the other precision, rounding each component.     *
+         *  Implicit, so double constants like j in the polynomials can be    *
+         *  used with single precision quaternions as well.                   */
+        template <class U>
+        basic_quaternion(const basic_quaternion<U> &q)
+        {
+            dat[0] = static_cast<T>(q.dat[0]);
+            dat[1] = static_cast<T>(q.dat[1]);
+            dat[2] = static_cast<T>(q.dat[2]);
+            dat[3] = static_cast<T>(q.dat[3]);
+        }
+
         /*  Quaternion addition, which is vector addition in R^4.             */
-        inline quaternion operator + (const quaternion &q) const
+        inline basic_quaternion operator + (const basic_quaternion &q) const
         {
-            const double a = dat[0] + q.dat[0];
-            const double x = dat[1] + q.dat[1];
-            const double y = dat[2] + q.dat[2];
-            const double z = dat[3] + q.dat[3];
-            return quaternion(a, x, y, z);
+            const T a = dat[0] + q.dat[0];
+            const T x = dat[1] + q.dat[1];
+            const T y = dat[2] + q.dat[2];
+            const T z = dat[3] + q.dat[3];
+            return basic_quaternion(a, x, y, z);
         }
 
         /*  Quaternion addition, storing the result in the left-hand side.    */
-        inline quaternion & operator += (const quaternion &q)
+        inline basic_quaternion & operator += (const basic_quaternion &q)
         {
             dat[0] += q.dat[0];
             dat[1] += q.dat[1];
@@ -78,17 +92,17 @@ namespace qnf {
         }
 
         /*  Quaternion subtraction, which is vector subtraction in R^4.       */
-        inline quaternion operator - (const quaternion &q) const
+        inline basic_quaternion operator - (const basic_quaternion &q) const
         {
-            const double a = dat[0] - q.dat[0];
-            const double x = dat[1] - q.dat[1];
-            const double y = dat[2] - q.dat[2];
-            const double z = dat[3] - q.dat[3];
-            return quaternion(a, x, y, z);
+            const T a = dat[0] - q.dat[0];
+            const T x = dat[1] - q.dat[1];
+            const T y = dat[2] - q.dat[2];
+            const T z = dat[3] - q.dat[3];
+            return basic_quaternion(a, x, y, z);
         }
 
         /*  Quaternion subtraction, storing the result in the left-hand side. */
-        inline quaternion & operator -= (const quaternion &q)
+        inline basic_quaternion & operator -= (const basic_quaternion &q)
         {
             dat[0] -= q.dat[0];
             dat[1] -= q.dat[1];
@@ -98,39 +112,39 @@ namespace qnf {
         }
 
         /*  Addition with a real number. Adds to the real part.               */
-        inline quaternion operator + (double a) const
+        inline basic_quaternion operator + (T a) const
         {
-            return quaternion(dat[0] + a, dat[1], dat[2], dat[3]);
+            return basic_quaternion(dat[0] + a, dat[1], dat[2], dat[3]);
         }
 
         /*  Addition with a real number storing the result in *this.          */
-        inline quaternion & operator += (double a)
+        inline basic_quaternion & operator += (T a)
         {
             dat[0] += a;
             return *this;
         }
 
         /*  Subtraction with a real number. Subtracts from the real part.     */
-        inline quaternion operator - (double a) const
+        inline basic_quaternion operator - (T a) const
         {
-            return quaternion(dat[0] - a, dat[1], dat[2], dat[3]);
+            return basic_quaternion(dat[0] - a, dat[1], dat[2], dat[3]);
         }
 
         /*  Subtraction with a real number storing the result in *this.       */
-        inline quaternion & operator -= (double a)
+        inline basic_quaternion & operator -= (T a)
         {
             dat[0] -= a;
             return *this;
         }
 
         /*  Scalar multiplication, which is computed component-wise.          */
-        inline quaternion operator * (double a) const
+        inline basic_quaternion operator * (T a) const
         {
-            return quaternion(a*dat[0], a*dat[1], a*dat[2], a*dat[3]);
+            return basic_quaternion(a*dat[0], a*dat[1], a*dat[2], a*dat[3]);
         }
 
         /*  Scalar multiplication, storing the result in *this.               */
-        inline quaternion & operator *= (double a)
+        inline basic_quaternion & operator *= (T a)
         {
             dat[0] *= a;
             dat[1] *= a;
@@ -140,20 +154,20 @@ namespace qnf {
         }
 
         /*  Division by a scalar. Performed component-wise.                   */
-        inline quaternion operator / (double r) const
+        inline basic_quaternion operator / (T r) const
         {
-            const double factor = 1.0 / r;
-            const double a = dat[0] * factor;
-            const double x = dat[1] * factor;
-            const double y = dat[2] * factor;
-            const double z = dat[3] * factor;
-            return quaternion(a, x, y, z);
+            const T factor = T(1) / r;
+            const T a = dat[0] * factor;
+            const T x = dat[1] * factor;
+            const T y = dat[2] * factor;
+            const T z = dat[3] * factor;
+            return basic_quaternion(a, x, y, z);
         }
 
         /*  Division by a scalar. Performed component-wise.                   */
-        inline quaternion & operator /= (double r)
+        inline basic_quaternion & operator /= (T r)
         {
-            const double factor = 1.0 / r;
+            const T factor = T(1) / r;
             dat[0] *= factor;
             dat[1] *= factor;
             dat[2] *= factor;
@@ -164,35 +178,35 @@ namespace qnf {
         /*  Quaternion multiplication. Requires 16 real multiplications. I do *
          *  not know if this can be improved. Other libraries (Boost in C++,  *
          *  quaternion in C) also use 16 multiplications, so perhaps not.     */
-         inline quaternion operator * (const quaternion &q) const
+         inline basic_quaternion operator * (const basic_quaternion &q) const
          {
                 /*  The real part of the product.                             */
-                const double a = dat[0]*q.dat[0] - dat[1]*q.dat[1] -
+                const T a = dat[0]*q.dat[0] - dat[1]*q.dat[1] -
                                  dat[2]*q.dat[2] - dat[3]*q.dat[3];
 
                 /*  The "i", or first imaginary, part of the product.         */
-                const double x = dat[0]*q.dat[1] + dat[1]*q.dat[0] +
+                const T x = dat[0]*q.dat[1] + dat[1]*q.dat[0] +
                                  dat[2]*q.dat[3] - dat[3]*q.dat[2];
 
                 /*  The "j", or second imaginary, part of the product.        */
-                const double y = dat[0]*q.dat[2] - dat[1]*q.dat[3] +
+                const T y = dat[0]*q.dat[2] - dat[1]*q.dat[3] +
                                  dat[2]*q.dat[0] + dat[3]*q.dat[1];
 
                 /*  The "k", or third imaginary, part of the product.         */
-                const double z = dat[0]*q.dat[3] + dat[1]*q.dat[2] -
+                const T z = dat[0]*q.dat[3] + dat[1]*q.dat[2] -
                                  dat[2]*q.dat[1] + dat[3]*q.dat[0];
 
-                return quaternion(a, x, y, z);
+                return basic_quaternion(a, x, y, z);
          }
 
         /*  Multiplication where the product is stored in the left-hand side. */
-        inline quaternion & operator *= (const quaternion &q)
+        inline basic_quaternion & operator *= (const basic_quaternion &q)
         {
             /*  Avoid overwriting data. Copy the components of *this.         */
-            const double a = dat[0];
-            const double x = dat[1];
-            const double y = dat[2];
-            const double z = dat[3];
+            const T a = dat[0];
+            const T x = dat[1];
+            const T y = dat[2];
+            const T z = dat[3];
 
             /*  Perform the quaternion product and store the result in *this. */
             dat[0] = a*q.dat[0] - x*q.dat[1] - y*q.dat[2] - z*q.dat[3];
@@ -204,34 +218,34 @@ namespace qnf {
         }
 
         /*  The square of the Euclidean norm (R^4 norm) of a quaternion.      */
-        inline double norm_sq(void) const
+        inline T norm_sq(void) const
         {
             return dat[0]*dat[0]+dat[1]*dat[1]+dat[2]*dat[2]+dat[3]*dat[3];
         }
 
         /*  The Euclidean norm (R^4 norm) of a quaternion.                    */
-        inline double norm(void) const
+        inline T norm(void) const
         {
             return std::sqrt(this->norm_sq());
         }
 
         /*  Computes the square of a quaternion. Saves on redundant           *
          *  multiplications due to cancellations.                             */
-        inline quaternion square(void) const
+        inline basic_quaternion square(void) const
         {
-            const double a = dat[0]*dat[0] - dat[1]*dat[1] -
+            const T a = dat[0]*dat[0] - dat[1]*dat[1] -
                              dat[2]*dat[2] - dat[3]*dat[3];
-            const double x = 2.0*dat[0]*dat[1];
-            const double y = 2.0*dat[0]*dat[2];
-            const double z = 2.0*dat[0]*dat[3];
-            return quaternion(a, x, y, z);
+            const T x = T(2)*dat[0]*dat[1];
+            const T y = T(2)*dat[0]*dat[2];
+            const T z = T(2)*dat[0]*dat[3];
+            return basic_quaternion(a, x, y, z);
         }
 
         /*  Comptutes the square and stores it in the input.                  */
         inline void square_self(void)
         {
-            const double a = dat[0];
-            const double two_a = 2.0*a;
+            const T a = dat[0];
+            const T two_a = T(2)*a;
             dat[0] = a*a - dat[1]*dat[1] - dat[2]*dat[2] - dat[3]*dat[3];
             dat[1] *= two_a;
             dat[2] *= two_a;
@@ -239,34 +253,34 @@ namespace qnf {
         }
 
         /*  Cubes a quaternion, saving on many redundant multiplications.     */
-        inline quaternion cube(void) const
+        inline basic_quaternion cube(void) const
         {
-            const double rsq = dat[0]*dat[0];
-            const double vsq = dat[1]*dat[1] + dat[2]*dat[2] + dat[3]*dat[3];
-            const double factor = 3.0*rsq - vsq;
-            const double a = (rsq - 3.0*vsq) * dat[0];
-            const double x = factor * dat[1];
-            const double y = factor * dat[2];
-            const double z = factor * dat[3];
-            return quaternion(a, x, y, z);
+            const T rsq = dat[0]*dat[0];
+            const T vsq = dat[1]*dat[1] + dat[2]*dat[2] + dat[3]*dat[3];
+            const T factor = T(3)*rsq - vsq;
+            const T a = (rsq - T(3)*vsq) * dat[0];
+            const T x = factor * dat[1];
+            const T y = factor * dat[2];
+            const T z = factor * dat[3];
+            return basic_quaternion(a, x, y, z);
         }
 
         /*  Cubes a quaternion and stores the result in *this.                */
         inline void cube_self(void)
         {
-            const double rsq = dat[0]*dat[0];
-            const double vsq = dat[1]*dat[1] + dat[2]*dat[2] + dat[3]*dat[3];
-            const double factor = 3.0*rsq - vsq;
-            dat[0] *= (rsq - 3.0*vsq);
+            const T rsq = dat[0]*dat[0];
+            const T vsq = dat[1]*dat[1] + dat[2]*dat[2] + dat[3]*dat[3];
+            const T factor = T(3)*rsq - vsq;
+            dat[0] *= (rsq - T(3)*vsq);
             dat[1] *= factor;
             dat[2] *= factor;
             dat[3] *= factor;
         }
 
         /*  Computes the quaternion conjugate, which negates imaginary parts. */
-        inline quaternion conjugate(void) const
+        inline basic_quaternion conjugate(void) const
         {
-            return quaternion(dat[0], -dat[1], -dat[2], -dat[3]);
+            return basic_quaternion(dat[0], -dat[1], -dat[2], -dat[3]);
         }
 
         /*  Conjugates *this and stores the result in *this.                  */
@@ -277,20 +291,20 @@ namespace qnf {
             dat[3] = -dat[3];
         }
 
-        inline quaternion reciprocal(void) const
+        inline basic_quaternion reciprocal(void) const
         {
-            const double factor = 1.0 / this->norm_sq();
-            const double a = factor * dat[0];
-            const double x = -factor * dat[1];
-            const double y = -factor * dat[2];
-            const double z = -factor * dat[3];
-            return quaternion(a, x, y, z);
+            const T factor = T(1) / this->norm_sq();
+            const T a = factor * dat[0];
+            const T x = -factor * dat[1];
+            const T y = -factor * dat[2];
+            const T z = -factor * dat[3];
+            return basic_quaternion(a, x, y, z);
         }
 
         inline void reciprocate(void)
         {
-            const double factor = 1.0 / this->norm_sq();
-            const double neg_factor = -factor;
+            const T factor = T(1) / this->norm_sq();
+            const T neg_factor = -factor;
             dat[0] *= factor;
             dat[1] *= neg_factor;
             dat[2] *= neg_factor;
@@ -298,48 +312,53 @@ namespace qnf {
         }
 
         /*  Quaternion division. Requires 16 real multiplications.            */
-         inline quaternion operator / (const quaternion &q) const
+         inline basic_quaternion operator / (const basic_quaternion &q) const
          {
                 /*  The real part of the product.                             */
-                const double a = dat[0]*q.dat[0] + dat[1]*q.dat[1] +
+                const T a = dat[0]*q.dat[0] + dat[1]*q.dat[1] +
                                  dat[2]*q.dat[2] + dat[3]*q.dat[3];
 
                 /*  The "i", or first imaginary, part of the product.         */
-                const double x = -dat[0]*q.dat[1] + dat[1]*q.dat[0] -
+                const T x = -dat[0]*q.dat[1] + dat[1]*q.dat[0] -
                                   dat[2]*q.dat[3] + dat[3]*q.dat[2];
 
                 /*  The "j", or second imaginary, part of the product.        */
-                const double y = -dat[0]*q.dat[2] + dat[1]*q.dat[3] +
+                const T y = -dat[0]*q.dat[2] + dat[1]*q.dat[3] +
                                   dat[2]*q.dat[0] - dat[3]*q.dat[1];
 
                 /*  The "k", or third imaginary, part of the product.         */
-                const double z = -dat[0]*q.dat[3] - dat[1]*q.dat[2] +
+                const T z = -dat[0]*q.dat[3] - dat[1]*q.dat[2] +
                                   dat[2]*q.dat[1] + dat[3]*q.dat[0];
 
-                const double factor = 1.0 / q.norm_sq();
-                return quaternion(a*factor, x*factor, y*factor, z*factor);
+                const T factor = T(1) / q.norm_sq();
+                return basic_quaternion(a*factor, x*factor, y*factor, z*factor);
          }
 
         /*  Normalizes *this to unit magnitude.                               */
-        inline quaternion normalize(void) const
+        inline basic_quaternion normalize(void) const
         {
-            const double factor = 1.0 / this->norm();
-            const double a = dat[0] * factor;
-            const double x = dat[1] * factor;
-            const double y = dat[2] * factor;
-            const double z = dat[3] * factor;
-            return quaternion(a, x, y, z);
+            const T factor = T(1) / this->norm();
+            const T a = dat[0] * factor;
+            const T x = dat[1] * factor;
+            const T y = dat[2] * factor;
+            const T z = dat[3] * factor;
+            return basic_quaternion(a, x, y, z);
         }
     };
-    /*  End of quaternion struct.                                             */
+    /*  End of basic_quaternion struct.                                       */
+
+    /*  Double and single precision quaternions.                              */
+    typedef basic_quaternion<double> quaternion;
+    typedef basic_quaternion<float> quaternionf;
 
     /*  Quaternion metric induced by the quaternion norm.                     */
-    inline double dist(const quaternion &q, const quaternion &p)
+    template <class T>
+    inline T dist(const basic_quaternion<T> &q, const basic_quaternion<T> &p)
     {
-        const double da = q.dat[0] - p.dat[0];
-        const double dx = q.dat[1] - p.dat[1];
-        const double dy = q.dat[2] - p.dat[2];
-        const double dz = q.dat[3] - p.dat[3];
+        const T da = q.dat[0] - p.dat[0];
+        const T dx = q.dat[1] - p.dat[1];
+        const T dy = q.dat[2] - p.dat[2];
+        const T dz = q.dat[3] - p.dat[3];
         return std::sqrt(da*da + dx*dx + dy*dy + dz*dz);
     }
 }
@@ -0,0 +1,233 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a structure-of-arrays batch of quaternions so that several   *
+ *      pixels can run Newton's method at once in SIMD registers.             *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_QUATERNION_BATCH_HPP
+#define QNF_QUATERNION_BATCH_HPP
+
+/*  The scalar quaternion struct, used for loading and storing lanes.         */
+#include "qnf_quaternion.hpp"
+
+/*  SIMD registers and masks.                                                 */
+#include "qnf_simd.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      basic_quaternion_batch                                            *
+     *  Purpose:                                                              *
+     *      V::width quaternions stored as structure-of-arrays. The real      *
+     *      parts share one register, the i parts another, and so on, so      *
+     *      each scalar formula in qnf::quaternion becomes the same formula   *
+     *      on whole registers. The interface mirrors qnf::quaternion, which  *
+     *      lets the same Newton expression run on either type. V is          *
+     *      simd::vec for doubles (quaternion_batch) and simd::vecf for       *
+     *      floats (quaternion_batchf), or their counterparts of another back *
+     *      end in qnf_simd.hpp.                                              *
+     **************************************************************************/
+    template <class V>
+    struct basic_quaternion_batch {
+        typedef V vec_type;
+        typedef typename simd::traits<V>::scalar scalar;
+        typedef typename simd::traits<V>::mask mask_type;
+
+        V a, x, y, z;
+
+        static const unsigned int width = V::width;
+
+        /*  Number of components, the arrays load and store take.             */
+        static const unsigned int dims = 4U;
+
+        basic_quaternion_batch(void) { return; }
+
+        basic_quaternion_batch(const V &a0, const V &x0,
+                               const V &y0, const V &z0)
+            : a(a0), x(x0), y(y0), z(z0)
+        {
+            return;
+        }
+
+        /*  Lanes first to first + width - 1 of the components c[0] (real     *
+         *  parts) to c[3] (k parts).                                         */
+        static inline basic_quaternion_batch
+        load(const scalar *const *c, unsigned int first)
+        {
+            return basic_quaternion_batch(V::load(c[0] + first),
+                                          V::load(c[1] + first),
+                                          V::load(c[2] + first),
+                                          V::load(c[3] + first));
+        }
+
+        /*  Stores the lanes back to where load took them from.               */
+        inline void store(scalar *const *c, unsigned int first) const
+        {
+            simd::store(c[0] + first, a);
+            simd::store(c[1] + first, x);
+            simd::store(c[2] + first, y);
+            simd::store(c[3] + first, z);
+        }
+
+        /*  The same quaternion in every lane.                                */
+        explicit basic_quaternion_batch(const basic_quaternion<scalar> &q)
+            : a(q.dat[0]), x(q.dat[1]), y(q.dat[2]), z(q.dat[3])
+        {
+            return;
+        }
+
+        /*  Lane-wise quaternion addition.                                    */
+        inline basic_quaternion_batch
+        operator + (const basic_quaternion_batch &q) const
+        {
+            return basic_quaternion_batch(a + q.a, x + q.x, y + q.y, z + q.z);
+        }
+
+        /*  Lane-wise quaternion subtraction.                                 */
+        inline basic_quaternion_batch
+        operator - (const basic_quaternion_batch &q) const
+        {
+            return basic_quaternion_batch(a - q.a, x - q.x, y - q.y, z - q.z);
+        }
+
+        /*  Adds the same quaternion to every lane.                           */
+        inline basic_quaternion_batch
+        operator + (const basic_quaternion<scalar> &q) const
+        {
+            return *this + basic_quaternion_batch(q);
+        }
+
+        /*  Subtracts the same quaternion from every lane.                    */
+        inline basic_quaternion_batch
+        operator - (const basic_quaternion<scalar> &q) const
+        {
+            return *this - basic_quaternion_batch(q);
+        }
+
+        /*  Addition with a real number. Adds to the real parts.              */
+        inline basic_quaternion_batch operator + (scalar r) const
+        {
+            return basic_quaternion_batch(a + V(r), x, y, z);
+        }
+
+        /*  Subtraction with a real number.                                   */
+        inline basic_quaternion_batch operator - (scalar r) const
+        {
+            return basic_quaternion_batch(a - V(r), x, y, z);
+        }
+
+        /*  Scalar multiplication, computed component-wise.                   */
+        inline basic_quaternion_batch operator * (scalar r) const
+        {
+            const V s(r);
+            return basic_quaternion_batch(s*a, s*x, s*y, s*z);
+        }
+
+        /*  Quaternion multiplication, lane by lane. Same formula as          *
+         *  quaternion::operator *.                                           */
+        inline basic_quaternion_batch
+        operator * (const basic_quaternion_batch &q) const
+        {
+            const V a0 = a*q.a - x*q.x - y*q.y - z*q.z;
+            const V x0 = a*q.x + x*q.a + y*q.z - z*q.y;
+            const V y0 = a*q.y - x*q.z + y*q.a + z*q.x;
+            const V z0 = a*q.z + x*q.y - y*q.x + z*q.a;
+            return basic_quaternion_batch(a0, x0, y0, z0);
+        }
+
+        /*  The square of the Euclidean norm of each quaternion.              */
+        inline V norm_sq(void) const
+        {
+            return a*a + x*x + y*y + z*z;
+        }
+
+        /*  Squares each quaternion. Same formula as quaternion::square.      */
+        inline basic_quaternion_batch square(void) const
+        {
+            const V two(2.0);
+            const V a0 = a*a - x*x - y*y - z*z;
+            const V two_a = two*a;
+            return basic_quaternion_batch(a0, two_a*x, two_a*y, two_a*z);
+        }
+
+        /*  Cubes each quaternion. Same formula as quaternion::cube.          */
+        inline basic_quaternion_batch cube(void) const
+        {
+            const V three(3.0);
+            const V rsq = a*a;
+            const V vsq = x*x + y*y + z*z;
+            const V factor = three*rsq - vsq;
+            const V a0 = (rsq - three*vsq) * a;
+            return basic_quaternion_batch(a0, factor*x, factor*y, factor*z);
+        }
+
+        /*  Quaternion division *this * q^-1, lane by lane.                   */
+        inline basic_quaternion_batch
+        operator / (const basic_quaternion_batch &q) const
+        {
+            const V neg_a = -a;
+            const V a0 = a*q.a + x*q.x + y*q.y + z*q.z;
+            const V x0 = neg_a*q.x + x*q.a - y*q.z + z*q.y;
+            const V y0 = neg_a*q.y + x*q.z + y*q.a - z*q.x;
+            const V z0 = neg_a*q.z - x*q.y + y*q.x + z*q.a;
+            const V factor = V(1.0) / q.norm_sq();
+            return basic_quaternion_batch(a0*factor, x0*factor,
+                                          y0*factor, z0*factor);
+        }
+
+        /*  Lane-wise m ? p : q.                                              */
+        static inline basic_quaternion_batch
+        select(const mask_type &m, const basic_quaternion_batch &p,
+               const basic_quaternion_batch &q)
+        {
+            return basic_quaternion_batch(simd::select(m, p.a, q.a),
+                                          simd::select(m, p.x, q.x),
+                                          simd::select(m, p.y, q.y),
+                                          simd::select(m, p.z, q.z));
+        }
+
+        /*  Copies lane n out as a scalar quaternion.                         */
+        inline basic_quaternion<scalar> lane(unsigned int n) const
+        {
+            scalar da[width], dx[width], dy[width], dz[width];
+            simd::store(da, a);
+            simd::store(dx, x);
+            simd::store(dy, y);
+            simd::store(dz, z);
+            return basic_quaternion<scalar>(da[n], dx[n], dy[n], dz[n]);
+        }
+    };
+    /*  End of basic_quaternion_batch struct.                                 */
+
+    /*  Batches of doubles and of floats.                                     */
+    typedef basic_quaternion_batch<simd::vec> quaternion_batch;
+    typedef basic_quaternion_batch<simd::vecf> quaternion_batchf;
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,336 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the per-pixel result files: the end of every orbit of a      *
+ *      frame, stored in a memory-mapped file so the frames can be colored    *
+ *      again later without running Newton's method.                          *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_RESULT_HPP
+#define QNF_RESULT_HPP
+
+/*  snprintf, and the error messages.                                         */
+#include <cstdio>
+
+/*  memcmp, memcpy and strncpy, for the header.                               */
+#include <cstring>
+
+/*  open, ftruncate, mmap and friends. POSIX, like popen in qnf_output.hpp.  */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*  The final points are quaternions.                                         */
+#include "qnf_quaternion.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      pixel_result                                                      *
+     *  Purpose:                                                              *
+     *      The end of the orbit of one pixel, 24 bytes. Everything a         *
+     *      colorer is given, plus what a palette might want besides.         *
+     *  Notes:                                                                *
+     *      The point is stored in single precision, enough for the angles    *
+     *      the colorers use, so colors from a result file may differ from    *
+     *      the rendered ones by a level where an angle lies within 1E-7 of a *
+     *      step of the gradient. The residual is rounded down, so an orbit   *
+     *      that converged still counts as converged for the same eps.        *
+     **************************************************************************/
+    struct pixel_result {
+
+        /*  The final point of the orbit.                                     */
+        float q[4];
+
+        /*  |p(q)|^2 at the final point, infinite if it did not converge.     */
+        float p_norm_sq;
+
+        /*  Number of Newton steps taken. For pixels looked up in the basin   *
+         *  table, the count interpolated from the table's nodes.             */
+        unsigned short iters;
+
+        /*  0 if the orbit did not converge, 1 + k for a real polynomial's    *
+         *  root Poly::root(k) (the one with non-negative imaginary part of   *
+         *  each conjugate pair, since x + yn and x - yn lie on the same      *
+         *  sphere of roots), and unknown_root when the roots are not known.  */
+        unsigned char root;
+        unsigned char reserved;
+
+        enum {
+            unknown_root = 0xFF
+        };
+
+        /*  Packs the final point, the residual, the number of steps and the  *
+         *  root index.                                                       */
+        inline void set(const quaternion &q0, double p_norm_sq0,
+                        unsigned int iters0, unsigned int root0)
+        {
+            float p = static_cast<float>(p_norm_sq0);
+
+            /*  Round the residual down, not to nearest.                      */
+            if (static_cast<double>(p) > p_norm_sq0)
+                p = nextafter_down(p);
+
+            q[0] = static_cast<float>(q0.dat[0]);
+            q[1] = static_cast<float>(q0.dat[1]);
+            q[2] = static_cast<float>(q0.dat[2]);
+            q[3] = static_cast<float>(q0.dat[3]);
+            p_norm_sq = p;
+            iters = static_cast<unsigned short>(iters0 > 0xFFFFU ? 0xFFFFU
+                                                                 : iters0);
+            root = static_cast<unsigned char>(root0);
+            reserved = 0U;
+        }
+
+        /*  The final point in double precision.                              */
+        inline quaternion point(void) const
+        {
+            return quaternion(q[0], q[1], q[2], q[3]);
+        }
+
+        /*  The residual in double precision.                                 */
+        inline double residual(void) const
+        {
+            return static_cast<double>(p_norm_sq);
+        }
+
+        /*  The largest float below a positive, finite p.                     */
+        static inline float nextafter_down(float p)
+        {
+            unsigned int bits;
+            std::memcpy(&bits, &p, sizeof(bits));
+            bits -= 1U;
+            std::memcpy(&p, &bits, sizeof(bits));
+            return p;
+        }
+    };
+
+    /*  The first bytes of every result file.                                 */
+    struct result_header {
+
+        /*  "QNFR" followed by the version of the layout.                     */
+        char magic[4];
+        unsigned int version;
+
+        /*  Size of the frame, and its place in the rotation.                 */
+        unsigned int xsize, ysize;
+        unsigned int frame, n_frames;
+
+        /*  Size of one pixel_result, to catch mismatched builds.             */
+        unsigned int record_size;
+
+        /*  The convergence parameters the frame was rendered with.           */
+        unsigned int max_iters;
+        double eps_sq;
+
+        /*  The name of the polynomial, NUL padded.                           */
+        char poly[16];
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      result_file                                                       *
+     *  Purpose:                                                              *
+     *      A result_header followed by xsize*ysize pixel results in row      *
+     *      major order, mapped into memory. Kernels write the records of     *
+     *      a frame straight into the mapping as they color the pixels, and   *
+     *      the recolor pass reads them back.                                 *
+     **************************************************************************/
+    struct result_file {
+        result_header *header;
+        pixel_result *records;
+        std::size_t length;
+
+        result_file(void) : header(0), records(0), length(0U)
+        {
+            return;
+        }
+
+        ~result_file(void)
+        {
+            close();
+        }
+
+        /*  The name of the file of frame "frame" in the directory "dir".     */
+        static inline void name(char *out, std::size_t size, const char *dir,
+                                unsigned int frame)
+        {
+            std::snprintf(out, size, "%s/result_%03u.qnr", dir, frame);
+        }
+
+        /*  Creates (or replaces) the file for a frame and maps it for        *
+         *  writing. Returns false, with a message, on failure.               */
+        inline bool create(const char *dir, const result_header &h)
+        {
+            char path[4096];
+            int fd;
+
+            close();
+            name(path, sizeof(path), dir, h.frame);
+            length = sizeof(result_header) +
+                     sizeof(pixel_result) * std::size_t(h.xsize) * h.ysize;
+
+            fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+            if (fd < 0)
+            {
+                std::printf("ERROR: Could not create %s.\n", path);
+                return false;
+            }
+
+            if (::ftruncate(fd, static_cast<off_t>(length)) != 0)
+            {
+                std::printf("ERROR: Could not resize %s.\n", path);
+                ::close(fd);
+                return false;
+            }
+
+            if (!map(fd, PROT_READ | PROT_WRITE))
+            {
+                std::printf("ERROR: Could not map %s.\n", path);
+                return false;
+            }
+
+            *header = h;
+            return true;
+        }
+
+        /*  Maps the file of a frame for reading and checks its header.       */
+        inline bool open(const char *dir, unsigned int frame)
+        {
+            char path[4096];
+            struct stat st;
+            int fd;
+
+            close();
+            name(path, sizeof(path), dir, frame);
+            fd = ::open(path, O_RDONLY);
+
+            if (fd < 0)
+            {
+                std::printf("ERROR: Could not open %s.\n", path);
+                return false;
+            }
+
+            if (::fstat(fd, &st) != 0 ||
+                st.st_size < static_cast<off_t>(sizeof(result_header)))
+            {
+                std::printf("ERROR: %s is not a result file.\n", path);
+                ::close(fd);
+                return false;
+            }
+
+            length = static_cast<std::size_t>(st.st_size);
+
+            if (!map(fd, PROT_READ))
+            {
+                std::printf("ERROR: Could not map %s.\n", path);
+                return false;
+            }
+
+            if (std::memcmp(header->magic, "QNFR", 4U) != 0 ||
+                header->version != 1U ||
+                header->record_size != sizeof(pixel_result) ||
+                length != sizeof(result_header) + sizeof(pixel_result) *
+                          std::size_t(header->xsize) * header->ysize)
+            {
+                std::printf("ERROR: %s is not a result file of this "
+                            "version.\n", path);
+                close();
+                return false;
+            }
+
+            return true;
+        }
+
+        /*  Unmaps the file. Changes reach the file when the mapping goes.    */
+        inline void close(void)
+        {
+            if (header)
+                ::munmap(header, length);
+
+            header = 0;
+            records = 0;
+            length = 0U;
+        }
+
+        /*  The record of the pixel (x, y).                                   */
+        inline pixel_result &at(unsigned int x, unsigned int y)
+        {
+            return records[std::size_t(y) * header->xsize + x];
+        }
+
+        inline const pixel_result &at(unsigned int x, unsigned int y) const
+        {
+            return records[std::size_t(y) * header->xsize + x];
+        }
+
+    private:
+
+        /*  Maps the open descriptor fd, then closes it.                      */
+        inline bool map(int fd, int protection)
+        {
+            void *p = ::mmap(0, length, protection, MAP_SHARED, fd, 0);
+            ::close(fd);
+
+            if (p == MAP_FAILED)
+                return false;
+
+            header = static_cast<result_header *>(p);
+            records = reinterpret_cast<pixel_result *>(header + 1);
+            return true;
+        }
+
+        /*  A mapping is not copied.                                          */
+        result_file(const result_file &);
+        result_file &operator = (const result_file &);
+    };
+
+    /*  A result_header for the given frame, filled in apart from eps_sq and  *
+     *  max_iters.                                                            */
+    inline result_header
+    make_result_header(unsigned int xsize, unsigned int ysize,
+                       unsigned int frame, unsigned int n_frames,
+                       const char *poly)
+    {
+        result_header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "QNFR", 4U);
+        h.version = 1U;
+        h.xsize = xsize;
+        h.ysize = ysize;
+        h.frame = frame;
+        h.n_frames = n_frames;
+        h.record_size = sizeof(pixel_result);
+        std::strncpy(h.poly, poly, sizeof(h.poly) - 1U);
+        return h;
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
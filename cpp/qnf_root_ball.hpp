@@ -0,0 +1,155 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the balls around the roots of a real polynomial inside of    *
+ *      which Newton's method is known to converge, so an orbit can be        *
+ *      finished the moment it enters one.                                    *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_ROOT_BALL_HPP
+#define QNF_ROOT_BALL_HPP
+
+/*  Complex numbers and the polynomials.                                      */
+#include "qnf_complex.hpp"
+#include "qnf_polynomial.hpp"
+
+/*  nearest_root.                                                             */
+#include "qnf_basin_table.hpp"
+
+/*  HUGE_VAL, pow and sqrt are found here.                                    */
+#include <cmath>
+#include <vector>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      root_balls                                                        *
+     *  Purpose:                                                              *
+     *      The discs |z - root(k)| < Poly::root_radius(k) of a polynomial    *
+     *      with real coefficients, a bound on |p(z)| that puts z inside one  *
+     *      of them, and the number of Newton steps that take any point of    *
+     *      them to |p(z)|^2 < eps_sq.                                        *
+     *  Method:                                                               *
+     *      The radii come from Smale's gamma theorem, see qnf_polynomial.hpp.*
+     *      Inside the disc of root r the k-th Newton step z_k satisfies      *
+     *          |z_k - r| <= 2^(1 - 2^k) |z_0 - r|,                           *
+     *      and with gamma |z - r| <= (3 - sqrt(7)) / 2 < 0.18 the Taylor     *
+     *      series of p about r gives |p(z)| <= 1.22 |p'(r)| |z - r|. So      *
+     *      "steps" is the least k with                                       *
+     *          2^(1 - 2^k) radius 1.22 |p'(r)| < eps                         *
+     *      for every root, with |p'(r)| taken from a difference quotient and *
+     *      doubled for safety. An orbit in a disc with at least "steps"      *
+     *      steps left converges to that root, and the kernel can take the    *
+     *      root itself as the end of the orbit.                              *
+     *                                                                        *
+     *      Testing the distance to every root costs as much as a Newton      *
+     *      step, so the kernel tests |p(z)| instead, which it has anyway.    *
+     *      The polynomials are monic, p(z) is the product of the distances   *
+     *      d_i = |z - r_i|. If d_k is the least of them, the others are at   *
+     *      least max(d_k, s - d_k) >= s / 2, s the least distance between    *
+     *      two roots. So d_k >= rho, the least radius, gives                 *
+     *          |p(z)| >= rho (s / 2)^(degree - 1),                           *
+     *      and a smaller |p(z)| puts z in the disc of its nearest root.      *
+     *  Notes:                                                                *
+     *      The discs only apply to the complex orbits of the slice kernels.  *
+     *      Like basin_table the struct is only built for real polynomials,   *
+     *      but can be declared for any.                                      *
+     **************************************************************************/
+    template <class Poly>
+    struct root_balls {
+
+        /*  The roots and the squares of the radii.                           */
+        std::vector<complex> center;
+        std::vector<double> radius_sq;
+
+        /*  |p(z)|^2 below this puts z in one of the discs.                   */
+        double residual_sq;
+
+        /*  Newton steps from anywhere in a disc to |p(z)|^2 < eps_sq.        */
+        unsigned int steps;
+
+        root_balls(void) : residual_sq(0.0), steps(0U)
+        {
+            return;
+        }
+
+        /*  The root whose disc z is in, given |p(z)|^2 < residual_sq.        */
+        inline complex nearest(const complex &z) const
+        {
+            return center[nearest_root<Poly>(z)];
+        }
+
+        /*  Computes the discs and the steps for the tolerance eps_sq.        */
+        inline void build(double eps_sq)
+        {
+            const double eps = std::sqrt(eps_sq);
+            const double h = 1.0E-6;
+            double rho = HUGE_VAL, s = HUGE_VAL, residual;
+            unsigned int k, m;
+
+            center.resize(Poly::n_roots);
+            radius_sq.resize(Poly::n_roots);
+            steps = 0U;
+
+            for (k = 0U; k < Poly::n_roots; ++k)
+            {
+                const double radius = Poly::root_radius(k);
+                const complex r = Poly::root(k);
+
+                /*  |p'(r)| ~ |p(r + h)| / h, as p(r) = 0.                    */
+                const double slope =
+                    std::sqrt(Poly::func(r + h).norm_sq()) / h;
+                double error = radius * 1.22 * 2.0 * slope;
+                unsigned int n = 0U;
+
+                /*  The factor 2^(1 - 2^k) goes 1, 1/2, 1/8, 1/128, ...       */
+                while (!(error < eps))
+                {
+                    ++n;
+                    error *= std::ldexp(1.0, -(1 << (n - 1U)));
+                }
+
+                center[k] = r;
+                radius_sq[k] = radius * radius;
+                steps = (n > steps ? n : steps);
+                rho = (radius < rho ? radius : rho);
+
+                for (m = 0U; m < k; ++m)
+                {
+                    const double d = std::sqrt((r - center[m]).norm_sq());
+                    s = (d < s ? d : s);
+                }
+            }
+
+            residual = rho * std::pow(0.5 * s, double(Poly::degree - 1U));
+            residual_sq = residual * residual;
+        }
+    };
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,551 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      The pieces of the render service: Unix domain sockets, the request    *
+ *      protocol, and the queue that admits requests.                         *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_SERVICE_HPP
+#define QNF_SERVICE_HPP
+
+/*  errno, to tell running out of file descriptors from other failures.       */
+#include <cerrno>
+
+/*  fprintf, for the error messages.                                          */
+#include <cstdio>
+
+/*  memset, strlen and strncpy, for the socket address.                       */
+#include <cstring>
+
+/*  The deadlines of the connections that have not sent their request.        */
+#include <chrono>
+
+/*  The queue of requests.                                                    */
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*  Sockets. POSIX, like popen in qnf_output.hpp.                             */
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Namespace for the render service. A client sends one request per      *
+     *  connection, a line of command line flags separated by spaces, e.g.    *
+     *      --poly z4-1 --size 512 512 --still 3 --format raw                 *
+     *  and gets back the line "ok bytes xsize ysize" followed by that many   *
+     *  bytes of image, or the line "error message". The line "quit" stops    *
+     *  the server once the requests it holds are answered.                   */
+    namespace service {
+
+        /*  The longest request line read, in bytes.                          */
+        static inline std::size_t max_line(void)
+        {
+            return 4096U;
+        }
+
+        /*  Fills a socket address with "path". False if it is too long.      */
+        inline bool make_address(const char *path, sockaddr_un *address)
+        {
+            std::memset(address, 0, sizeof(*address));
+            address->sun_family = AF_UNIX;
+
+            if (std::strlen(path) >= sizeof(address->sun_path))
+            {
+                std::fprintf(stderr, "The socket path %s is too long.\n",
+                             path);
+                return false;
+            }
+
+            std::strncpy(address->sun_path, path,
+                         sizeof(address->sun_path) - 1U);
+            return true;
+        }
+
+        /*  A socket listening at "path", which is replaced if it exists.     *
+         *  Returns -1, with a message, on failure.                           */
+        inline int listen_at(const char *path)
+        {
+            sockaddr_un address;
+            int fd;
+
+            if (!make_address(path, &address))
+                return -1;
+
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+            if (fd < 0)
+            {
+                std::fprintf(stderr, "Could not create a socket.\n");
+                return -1;
+            }
+
+            ::unlink(path);
+
+            if (::bind(fd, reinterpret_cast<sockaddr *>(&address),
+                       sizeof(address)) != 0 || ::listen(fd, 64) != 0)
+            {
+                std::fprintf(stderr, "Could not listen at %s.\n", path);
+                ::close(fd);
+                return -1;
+            }
+
+            return fd;
+        }
+
+        /*  A socket connected to the server at "path", or -1.                */
+        inline int connect_to(const char *path)
+        {
+            sockaddr_un address;
+            int fd;
+
+            if (!make_address(path, &address))
+                return -1;
+
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+            if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                                    sizeof(address)) != 0)
+            {
+                std::fprintf(stderr, "Could not connect to %s.\n", path);
+
+                if (fd >= 0)
+                    ::close(fd);
+
+                return -1;
+            }
+
+            return fd;
+        }
+
+        /*  Gives up on reads and writes that wait longer than "seconds", so  *
+         *  a client that connects and says nothing, or stops reading its     *
+         *  answer, cannot hold up the thread serving it.                     */
+        inline void set_timeout(int fd, unsigned int seconds)
+        {
+            timeval t;
+
+            t.tv_sec = static_cast<time_t>(seconds);
+            t.tv_usec = 0;
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t));
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &t, sizeof(t));
+        }
+
+        /*  Sends all n bytes. False if the other end went away. MSG_NOSIGNAL *
+         *  keeps a closed connection from killing the process with SIGPIPE.  */
+        inline bool send_all(int fd, const void *data, std::size_t n)
+        {
+            const char *p = static_cast<const char *>(data);
+
+            while (n > 0U)
+            {
+                const ssize_t sent = ::send(fd, p, n, MSG_NOSIGNAL);
+
+                if (sent <= 0)
+                    return false;
+
+                p += sent;
+                n -= static_cast<std::size_t>(sent);
+            }
+
+            return true;
+        }
+
+        inline bool send_text(int fd, const std::string &text)
+        {
+            return send_all(fd, text.data(), text.size());
+        }
+
+        /*  Receives exactly n bytes. False if the connection ended first.    */
+        inline bool receive_all(int fd, void *data, std::size_t n)
+        {
+            char *p = static_cast<char *>(data);
+
+            while (n > 0U)
+            {
+                const ssize_t got = ::recv(fd, p, n, 0);
+
+                if (got <= 0)
+                    return false;
+
+                p += got;
+                n -= static_cast<std::size_t>(got);
+            }
+
+            return true;
+        }
+
+        /*  Reads a line, without its newline, of at most max_line bytes. The *
+         *  lines are short, so it reads a byte at a time and never reads     *
+         *  past the newline into the data that follows.                      */
+        inline bool receive_line(int fd, std::string *line)
+        {
+            char c;
+
+            line->clear();
+
+            while (line->size() < max_line())
+            {
+                if (::recv(fd, &c, 1U, 0) != 1)
+                    return false;
+
+                if (c == '\n')
+                    return true;
+
+                line->push_back(c);
+            }
+
+            return false;
+        }
+
+        /**********************************************************************
+         *  Struct:                                                           *
+         *      line_reader                                                   *
+         *  Purpose:                                                          *
+         *      Accepts connections on a listening socket and reads their     *
+         *      request lines with poll(), all of them on one thread, so a    *
+         *      slow client only holds up itself. A connection that has not   *
+         *      sent its line within "timeout" seconds, or sends one longer   *
+         *      than max_line, is closed.                                     *
+         *  Notes:                                                            *
+         *      If accept fails for lack of file descriptors, in the process  *
+         *      (EMFILE) or the system (ENFILE), the listener is left out of  *
+         *      poll for a tenth of a second instead of waking it again at    *
+         *      once, while the connections already open are still read.      *
+         **********************************************************************/
+        struct line_reader {
+            typedef std::chrono::steady_clock clock;
+
+            /*  A connection whose line is not complete yet.                  */
+            struct connection {
+                int fd;
+                std::string line;
+                clock::time_point deadline;
+            };
+
+            /*  A connection with its complete line.                          */
+            struct request_line {
+                int fd;
+                std::string line;
+            };
+
+            int listener;
+            unsigned int timeout;
+            std::vector<connection> open;
+            std::deque<request_line> ready;
+            clock::time_point paused_until;
+
+            line_reader(int fd, unsigned int seconds)
+                : listener(fd), timeout(seconds), paused_until(clock::now())
+            {
+                return;
+            }
+
+            /*  Closes the connections that never sent a line.                */
+            ~line_reader(void)
+            {
+                std::size_t n;
+
+                for (n = 0U; n < open.size(); ++n)
+                    ::close(open[n].fd);
+
+                for (n = 0U; n < ready.size(); ++n)
+                    ::close(ready[n].fd);
+            }
+
+            /*  Waits for the next complete line and hands over its           *
+             *  connection, set up with set_timeout, in *fd.                  */
+            inline void next(int *fd, std::string *line)
+            {
+                while (ready.empty())
+                    wait();
+
+                *fd = ready.front().fd;
+                line->swap(ready.front().line);
+                ready.pop_front();
+            }
+
+            /*  One round of poll: accepts a connection and reads what the    *
+             *  open ones have sent.                                          */
+            inline void wait(void)
+            {
+                const clock::time_point now = clock::now();
+                const bool listening = (now >= paused_until);
+                std::vector<pollfd> fds;
+                std::vector<connection> kept;
+                clock::time_point wake = paused_until;
+                bool timed = !listening;
+                std::size_t n, first;
+                int wait_ms = -1;
+
+                for (n = 0U; n < open.size(); ++n)
+                {
+                    if (open[n].deadline <= now)
+                        ::close(open[n].fd);
+                    else
+                        kept.push_back(open[n]);
+                }
+
+                open.swap(kept);
+                kept.clear();
+
+                if (listening)
+                    fds.push_back(make_pollfd(listener));
+
+                first = fds.size();
+
+                for (n = 0U; n < open.size(); ++n)
+                {
+                    fds.push_back(make_pollfd(open[n].fd));
+
+                    if (!timed || open[n].deadline < wake)
+                    {
+                        wake = open[n].deadline;
+                        timed = true;
+                    }
+                }
+
+                /*  Wakes up for the first deadline, or the end of the pause. */
+                if (timed)
+                {
+                    const std::chrono::milliseconds left =
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            wake - now
+                        );
+
+                    wait_ms = static_cast<int>(left.count()) + 1;
+                }
+
+                /*  With the listener paused and nothing open, only sleeps.   */
+                if (::poll(fds.empty() ? 0 : &fds[0],
+                           static_cast<nfds_t>(fds.size()), wait_ms) <= 0)
+                    return;
+
+                for (n = 0U; n < open.size(); ++n)
+                {
+                    if (!fds[first + n].revents)
+                        kept.push_back(open[n]);
+                    else if (read_some(&open[n]))
+                        kept.push_back(open[n]);
+                }
+
+                open.swap(kept);
+
+                if (listening && fds[0].revents)
+                    accept_one();
+            }
+
+            static inline pollfd make_pollfd(int fd)
+            {
+                pollfd p;
+                p.fd = fd;
+                p.events = POLLIN;
+                p.revents = 0;
+                return p;
+            }
+
+            /*  Adds a new connection, or pauses the listener if the file     *
+             *  descriptors ran out.                                          */
+            inline void accept_one(void)
+            {
+                connection c;
+
+                c.fd = ::accept(listener, 0, 0);
+
+                if (c.fd < 0)
+                {
+                    if (errno == EMFILE || errno == ENFILE)
+                        paused_until = clock::now() +
+                                       std::chrono::milliseconds(100);
+
+                    return;
+                }
+
+                set_timeout(c.fd, timeout);
+                c.deadline = clock::now() + std::chrono::seconds(timeout);
+                open.push_back(c);
+            }
+
+            /*  Reads what c has sent without waiting, a byte at a time so    *
+             *  as not to read past the newline. Returns false once c is done *
+             *  with, either moved to "ready" or closed.                      */
+            inline bool read_some(connection *c)
+            {
+                char byte;
+
+                while (c->line.size() < max_line())
+                {
+                    const ssize_t got = ::recv(c->fd, &byte, 1U, MSG_DONTWAIT);
+
+                    if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                        return true;
+
+                    if (got != 1)
+                        break;
+
+                    if (byte == '\n')
+                    {
+                        request_line r;
+                        r.fd = c->fd;
+                        r.line.swap(c->line);
+                        ready.push_back(r);
+                        return false;
+                    }
+
+                    c->line.push_back(byte);
+                }
+
+                ::close(c->fd);
+                return false;
+            }
+        };
+
+        /*  Splits a request line into its flags at spaces and tabs.          */
+        inline std::vector<std::string> split(const std::string &line)
+        {
+            std::vector<std::string> words;
+            std::size_t start = 0U, end;
+
+            while (start < line.size())
+            {
+                start = line.find_first_not_of(" \t\r", start);
+
+                if (start == std::string::npos)
+                    break;
+
+                end = line.find_first_of(" \t\r", start);
+
+                if (end == std::string::npos)
+                    end = line.size();
+
+                words.push_back(line.substr(start, end - start));
+                start = end;
+            }
+
+            return words;
+        }
+
+        /**********************************************************************
+         *  Struct:                                                           *
+         *      admission_queue                                               *
+         *  Purpose:                                                          *
+         *      The requests waiting for a render slot. The server takes a    *
+         *      fixed number of them at a time, so clients share the cores    *
+         *      instead of each starting threads of its own, and turns        *
+         *      requests away once "capacity" are waiting.                    *
+         *  Notes:                                                            *
+         *      T is a shared pointer to a request with a member "key". A     *
+         *      slot takes the first request together with every waiting one  *
+         *      of the same key, see pop, and answers all of them with one    *
+         *      render.                                                       *
+         **********************************************************************/
+        template <class T>
+        struct admission_queue {
+            std::mutex lock;
+            std::condition_variable ready;
+            std::deque<T> waiting;
+            std::size_t capacity;
+            bool closed;
+
+            admission_queue(std::size_t cap) : capacity(cap), closed(false)
+            {
+                return;
+            }
+
+            /*  Adds a request. False if capacity are waiting already, or     *
+             *  the queue was closed.                                         */
+            inline bool push(const T &request)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+
+                    if (closed || waiting.size() >= capacity)
+                        return false;
+
+                    waiting.push_back(request);
+                }
+
+                ready.notify_one();
+                return true;
+            }
+
+            /*  Waits for a request and moves it, and all those waiting with  *
+             *  the same key, into "batch". False once the queue is closed    *
+             *  and empty.                                                    */
+            inline bool pop(std::vector<T> &batch)
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                typename std::deque<T>::iterator it;
+
+                batch.clear();
+
+                while (waiting.empty() && !closed)
+                    ready.wait(guard);
+
+                if (waiting.empty())
+                    return false;
+
+                batch.push_back(waiting.front());
+                waiting.pop_front();
+
+                for (it = waiting.begin(); it != waiting.end();)
+                {
+                    if ((*it)->key == batch[0]->key)
+                    {
+                        batch.push_back(*it);
+                        it = waiting.erase(it);
+                    }
+                    else
+                        ++it;
+                }
+
+                return true;
+            }
+
+            /*  Lets the slots finish what is waiting, then return.           */
+            inline void close(void)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    closed = true;
+                }
+
+                ready.notify_all();
+            }
+        };
+    }
+    /*  End of namespace "service".                                           */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -31,7 +31,9 @@
 /*  Namespace for the project. "Quaternion Newton Fractal."                   */
 namespace qnf {
 
-    /*  Another namespace to avoid name conflicts with these constants.       */
+    /*  Another namespace to avoid name conflicts with these constants. They  *
+     *  are the defaults, main's --size, --window and --max-iters override    *
+     *  them at run time through qnf::render_options.                         */
     namespace setup {
 
         /*  The starting and ending widths and heights for the image.         */
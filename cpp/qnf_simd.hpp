@@ -0,0 +1,756 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides SIMD registers of doubles and lane masks, with AVX-512, AVX2 *
+ *      and portable back ends. Where qnf_cpu.hpp dispatches on the           *
+ *      instruction set, every back end is compiled, each for its own level.  *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_SIMD_HPP
+#define QNF_SIMD_HPP
+
+/*  The instruction set levels, and QNF_ISA_DISPATCH.                         */
+#include "qnf_cpu.hpp"
+
+/*  Intrinsics for the AVX2 and AVX-512 back ends. With QNF_ISA_DISPATCH the  *
+ *  header declares all of them whatever the compiler targets.                */
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(QNF_ISA_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*  The SSE control register, for flushing denormals in single precision.    */
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define QNF_SIMD_MXCSR
+#endif
+
+/*  The back ends compiled. AVX2 and AVX-512 are compiled if the target has   *
+ *  them, or, with QNF_ISA_DISPATCH, for their own level.                     */
+#if defined(__AVX2__) || defined(QNF_ISA_DISPATCH)
+#define QNF_SIMD_AVX2
+#endif
+
+#if defined(__AVX512F__) || defined(QNF_ISA_DISPATCH)
+#define QNF_SIMD_AVX512
+#endif
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  Vector registers of doubles (vec) and floats (vecf), with lane masks. *
+     *  Each back end has its own namespace. simd::vec and the rest are the   *
+     *  widest back end the target supports, the one code compiled for the    *
+     *  baseline uses. The others only run inside the functions compiled for  *
+     *  their level (see QNF_TARGET_AVX2 and QNF_TARGET_AVX512), which take   *
+     *  and return plain arrays: their registers must never cross into code   *
+     *  compiled for the baseline. Every operation is a single IEEE operation *
+     *  per lane, so the batch types built on top of these compute            *
+     *  bit-for-bit what the scalar code does (unless the compiler contracts  *
+     *  either into FMA, see -ffp-contract).                                  */
+    namespace simd {
+
+        /*  Plain arrays, written so that the compiler can vectorize the lane *
+         *  loops with whatever SIMD the target has.                          */
+        namespace portable {
+
+            struct vec {
+                static const unsigned int width = 4U;
+                double v[width];
+
+                vec(void) { return; }
+
+                vec(double a)
+                {
+                    unsigned int n;
+
+                    for (n = 0U; n < width; ++n)
+                        v[n] = a;
+                }
+
+                static inline vec load(const double *p)
+                {
+                    vec out;
+                    unsigned int n;
+
+                    for (n = 0U; n < width; ++n)
+                        out.v[n] = p[n];
+
+                    return out;
+                }
+            };
+
+            struct mask {
+                bool m[vec::width];
+            };
+
+            inline void store(double *p, const vec &a)
+            {
+                unsigned int n;
+
+                for (n = 0U; n < vec::width; ++n)
+                    p[n] = a.v[n];
+            }
+
+            /*  Eight floats, the same register size as four doubles.         */
+            struct vecf {
+                static const unsigned int width = 8U;
+                float v[width];
+
+                vecf(void) { return; }
+
+                vecf(float a)
+                {
+                    unsigned int n;
+
+                    for (n = 0U; n < width; ++n)
+                        v[n] = a;
+                }
+
+                static inline vecf load(const float *p)
+                {
+                    vecf out;
+                    unsigned int n;
+
+                    for (n = 0U; n < width; ++n)
+                        out.v[n] = p[n];
+
+                    return out;
+                }
+            };
+
+            struct maskf {
+                bool m[vecf::width];
+            };
+
+            inline void store(float *p, const vecf &a)
+            {
+                unsigned int n;
+
+                for (n = 0U; n < vecf::width; ++n)
+                    p[n] = a.v[n];
+            }
+
+#define QNF_SIMD_LANEWISE(V, op)                                               \
+            inline V operator op (const V &a, const V &b)                      \
+            {                                                                  \
+                V out;                                                         \
+                unsigned int n;                                                \
+                for (n = 0U; n < V::width; ++n)                                \
+                    out.v[n] = a.v[n] op b.v[n];                               \
+                return out;                                                    \
+            }
+
+/*  The remaining operations, for the register type V with lane masks M.      */
+#define QNF_SIMD_PORTABLE(V, M)                                                \
+            QNF_SIMD_LANEWISE(V, +)                                            \
+            QNF_SIMD_LANEWISE(V, -)                                            \
+            QNF_SIMD_LANEWISE(V, *)                                            \
+            QNF_SIMD_LANEWISE(V, /)                                            \
+                                                                               \
+            inline V operator - (const V &a)                                   \
+            {                                                                  \
+                V out;                                                         \
+                unsigned int n;                                                \
+                for (n = 0U; n < V::width; ++n)                                \
+                    out.v[n] = -a.v[n];                                        \
+                return out;                                                    \
+            }                                                                  \
+                                                                               \
+            inline M less(const V &a, const V &b)                              \
+            {                                                                  \
+                M out;                                                         \
+                unsigned int n;                                                \
+                for (n = 0U; n < V::width; ++n)                                \
+                    out.m[n] = a.v[n] < b.v[n];                                \
+                return out;                                                    \
+            }                                                                  \
+                                                                               \
+            inline V select(const M &m, const V &a, const V &b)                \
+            {                                                                  \
+                V out;                                                         \
+                unsigned int n;                                                \
+                for (n = 0U; n < V::width; ++n)                                \
+                    out.v[n] = (m.m[n] ? a.v[n] : b.v[n]);                     \
+                return out;                                                    \
+            }                                                                  \
+                                                                               \
+            inline M operator | (const M &a, const M &b)                       \
+            {                                                                  \
+                M out;                                                         \
+                unsigned int n;                                                \
+                for (n = 0U; n < V::width; ++n)                                \
+                    out.m[n] = a.m[n] || b.m[n];                               \
+                return out;                                                    \
+            }                                                                  \
+                                                                               \
+            inline bool all(const M &m)                                        \
+            {                                                                  \
+                unsigned int n;                                                \
+                for (n = 0U; n < V::width; ++n)                                \
+                    if (!m.m[n])                                               \
+                        return false;                                          \
+                return true;                                                   \
+            }
+
+            QNF_SIMD_PORTABLE(vec, mask)
+            QNF_SIMD_PORTABLE(vecf, maskf)
+
+#undef QNF_SIMD_PORTABLE
+#undef QNF_SIMD_LANEWISE
+
+            /*  The register type for the scalar type Scalar.                 */
+            template <class Scalar>
+            struct reg;
+
+            template <>
+            struct reg<double> {
+                typedef vec type;
+            };
+
+            template <>
+            struct reg<float> {
+                typedef vecf type;
+            };
+        }
+        /*  End of namespace "portable".                                      */
+
+#ifdef QNF_SIMD_AVX2
+
+/*  Unless the target has AVX2, everything up to the end of namespace avx2 is *
+ *  compiled for AVX2 and FMA as if it were marked QNF_TARGET_AVX2.           */
+#ifndef __AVX2__
+#ifdef __clang__
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+#endif
+
+        namespace avx2 {
+
+            /*  Four doubles in a ymm register.                               */
+            struct vec {
+                __m256d v;
+                static const unsigned int width = 4U;
+
+                vec(void) { return; }
+                vec(__m256d w) : v(w) { return; }
+                vec(double a) : v(_mm256_set1_pd(a)) { return; }
+
+                static inline vec load(const double *p)
+                {
+                    return _mm256_loadu_pd(p);
+                }
+            };
+
+            /*  All-ones or all-zeros in each 64-bit lane.                    */
+            struct mask {
+                __m256d m;
+
+                mask(void) { return; }
+                mask(__m256d k) : m(k) { return; }
+            };
+
+            inline void store(double *p, const vec &a)
+            {
+                _mm256_storeu_pd(p, a.v);
+            }
+
+            inline vec operator + (const vec &a, const vec &b)
+            {
+                return _mm256_add_pd(a.v, b.v);
+            }
+
+            inline vec operator - (const vec &a, const vec &b)
+            {
+                return _mm256_sub_pd(a.v, b.v);
+            }
+
+            inline vec operator * (const vec &a, const vec &b)
+            {
+                return _mm256_mul_pd(a.v, b.v);
+            }
+
+            inline vec operator / (const vec &a, const vec &b)
+            {
+                return _mm256_div_pd(a.v, b.v);
+            }
+
+            /*  Negation flips the sign bit, so -0.0 comes out as in scalar   *
+             *  code.                                                         */
+            inline vec operator - (const vec &a)
+            {
+                return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0));
+            }
+
+            /*  Lanes where a < b. False for NaN, like the scalar comparison. */
+            inline mask less(const vec &a, const vec &b)
+            {
+                return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ);
+            }
+
+            /*  Lane-wise m ? a : b.                                          */
+            inline vec select(const mask &m, const vec &a, const vec &b)
+            {
+                return _mm256_blendv_pd(b.v, a.v, m.m);
+            }
+
+            inline mask operator | (const mask &a, const mask &b)
+            {
+                return _mm256_or_pd(a.m, b.m);
+            }
+
+            inline bool all(const mask &m)
+            {
+                return _mm256_movemask_pd(m.m) == 0xF;
+            }
+
+            /*  Eight floats in a ymm register, and their lane mask.          */
+            struct vecf {
+                __m256 v;
+                static const unsigned int width = 8U;
+
+                vecf(void) { return; }
+                vecf(__m256 w) : v(w) { return; }
+                vecf(float a) : v(_mm256_set1_ps(a)) { return; }
+
+                static inline vecf load(const float *p)
+                {
+                    return _mm256_loadu_ps(p);
+                }
+            };
+
+            struct maskf {
+                __m256 m;
+
+                maskf(void) { return; }
+                maskf(__m256 k) : m(k) { return; }
+            };
+
+            inline void store(float *p, const vecf &a)
+            {
+                _mm256_storeu_ps(p, a.v);
+            }
+
+            inline vecf operator + (const vecf &a, const vecf &b)
+            {
+                return _mm256_add_ps(a.v, b.v);
+            }
+
+            inline vecf operator - (const vecf &a, const vecf &b)
+            {
+                return _mm256_sub_ps(a.v, b.v);
+            }
+
+            inline vecf operator * (const vecf &a, const vecf &b)
+            {
+                return _mm256_mul_ps(a.v, b.v);
+            }
+
+            inline vecf operator / (const vecf &a, const vecf &b)
+            {
+                return _mm256_div_ps(a.v, b.v);
+            }
+
+            inline vecf operator - (const vecf &a)
+            {
+                return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0F));
+            }
+
+            inline maskf less(const vecf &a, const vecf &b)
+            {
+                return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ);
+            }
+
+            inline vecf select(const maskf &m, const vecf &a, const vecf &b)
+            {
+                return _mm256_blendv_ps(b.v, a.v, m.m);
+            }
+
+            inline maskf operator | (const maskf &a, const maskf &b)
+            {
+                return _mm256_or_ps(a.m, b.m);
+            }
+
+            inline bool all(const maskf &m)
+            {
+                return _mm256_movemask_ps(m.m) == 0xFF;
+            }
+
+            template <class Scalar>
+            struct reg;
+
+            template <>
+            struct reg<double> {
+                typedef vec type;
+            };
+
+            template <>
+            struct reg<float> {
+                typedef vecf type;
+            };
+        }
+        /*  End of namespace "avx2".                                          */
+
+#ifndef __AVX2__
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif
+
+#endif
+/*  End of #ifdef QNF_SIMD_AVX2.                                              */
+
+#ifdef QNF_SIMD_AVX512
+
+/*  Likewise for AVX-512, as if marked QNF_TARGET_AVX512.                     */
+#ifndef __AVX512F__
+#ifdef __clang__
+#pragma clang attribute push(__attribute__((target("avx512f"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+#endif
+
+        namespace avx512 {
+
+            /*  Eight doubles in a zmm register.                              */
+            struct vec {
+                __m512d v;
+                static const unsigned int width = 8U;
+
+                vec(void) { return; }
+                vec(__m512d w) : v(w) { return; }
+                vec(double a) : v(_mm512_set1_pd(a)) { return; }
+
+                static inline vec load(const double *p)
+                {
+                    return _mm512_loadu_pd(p);
+                }
+            };
+
+            /*  One bit per lane in a k register.                             */
+            struct mask {
+                __mmask8 m;
+
+                mask(void) { return; }
+                mask(__mmask8 k) : m(k) { return; }
+            };
+
+            inline void store(double *p, const vec &a)
+            {
+                _mm512_storeu_pd(p, a.v);
+            }
+
+            inline vec operator + (const vec &a, const vec &b)
+            {
+                return _mm512_add_pd(a.v, b.v);
+            }
+
+            inline vec operator - (const vec &a, const vec &b)
+            {
+                return _mm512_sub_pd(a.v, b.v);
+            }
+
+            inline vec operator * (const vec &a, const vec &b)
+            {
+                return _mm512_mul_pd(a.v, b.v);
+            }
+
+            inline vec operator / (const vec &a, const vec &b)
+            {
+                return _mm512_div_pd(a.v, b.v);
+            }
+
+            /*  Negation flips the sign bit, so -0.0 comes out as in scalar   *
+             *  code.                                                         */
+            inline vec operator - (const vec &a)
+            {
+                return _mm512_castsi512_pd(
+                    _mm512_xor_si512(
+                        _mm512_castpd_si512(a.v),
+                        _mm512_set1_epi64(-0x7FFFFFFFFFFFFFFFLL - 1LL)
+                    )
+                );
+            }
+
+            /*  Lanes where a < b. False for NaN, like the scalar comparison. */
+            inline mask less(const vec &a, const vec &b)
+            {
+                return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ);
+            }
+
+            /*  Lane-wise m ? a : b.                                          */
+            inline vec select(const mask &m, const vec &a, const vec &b)
+            {
+                return _mm512_mask_blend_pd(m.m, b.v, a.v);
+            }
+
+            inline mask operator | (const mask &a, const mask &b)
+            {
+                return static_cast<__mmask8>(a.m | b.m);
+            }
+
+            inline bool all(const mask &m) { return m.m == 0xFFU; }
+
+            /*  Sixteen floats in a zmm register, and their lane mask.        */
+            struct vecf {
+                __m512 v;
+                static const unsigned int width = 16U;
+
+                vecf(void) { return; }
+                vecf(__m512 w) : v(w) { return; }
+                vecf(float a) : v(_mm512_set1_ps(a)) { return; }
+
+                static inline vecf load(const float *p)
+                {
+                    return _mm512_loadu_ps(p);
+                }
+            };
+
+            struct maskf {
+                __mmask16 m;
+
+                maskf(void) { return; }
+                maskf(__mmask16 k) : m(k) { return; }
+            };
+
+            inline void store(float *p, const vecf &a)
+            {
+                _mm512_storeu_ps(p, a.v);
+            }
+
+            inline vecf operator + (const vecf &a, const vecf &b)
+            {
+                return _mm512_add_ps(a.v, b.v);
+            }
+
+            inline vecf operator - (const vecf &a, const vecf &b)
+            {
+                return _mm512_sub_ps(a.v, b.v);
+            }
+
+            inline vecf operator * (const vecf &a, const vecf &b)
+            {
+                return _mm512_mul_ps(a.v, b.v);
+            }
+
+            inline vecf operator / (const vecf &a, const vecf &b)
+            {
+                return _mm512_div_ps(a.v, b.v);
+            }
+
+            inline vecf operator - (const vecf &a)
+            {
+                return _mm512_castsi512_ps(
+                    _mm512_xor_si512(_mm512_castps_si512(a.v),
+                                     _mm512_set1_epi32(-0x7FFFFFFF - 1))
+                );
+            }
+
+            inline maskf less(const vecf &a, const vecf &b)
+            {
+                return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ);
+            }
+
+            inline vecf select(const maskf &m, const vecf &a, const vecf &b)
+            {
+                return _mm512_mask_blend_ps(m.m, b.v, a.v);
+            }
+
+            inline maskf operator | (const maskf &a, const maskf &b)
+            {
+                return static_cast<__mmask16>(a.m | b.m);
+            }
+
+            inline bool all(const maskf &m) { return m.m == 0xFFFFU; }
+
+            template <class Scalar>
+            struct reg;
+
+            template <>
+            struct reg<double> {
+                typedef vec type;
+            };
+
+            template <>
+            struct reg<float> {
+                typedef vecf type;
+            };
+        }
+        /*  End of namespace "avx512".                                        */
+
+#ifndef __AVX512F__
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif
+
+#endif
+/*  End of #ifdef QNF_SIMD_AVX512.                                            */
+
+        /*  The widest back end the target supports.                          */
+#if defined(__AVX512F__)
+        namespace native = avx512;
+#elif defined(__AVX2__)
+        namespace native = avx2;
+#else
+        namespace native = portable;
+#endif
+
+        typedef native::vec vec;
+        typedef native::mask mask;
+        typedef native::vecf vecf;
+        typedef native::maskf maskf;
+
+        inline vec load(const double *p) { return vec::load(p); }
+        inline vecf load(const float *p) { return vecf::load(p); }
+
+        /*  The lane type and the mask of each register type, for code that   *
+         *  is written once for both precisions and every back end.           */
+        template <class V>
+        struct traits;
+
+        template <>
+        struct traits<portable::vec> {
+            typedef double scalar;
+            typedef portable::mask mask;
+        };
+
+        template <>
+        struct traits<portable::vecf> {
+            typedef float scalar;
+            typedef portable::maskf mask;
+        };
+
+#ifdef QNF_SIMD_AVX2
+        template <>
+        struct traits<avx2::vec> {
+            typedef double scalar;
+            typedef avx2::mask mask;
+        };
+
+        template <>
+        struct traits<avx2::vecf> {
+            typedef float scalar;
+            typedef avx2::maskf mask;
+        };
+#endif
+
+#ifdef QNF_SIMD_AVX512
+        template <>
+        struct traits<avx512::vec> {
+            typedef double scalar;
+            typedef avx512::mask mask;
+        };
+
+        template <>
+        struct traits<avx512::vecf> {
+            typedef float scalar;
+            typedef avx512::maskf mask;
+        };
+#endif
+
+        /*  The most lanes of doubles (max_width) and of floats (max_widthf)  *
+         *  of any back end compiled. Code that hands points to the Newton    *
+         *  loops of every level does so in groups of this many.              */
+#ifdef QNF_SIMD_AVX512
+        static const unsigned int max_width = avx512::vec::width;
+        static const unsigned int max_widthf = avx512::vecf::width;
+#else
+        static const unsigned int max_width = vec::width;
+        static const unsigned int max_widthf = vecf::width;
+#endif
+
+        /*  Lanes of doubles in the back end used at "level".                 */
+        inline unsigned int level_width(isa_level level)
+        {
+#ifdef QNF_ISA_DISPATCH
+            switch (level)
+            {
+                case isa_avx2:
+                    return avx2::vec::width;
+
+                case isa_avx512:
+                    return avx512::vec::width;
+
+                default:
+                    return vec::width;
+            }
+#else
+            (void)level;
+            return vec::width;
+#endif
+        }
+
+        /*  Treats denormal inputs and results as zero while in scope, on     *
+         *  processors with the SSE control register. Orbits that do not     *
+         *  converge in single precision often pass through numbers below     *
+         *  1E-38, which are many times slower than normal ones. The flags    *
+         *  are per thread, cover AVX as well, and are restored on leaving    *
+         *  the scope.                                                        */
+        struct flush_denormals {
+#ifdef QNF_SIMD_MXCSR
+            unsigned int saved;
+
+            flush_denormals(void) : saved(_mm_getcsr())
+            {
+                /*  Flush to zero (bit 15) and denormals are zero (bit 6).    */
+                _mm_setcsr(saved | 0x8040U);
+            }
+
+            ~flush_denormals(void)
+            {
+                _mm_setcsr(saved);
+            }
+#endif
+        };
+
+        /*  store, less, select and all of every back end, picked by the type *
+         *  of their arguments. Last, so that the names above are not         *
+         *  ambiguous with those of the back ends.                            */
+        using namespace portable;
+
+#ifdef QNF_SIMD_AVX2
+        using namespace avx2;
+#endif
+
+#ifdef QNF_SIMD_AVX512
+        using namespace avx512;
+#endif
+    }
+    /*  End of namespace "simd".                                              */
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
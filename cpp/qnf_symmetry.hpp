@@ -0,0 +1,202 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the symmetries between frames of the rotation, used to       *
+ *      derive frames from others instead of rendering every one.             *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_SYMMETRY_HPP
+#define QNF_SYMMETRY_HPP
+
+/*  memcpy is found here.                                                     */
+#include <cstring>
+#include <vector>
+
+/*  Quaternions and frame buffers.                                            */
+#include "qnf_quaternion.hpp"
+#include "qnf_ppm.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  The automorphism q -> j q j^-1 of the quaternions, which negates the  *
+     *  i and k parts. It is exact in floating point, and since quaternion    *
+     *  arithmetic only ever combines the components with signs, Newton's    *
+     *  method commutes with it bit for bit whenever the polynomial does.     */
+    inline quaternion conjugate_by_j(const quaternion &q)
+    {
+        return quaternion(q.dat[0], -q.dat[1], q.dat[2], -q.dat[3]);
+    }
+
+    /*  Writes the point reflection of src into dst, dst(x, y) =              *
+     *  src(xsize - x, ysize - y), for x, y >= 1. Row 0 and column 0 have no  *
+     *  partner in src and are left for the caller.                           */
+    inline void reflect(const framebuffer &src, framebuffer &dst)
+    {
+        unsigned int x, y;
+
+        for (y = 1U; y < src.ysize; ++y)
+        {
+            const unsigned char *in = src.row(src.ysize - y);
+            unsigned char *out = dst.row(y);
+
+            for (x = 1U; x < src.xsize; ++x)
+                std::memcpy(out + 3U*x, in + 3U*(src.xsize - x), 3U);
+        }
+    }
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      frame_symmetry                                                    *
+     *  Purpose:                                                              *
+     *      Frame f of an n frame turn shows the plane spanned by             *
+     *          u0 = cos(t) + sin(t) i and u1 = cos(t) j + sin(t) k,          *
+     *      t = 2 pi f / n. Two relations link the frames:                    *
+     *          1. Half turn, f -> f + n/2. Both u0 and u1 change sign, so    *
+     *             the frame shows the same points with pixel (x, y) moved to *
+     *             (xsize - x, ysize - y), provided the window is symmetric   *
+     *             (view::point_symmetric). The colors are simply copied.     *
+     *          2. Reflection, f -> n - f. The sin terms change sign, so each *
+     *             pixel shows conjugate_by_j of its old point. If the        *
+     *             polynomial commutes with j (real coefficients, or the      *
+     *             coefficients lie in span{1, j}), the orbits are conjugated *
+     *             as well and the frame is the old orbits recolored.         *
+     *      Together they split the frames into classes of up to four,        *
+     *          {f, f + n/2, n - f, n/2 - f}.                                 *
+     *      Only the lowest frame of each class is iterated. For 64 frames    *
+     *      those are frames 0 through 16.                                    *
+     *  Notes:                                                                *
+     *      The relations hold exactly only if the bases of related frames    *
+     *      differ exactly in sign, which view::rotate_frame guarantees.      *
+     **************************************************************************/
+    struct frame_symmetry {
+
+        /*  Where a frame comes from: the colors of frame "rep", recolored    *
+         *  for the conjugate points if "conjugate" is set, then point        *
+         *  reflected if "reflect" is set.                                    */
+        struct source {
+            unsigned int rep;
+            bool conjugate;
+            bool reflect;
+        };
+
+        unsigned int n_frames;
+
+        /*  Which of the two relations may be used.                           */
+        bool half_turn, reflection;
+
+        frame_symmetry(unsigned int n, bool use_half_turn, bool use_reflection)
+            : n_frames(n),
+              half_turn(use_half_turn && (n % 2U == 0U)),
+              reflection(use_reflection)
+        {
+            return;
+        }
+
+        /*  The cheapest way to get frame f from the lowest frame of its      *
+         *  class. Copies are cheaper than recoloring, so on ties a half turn *
+         *  is preferred over a reflection.                                   */
+        inline source of(unsigned int f) const
+        {
+            const unsigned int n = n_frames;
+            source best;
+            best.rep = f;
+            best.conjugate = false;
+            best.reflect = false;
+
+            if (half_turn)
+            {
+                const unsigned int g = (f + n/2U) % n;
+
+                if (g < best.rep)
+                {
+                    best.rep = g;
+                    best.reflect = true;
+                }
+            }
+
+            if (reflection)
+            {
+                const unsigned int g = (n - f) % n;
+
+                if (g < best.rep)
+                {
+                    best.rep = g;
+                    best.conjugate = true;
+                    best.reflect = false;
+                }
+            }
+
+            if (half_turn && reflection)
+            {
+                const unsigned int g = (n + n/2U - f) % n;
+
+                if (g < best.rep)
+                {
+                    best.rep = g;
+                    best.conjugate = true;
+                    best.reflect = true;
+                }
+            }
+
+            return best;
+        }
+
+        /*  Index of the buffer a source reads from. Frame rep's own colors   *
+         *  are buffer 2 rep, its recolored conjugate is buffer 2 rep + 1.    */
+        static inline unsigned int buffer(const source &s)
+        {
+            return 2U*s.rep + (s.conjugate ? 1U : 0U);
+        }
+
+        /*  For each buffer, the last frame that reads it, or n_frames if no  *
+         *  frame does. A buffer can be dropped once that frame is written.   */
+        inline std::vector<unsigned int> last_use(void) const
+        {
+            std::vector<unsigned int> last(2U*n_frames, n_frames);
+            unsigned int f;
+
+            for (f = 0U; f < n_frames; ++f)
+                last[buffer(of(f))] = f;
+
+            return last;
+        }
+
+        /*  Number of frames whose orbits have to be computed.                */
+        inline unsigned int n_rendered(void) const
+        {
+            unsigned int f, count = 0U;
+
+            for (f = 0U; f < n_frames; ++f)
+                if (of(f).rep == f)
+                    ++count;
+
+            return count;
+        }
+    };
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
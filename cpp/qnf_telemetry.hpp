@@ -0,0 +1,378 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the per-frame telemetry of a render: where the time went,    *
+ *      how many Newton steps the pixels took and where their orbits ended,   *
+ *      written as one line of JSON per frame.                                *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_TELEMETRY_HPP
+#define QNF_TELEMETRY_HPP
+
+/*  fflush and FILE.                                                          */
+#include <cstdio>
+
+/*  Timers.                                                                   */
+#include <chrono>
+#include <vector>
+
+/*  getrusage, for the peak resident memory.                                  */
+#include <sys/resource.h>
+
+/*  The final points are quaternions.                                         */
+#include "qnf_quaternion.hpp"
+
+/*  Each worker of the pool counts into its own slot.                         */
+#include "qnf_thread_pool.hpp"
+
+/*  The lines are written as JSON.                                            */
+#include "qnf_json.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  The pixels of a frame one worker colored, and the time it spent. The  *
+     *  padding keeps two workers off the same cache line.                    */
+    struct pixel_counts {
+
+        /*  Pixels colored, those whose orbit converged, those that ended on  *
+         *  a real root, and the Newton steps of all of them.                 */
+        unsigned long int colored, converged, real_root, steps;
+
+        /*  histogram[n]: converged orbits that took n steps.                 */
+        std::vector<unsigned long int> histogram;
+
+        /*  Time in the tiles, and the time of the colorer for the sampled    *
+         *  pixels, see frame_counters::sampled.                              */
+        double tile_seconds, color_seconds;
+        unsigned long int color_samples;
+
+        char padding[64];
+
+        pixel_counts(void)
+            : colored(0UL), converged(0UL), real_root(0UL), steps(0UL),
+              tile_seconds(0.0), color_seconds(0.0), color_samples(0UL)
+        {
+            return;
+        }
+
+        inline void reset(void)
+        {
+            colored = converged = real_root = steps = color_samples = 0UL;
+            tile_seconds = color_seconds = 0.0;
+            histogram.assign(histogram.size(), 0UL);
+        }
+
+        /*  Adds the counts of another worker.                                */
+        inline void add(const pixel_counts &c)
+        {
+            std::size_t n;
+
+            colored += c.colored;
+            converged += c.converged;
+            real_root += c.real_root;
+            steps += c.steps;
+            tile_seconds += c.tile_seconds;
+            color_seconds += c.color_seconds;
+            color_samples += c.color_samples;
+
+            for (n = 0U; n < histogram.size(); ++n)
+                histogram[n] += c.histogram[n];
+        }
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      frame_counters                                                    *
+     *  Purpose:                                                              *
+     *      The counts of one frame being iterated, a pixel_counts for each   *
+     *      worker of the pool and one for the thread that waits on it. The   *
+     *      kernel hands every pixel it colors to count, and times the        *
+     *      colorer on the pixels that "sampled" picks.                       *
+     *  Notes:                                                                *
+     *      Reading the clock costs about as much as coloring a pixel, so     *
+     *      only one pixel in 256 is timed, and the cost of the clock itself, *
+     *      measured once, is taken off when the time is reported. Samples    *
+     *      longer than max_sample are dropped.                               *
+     **************************************************************************/
+    struct frame_counters {
+        const thread_pool *pool;
+        double eps_sq;
+        std::vector<pixel_counts> workers;
+
+        frame_counters(const thread_pool &p, double eps_sq_in,
+                       unsigned int max_iters)
+            : pool(&p), eps_sq(eps_sq_in), workers(p.size() + 1U)
+        {
+            std::size_t n;
+
+            for (n = 0U; n < workers.size(); ++n)
+                workers[n].histogram.assign(max_iters + 1U, 0UL);
+        }
+
+        inline void reset(void)
+        {
+            std::size_t n;
+
+            for (n = 0U; n < workers.size(); ++n)
+                workers[n].reset();
+        }
+
+        /*  The slot of the calling thread.                                   */
+        inline pixel_counts &local(void)
+        {
+            return workers[pool->current()];
+        }
+
+        /*  Whether the colorer is timed for the pixel (x, y).                */
+        static inline bool sampled(unsigned int x, unsigned int y)
+        {
+            return ((x | y) & 15U) == 0U;
+        }
+
+        /*  Samples longer than this, in seconds, are dropped. Coloring a     *
+         *  pixel takes well under a microsecond, longer samples are threads  *
+         *  that were preempted while being timed.                            */
+        static inline double max_sample(void)
+        {
+            return 1.0E-5;
+        }
+
+        /*  Counts a pixel from the end of its orbit. Real roots are the      *
+         *  ones the colorers paint gray, an imaginary part below eps.        */
+        inline void count(const quaternion &q, double p_norm_sq,
+                          unsigned int steps)
+        {
+            pixel_counts &c = local();
+            const double y_sq = q.dat[1]*q.dat[1] + q.dat[2]*q.dat[2] +
+                                q.dat[3]*q.dat[3];
+
+            ++c.colored;
+            c.steps += steps;
+
+            if (!(p_norm_sq < eps_sq))
+                return;
+
+            ++c.converged;
+            c.real_root += (y_sq < eps_sq ? 1UL : 0UL);
+            ++c.histogram[steps < c.histogram.size() ? steps
+                                                     : c.histogram.size() - 1U];
+        }
+
+        /*  The counts of all of the workers.                                 */
+        inline pixel_counts total(void) const
+        {
+            pixel_counts sum;
+            std::size_t n;
+
+            sum.histogram.assign(workers[0].histogram.size(), 0UL);
+
+            for (n = 0U; n < workers.size(); ++n)
+                sum.add(workers[n]);
+
+            return sum;
+        }
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      telemetry_log                                                     *
+     *  Purpose:                                                              *
+     *      Writes a line of JSON to a file for each frame as it is handed to *
+     *      the output, and one for the whole render at the end:              *
+     *          {"event": "frame", "frame": 5, "source": 5, ...}              *
+     *          {"event": "render", "frames": 64, ...}                        *
+     *  Notes:                                                                *
+     *      The frames overlap: several are iterated at once while an earlier *
+     *      one is written. So "wall_ms" is the time since the previous frame *
+     *      was handed over, and "iterate_ms" and "color_ms" add up the time  *
+     *      of every worker on the frame, which can exceed the wall time.     *
+     *      "write_ms" is the time the render waited on the output back end,  *
+     *      for the asynchronous one that is only a copy unless the writer    *
+     *      falls behind. A frame derived by symmetry repeats the counts of   *
+     *      its source, the same orbits mirrored, with no iterate or color    *
+     *      time. Pixels filled in by subdivision are not counted.            *
+     **************************************************************************/
+    struct telemetry_log {
+        typedef std::chrono::steady_clock clock;
+
+        FILE *fp;
+
+        /*  The time of an empty pair of clock reads, in seconds.             */
+        double clock_overhead;
+
+        clock::time_point start, last;
+        unsigned long int total_pixels, total_steps;
+        double total_iterate, total_color, total_write;
+
+        telemetry_log(FILE *out)
+            : fp(out), clock_overhead(out ? measure_clock() : 0.0),
+              start(clock::now()), last(start), total_pixels(0UL),
+              total_steps(0UL), total_iterate(0.0), total_color(0.0),
+              total_write(0.0)
+        {
+            return;
+        }
+
+        /*  The least time between two clock reads out of a thousand.         */
+        static inline double measure_clock(void)
+        {
+            double best = 1.0;
+            unsigned int n;
+
+            for (n = 0U; n < 1000U; ++n)
+            {
+                const clock::time_point a = clock::now();
+                const std::chrono::duration<double> d = clock::now() - a;
+                best = (d.count() < best ? d.count() : best);
+            }
+
+            return best;
+        }
+
+        /*  The time in seconds of the colorer for every pixel of c,          *
+         *  estimated from the sampled pixels.                                */
+        inline double color_seconds(const pixel_counts &c) const
+        {
+            double per_pixel;
+
+            if (c.color_samples == 0UL)
+                return 0.0;
+
+            per_pixel = c.color_seconds / c.color_samples - clock_overhead;
+            return (per_pixel > 0.0 ? per_pixel : 0.0) * c.colored;
+        }
+
+        /**********************************************************************
+         *  Method:                                                           *
+         *      frame                                                         *
+         *  Purpose:                                                          *
+         *      Writes the line of a frame.                                   *
+         *  Arguments:                                                        *
+         *      frame (unsigned int):                                         *
+         *          The frame handed to the output.                           *
+         *      source (unsigned int):                                        *
+         *          The frame whose orbits it shows, itself unless derived.   *
+         *      xsize, ysize (unsigned int):                                  *
+         *          The size of the frame.                                    *
+         *      c (const pixel_counts &):                                     *
+         *          The counts of frame "source".                             *
+         *      write_seconds (double):                                       *
+         *          The time the output back end took.                        *
+         **********************************************************************/
+        inline void frame(unsigned int frame, unsigned int source,
+                          unsigned int xsize, unsigned int ysize,
+                          const pixel_counts &c, double write_seconds)
+        {
+            const clock::time_point now = clock::now();
+            const std::chrono::duration<double> wall = now - last;
+            const bool iterated = (frame == source);
+            const double pixels = static_cast<double>(xsize) * ysize;
+            const double colored = (c.colored > 0UL ? c.colored : 1.0);
+            const double color = (iterated ? color_seconds(c) : 0.0);
+            const double tiles = (iterated ? c.tile_seconds : 0.0);
+            const double iterate = (tiles > color ? tiles - color : 0.0);
+            json::writer out(fp);
+
+            last = now;
+            total_pixels += static_cast<unsigned long int>(pixels);
+            total_steps += (iterated ? c.steps : 0UL);
+            total_iterate += iterate;
+            total_color += color;
+            total_write += write_seconds;
+
+            out.begin_object();
+            out.field("event", "frame");
+            out.field("frame", frame);
+            out.field("source", source);
+            out.field("iterated", iterated);
+            out.field("xsize", xsize);
+            out.field("ysize", ysize);
+            out.field("wall_ms", 1.0E3 * wall.count());
+            out.field("iterate_ms", 1.0E3 * iterate);
+            out.field("color_ms", 1.0E3 * color);
+            out.field("write_ms", 1.0E3 * write_seconds);
+            out.field("pixels_per_s", pixels / wall.count());
+            out.field("pixels_counted", c.colored);
+            out.field("steps", c.steps);
+            out.field("mean_steps", c.steps / colored);
+            out.field("converged", c.converged / colored);
+            out.field("real_root", c.real_root / colored);
+            out.field("unconverged", (c.colored - c.converged) / colored);
+            out.begin_array("histogram");
+            write_histogram(out, c.histogram);
+            out.end_array();
+            out.end_object();
+            std::fputc('\n', fp);
+            std::fflush(fp);
+        }
+
+        static inline void
+        write_histogram(json::writer &out,
+                        const std::vector<unsigned long int> &histogram)
+        {
+            std::size_t n;
+
+            for (n = 0U; n < histogram.size(); ++n)
+                out.field(0, histogram[n]);
+        }
+
+        /*  Writes the line of the whole render, with the frames iterated.    */
+        inline void finish(unsigned int n_frames, unsigned int n_iterated)
+        {
+            const std::chrono::duration<double> wall = clock::now() - start;
+            json::writer out(fp);
+
+            out.begin_object();
+            out.field("event", "render");
+            out.field("frames", n_frames);
+            out.field("frames_iterated", n_iterated);
+            out.field("wall_ms", 1.0E3 * wall.count());
+            out.field("iterate_ms", 1.0E3 * total_iterate);
+            out.field("color_ms", 1.0E3 * total_color);
+            out.field("write_ms", 1.0E3 * total_write);
+            out.field("pixels_per_s", total_pixels / wall.count());
+            out.field("steps", total_steps);
+            out.end_object();
+            std::fputc('\n', fp);
+            std::fflush(fp);
+        }
+    };
+
+    /*  The most memory the process has held in RAM so far, in megabytes.     *
+     *  Linux reports ru_maxrss in kilobytes.                                 */
+    inline double peak_resident_mb(void)
+    {
+        struct rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0.0;
+
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,426 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a work-stealing thread pool and a tiling of the image.       *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_THREAD_POOL_HPP
+#define QNF_THREAD_POOL_HPP
+
+/*  Threads, locks, and condition variables for the pool.                     */
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/*  Containers for the workers and their task queues.                         */
+#include <deque>
+#include <vector>
+#include <functional>
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /*  A rectangular block of pixels, [x0, x1) x [y0, y1).                   */
+    struct tile {
+        unsigned int x0, y0, x1, y1;
+    };
+
+    /*  Splits an xsize by ysize image into tiles of width by height pixels,  *
+     *  in row-major order. Tiles on the right and bottom edges are clipped.  */
+    inline std::vector<tile>
+    make_tiles(unsigned int xsize, unsigned int ysize,
+               unsigned int width, unsigned int height)
+    {
+        std::vector<tile> tiles;
+        unsigned int x, y;
+
+        for (y = 0U; y < ysize; y += height)
+        {
+            for (x = 0U; x < xsize; x += width)
+            {
+                tile t;
+                t.x0 = x;
+                t.y0 = y;
+                t.x1 = (x + width < xsize ? x + width : xsize);
+                t.y1 = (y + height < ysize ? y + height : ysize);
+                tiles.push_back(t);
+            }
+        }
+
+        return tiles;
+    }
+
+    /*  Counts outstanding tasks so that a caller can wait on a batch of      *
+     *  work. A group must outlive every task submitted to it.                */
+    struct task_group {
+        std::atomic<unsigned int> pending;
+
+        task_group(void) : pending(0U)
+        {
+            return;
+        }
+    };
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      thread_pool                                                       *
+     *  Purpose:                                                              *
+     *      A fixed set of worker threads, each with its own double-ended     *
+     *      task queue. A worker runs the tasks it queued itself newest first *
+     *      and those dealt to it by other threads oldest first, and when its *
+     *      queue is empty steals the oldest task of another worker. Newton's *
+     *      method exits in a few iterations near the roots and uses all      *
+     *      max_iters in the black regions, so tiles differ wildly in cost.   *
+     *      Stealing keeps every core busy until the last tile of the frame   *
+     *      is done.                                                          *
+     *  Notes:                                                                *
+     *      A thread waiting on a task_group runs queued tasks while it waits,*
+     *      so tasks may themselves submit and wait on work without dead-     *
+     *      locking, even with a single worker. Outside threads that turn     *
+     *      thread_pool_helps off only sleep in wait instead.                 *
+     **************************************************************************/
+    struct thread_pool {
+
+        /*  A unit of work and the group it counts against. "local" is true   *
+         *  if a worker queued it in its own queue.                           */
+        struct task {
+            std::function<void(void)> run;
+            task_group *group;
+            bool local;
+        };
+
+        /*  Per-worker queue. The mutex is only contended while stealing.     */
+        struct queue {
+            std::mutex lock;
+            std::deque<task> tasks;
+        };
+
+        std::vector<std::thread> workers;
+        std::vector<queue *> queues;
+
+        /*  Idle workers sleep on work_cv, threads in wait() on done_cv.      */
+        std::mutex sleep_lock;
+        std::condition_variable work_cv;
+        std::condition_variable done_cv;
+        std::atomic<unsigned int> queued;
+        std::atomic<unsigned int> next_queue;
+        bool stopping;
+
+        /*  Creates a pool with n_threads workers. Zero means one per core.   */
+        thread_pool(unsigned int n_threads);
+
+        /*  Finishes all queued work and joins the workers.                   */
+        ~thread_pool(void);
+
+        /*  The number of worker threads.                                     */
+        inline unsigned int size(void) const;
+
+        /*  Queues a task that counts against the given group.                */
+        inline void submit(task_group &group, std::function<void(void)> f);
+
+        /*  Blocks until every task in the group is done, helping meanwhile.  */
+        inline void wait(task_group &group);
+
+        /*  Runs f(0), ..., f(n_tasks - 1) on the pool and waits for them.    */
+        template <class Func>
+        inline void parallel_for(unsigned int n_tasks, const Func &f);
+
+        /*  Pops one task from our own queue or steals one. False if none.    */
+        inline bool try_run_one(unsigned int self);
+
+        /*  Main loop for the worker threads.                                 */
+        inline void worker_loop(unsigned int self);
+
+        /*  Index of the calling worker in this pool, or size() if the        *
+         *  caller is not one of our workers.                                 */
+        inline unsigned int current(void) const;
+    };
+
+    /*  The pool and queue index of the calling thread, if it is a worker.    */
+    inline const thread_pool *&thread_pool_owner(void)
+    {
+        static thread_local const thread_pool *owner = 0;
+        return owner;
+    }
+
+    inline unsigned int &thread_pool_index(void)
+    {
+        static thread_local unsigned int index = 0U;
+        return index;
+    }
+
+    /*  Whether the calling thread runs queued tasks while it waits, if it is *
+     *  not a worker. Threads that each drive a render of their own, like the *
+     *  jobs of a batch, turn this off: the workers alone then run the tiles, *
+     *  so the cores are not oversubscribed, and at most one outside thread   *
+     *  ever runs tasks as the pool's thread size().                          */
+    inline bool &thread_pool_helps(void)
+    {
+        static thread_local bool helps = true;
+        return helps;
+    }
+
+    /**************************************************************************
+     *  Constructor:                                                          *
+     *      thread_pool                                                       *
+     *  Purpose:                                                              *
+     *      Starts the worker threads.                                        *
+     *  Arguments:                                                            *
+     *      n_threads (unsigned int):                                         *
+     *          The number of workers. If zero, the number of hardware        *
+     *          threads is used (or one, if that is unknown).                 *
+     **************************************************************************/
+    inline thread_pool::thread_pool(unsigned int n_threads)
+        : queued(0U), next_queue(0U), stopping(false)
+    {
+        unsigned int n;
+
+        if (n_threads == 0U)
+            n_threads = std::thread::hardware_concurrency();
+
+        if (n_threads == 0U)
+            n_threads = 1U;
+
+        for (n = 0U; n < n_threads; ++n)
+            queues.push_back(new queue);
+
+        for (n = 0U; n < n_threads; ++n)
+            workers.push_back(std::thread(&thread_pool::worker_loop, this, n));
+    }
+
+    /**************************************************************************
+     *  Destructor:                                                           *
+     *      ~thread_pool                                                      *
+     *  Purpose:                                                              *
+     *      Signals the workers to stop once their queues are drained and     *
+     *      joins them.                                                       *
+     **************************************************************************/
+    inline thread_pool::~thread_pool(void)
+    {
+        unsigned int n;
+
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            stopping = true;
+        }
+
+        work_cv.notify_all();
+
+        for (n = 0U; n < workers.size(); ++n)
+            workers[n].join();
+
+        for (n = 0U; n < queues.size(); ++n)
+            delete queues[n];
+    }
+
+    inline unsigned int thread_pool::size(void) const
+    {
+        return static_cast<unsigned int>(workers.size());
+    }
+
+    inline unsigned int thread_pool::current(void) const
+    {
+        if (thread_pool_owner() == this)
+            return thread_pool_index();
+
+        return size();
+    }
+
+    /**************************************************************************
+     *  Method:                                                               *
+     *      submit                                                            *
+     *  Purpose:                                                              *
+     *      Queues a task. Workers push onto their own queue, which keeps     *
+     *      nested work local. Other threads deal tasks out round-robin so    *
+     *      that the work starts spread across all of the queues. These are   *
+     *      run in the order they came, so the tiles of a frame, or of a      *
+     *      request of the service, are not held up by those queued later.    *
+     **************************************************************************/
+    inline void thread_pool::submit(task_group &group, std::function<void(void)> f)
+    {
+        unsigned int index = current();
+        task t;
+
+        t.local = (index < size());
+
+        if (!t.local)
+            index = next_queue.fetch_add(1U) % size();
+
+        t.run = f;
+        t.group = &group;
+        group.pending.fetch_add(1U);
+
+        {
+            std::lock_guard<std::mutex> guard(queues[index]->lock);
+            queues[index]->tasks.push_back(t);
+        }
+
+        /*  Take the sleep lock so the wake-up cannot slip in between a       *
+         *  worker checking "queued" and going to sleep.                      */
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            queued.fetch_add(1U);
+        }
+
+        work_cv.notify_one();
+    }
+
+    /**************************************************************************
+     *  Method:                                                               *
+     *      try_run_one                                                       *
+     *  Purpose:                                                              *
+     *      Runs a single task. The tasks we queued ourselves are used LIFO,  *
+     *      which favors the most recently queued (cache-warm) work, and the  *
+     *      tasks dealt to us FIFO. Stealing takes the oldest task from the   *
+     *      front of a victim's queue.                                        *
+     *  Arguments:                                                            *
+     *      self (unsigned int):                                              *
+     *          The caller's queue index, or size() for outside threads.      *
+     *  Outputs:                                                              *
+     *      ran (bool):                                                       *
+     *          True if a task was found and run.                             *
+     **************************************************************************/
+    inline bool thread_pool::try_run_one(unsigned int self)
+    {
+        const unsigned int n_queues = size();
+        unsigned int n;
+        bool found = false;
+        task t;
+
+        if (self < n_queues)
+        {
+            std::lock_guard<std::mutex> guard(queues[self]->lock);
+
+            std::deque<task> &tasks = queues[self]->tasks;
+
+            if (!tasks.empty() && tasks.back().local)
+            {
+                t = tasks.back();
+                tasks.pop_back();
+                found = true;
+            }
+            else if (!tasks.empty())
+            {
+                t = tasks.front();
+                tasks.pop_front();
+                found = true;
+            }
+        }
+
+        for (n = 1U; !found && n <= n_queues; ++n)
+        {
+            const unsigned int victim = (self + n) % n_queues;
+            std::lock_guard<std::mutex> guard(queues[victim]->lock);
+
+            if (!queues[victim]->tasks.empty())
+            {
+                t = queues[victim]->tasks.front();
+                queues[victim]->tasks.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found)
+            return false;
+
+        queued.fetch_sub(1U);
+        t.run();
+
+        /*  The last task of a group wakes whoever is waiting on it.          */
+        if (t.group->pending.fetch_sub(1U) == 1U)
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            done_cv.notify_all();
+        }
+
+        return true;
+    }
+
+    inline void thread_pool::worker_loop(unsigned int self)
+    {
+        thread_pool_owner() = this;
+        thread_pool_index() = self;
+
+        while (true)
+        {
+            if (try_run_one(self))
+                continue;
+
+            std::unique_lock<std::mutex> guard(sleep_lock);
+
+            while (queued.load() == 0U && !stopping)
+                work_cv.wait(guard);
+
+            if (stopping && queued.load() == 0U)
+                return;
+        }
+    }
+
+    inline void thread_pool::wait(task_group &group)
+    {
+        const unsigned int self = current();
+        const bool helps = (self < size() || thread_pool_helps());
+
+        while (group.pending.load() != 0U)
+        {
+            if (helps && try_run_one(self))
+                continue;
+
+            std::unique_lock<std::mutex> guard(sleep_lock);
+
+            if (group.pending.load() != 0U && (!helps || queued.load() == 0U))
+                done_cv.wait(guard);
+        }
+    }
+
+    /**************************************************************************
+     *  Method:                                                               *
+     *      parallel_for                                                      *
+     *  Purpose:                                                              *
+     *      Runs f(n) for 0 <= n < n_tasks on the pool. Task n starts in      *
+     *      queue n % size(), and stealing rebalances from there.             *
+     *  Arguments:                                                            *
+     *      n_tasks (unsigned int):                                           *
+     *          The number of tasks.                                          *
+     *      f (const Func &):                                                 *
+     *          Callable with signature void(unsigned int). It is called      *
+     *          concurrently, so it must only write to disjoint data.         *
+     **************************************************************************/
+    template <class Func>
+    inline void thread_pool::parallel_for(unsigned int n_tasks, const Func &f)
+    {
+        task_group group;
+        unsigned int n;
+
+        for (n = 0U; n < n_tasks; ++n)
+            submit(group, [&f, n](void) { f(n); });
+
+        wait(group);
+    }
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */
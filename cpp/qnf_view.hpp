@@ -0,0 +1,224 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of quaternion_newton_fractals.                          *
+ *                                                                            *
+ *  quaternion_newton_fractals is free software: you can redistribute it      *
+ *  and/or modify it under the terms of the GNU General Public License as     *
+ *  published by the Free Software Foundation, either version 3 of the        *
+ *  License, or (at your option) any later version.                           *
+ *                                                                            *
+ *  quaternion_newton_fractals is distributed in the hope that it will be     *
+ *  useful but WITHOUT ANY WARRANTY; without even the implied warranty of     *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with quaternion_newton_fractals.  If not, see                       *
+ *  <https://www.gnu.org/licenses/>.                                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the mapping from pixels to points in the quaternions.        *
+ ******************************************************************************
+ *  Author: Ryan Maguire                                                      *
+ *  Date:   2026/10/16                                                        *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef QNF_VIEW_HPP
+#define QNF_VIEW_HPP
+
+/*  std::min and std::max are found here.                                     */
+#include <algorithm>
+
+/*  cos and sin are found here.                                               */
+#include <cmath>
+
+/*  Quaternions, the default image parameters, and TWO_PI.                    */
+#include "qnf_quaternion.hpp"
+#include "qnf_setup.hpp"
+#include "qnf_pi.hpp"
+
+/*  Namespace for the project. "Quaternion Newton Fractal."                   */
+namespace qnf {
+
+    /**************************************************************************
+     *  Struct:                                                               *
+     *      view                                                              *
+     *  Purpose:                                                              *
+     *      A 2-dimensional plane in the quaternions spanned by u0 and u1,    *
+     *      and the window of it that is drawn. The pixel (x, y) is the point *
+     *      u0*a0 + u1*a1 with a0 = y_start + pyfact*y and                    *
+     *      a1 = x_start + pxfact*x.                                          *
+     **************************************************************************/
+    struct view {
+        quaternion u0, u1;
+        double x_start, y_start;
+        double pxfact, pyfact;
+        unsigned int xsize, ysize;
+
+        /*  The default window from "setup", in the plane through 1 and i     *
+         *  rotated by "angle" (see rotation).                                */
+        view(double angle = 0.0)
+            : x_start(qnf::setup::start), y_start(qnf::setup::start),
+              pxfact(qnf::setup::pxfact), pyfact(qnf::setup::pyfact),
+              xsize(qnf::setup::xsize), ysize(qnf::setup::ysize)
+        {
+            rotate(angle);
+        }
+
+        /*  Draws [x0, x1] along u1 and [y0, y1] along u0 with x by y pixels, *
+         *  in the same way "setup" gives the default window.                 */
+        inline void set_window(double x0, double x1, double y0, double y1,
+                               unsigned int x, unsigned int y)
+        {
+            x_start = x0;
+            y_start = y0;
+            pxfact = (x1 - x0) / static_cast<double>(x);
+            pyfact = (y1 - y0) / static_cast<double>(y);
+            xsize = x;
+            ysize = y;
+        }
+
+        /*  Sets the plane to the one used by frame "angle" of the animation, *
+         *  u0 = cos(t) + sin(t)i and u1 = cos(t)j + sin(t)k.                 */
+        inline void rotate(double angle)
+        {
+            const double cos_ang = std::cos(angle);
+            const double sin_ang = std::sin(angle);
+            u0 = quaternion(cos_ang, sin_ang, 0.0, 0.0);
+            u1 = quaternion(0.0, 0.0, cos_ang, sin_ang);
+        }
+
+        /*  Sets the plane to frame "frame" of an "n_frames" frame turn, at   *
+         *  angle 2 pi frame / n_frames. The angle is first reduced with      *
+         *  the exact identities                                              *
+         *      cos(-t) = cos(t),       sin(-t) = -sin(t),                    *
+         *      cos(pi - t) = -cos(t),  sin(pi - t) = sin(t),                 *
+         *      cos(pi/2 - t) = sin(t), sin(pi/2 - t) = cos(t),               *
+         *  as far as n_frames allows, so frames related by a half turn or a  *
+         *  reflection of the angle get bases that differ exactly in sign.    *
+         *  The frame symmetries in qnf_symmetry.hpp rely on this.            */
+        inline void rotate_frame(unsigned int frame, unsigned int n_frames)
+        {
+            const unsigned int n = n_frames;
+            unsigned int k = frame % n;
+            bool neg_sin = false, neg_cos = false, swap = false;
+            double angle, cos_ang, sin_ang;
+
+            if (2U*k > n)
+            {
+                k = n - k;
+                neg_sin = true;
+            }
+
+            if ((n % 2U == 0U) && (4U*k > n))
+            {
+                k = n/2U - k;
+                neg_cos = true;
+            }
+
+            if ((n % 4U == 0U) && (8U*k > n))
+            {
+                k = n/4U - k;
+                swap = true;
+            }
+
+            angle = TWO_PI * static_cast<double>(k) / static_cast<double>(n);
+            cos_ang = std::cos(angle);
+            sin_ang = std::sin(angle);
+
+            if (swap)
+            {
+                const double tmp = cos_ang;
+                cos_ang = sin_ang;
+                sin_ang = tmp;
+            }
+
+            if (neg_cos)
+                cos_ang = -cos_ang;
+
+            if (neg_sin)
+                sin_ang = -sin_ang;
+
+            u0 = quaternion(cos_ang, sin_ang, 0.0, 0.0);
+            u1 = quaternion(0.0, 0.0, cos_ang, sin_ang);
+        }
+
+        /*  True if the window is symmetric about the origin pixel for pixel, *
+         *  i.e. row(ysize - y) == -row(y) and column(xsize - x) == -column(x)*
+         *  hold exactly. The pixel (x, y) then shows the negative of the     *
+         *  point at (xsize - x, ysize - y).                                  */
+        inline bool point_symmetric(void) const
+        {
+            unsigned int n;
+
+            for (n = 1U; n < ysize; ++n)
+                if (row(ysize - n) != -row(n))
+                    return false;
+
+            for (n = 1U; n < xsize; ++n)
+                if (column(xsize - n) != -column(n))
+                    return false;
+
+            return true;
+        }
+
+        /*  The coordinate along u0 for row y.                                */
+        inline double row(unsigned int y) const
+        {
+            return y_start + pyfact * y;
+        }
+
+        /*  The coordinate along u1 for column x.                             */
+        inline double column(unsigned int x) const
+        {
+            return x_start + pxfact * x;
+        }
+
+        /*  The point for the pixel (x, y).                                   */
+        inline quaternion point(unsigned int x, unsigned int y) const
+        {
+            return u0*row(y) + u1*column(x);
+        }
+
+        /*  True if the rectangle of pixels [x0, x1] by [y0, y1] touches the  *
+         *  line where qnf::slice folds the plane. Projected to the complex   *
+         *  point (Re p, |Im p|) the plane is folded over along the line      *
+         *  where |Im p| is least for fixed Re p, which passes through the    *
+         *  real axis crossing at the origin. Points mirrored across it have  *
+         *  the same projection. If the plane has no real part, |Im p| is a   *
+         *  norm and the plane only folds at the origin.                      */
+        inline bool folds(unsigned int x0, unsigned int y0,
+                          unsigned int x1, unsigned int y1) const
+        {
+            /*  Imaginary part of the direction w along which Re p is fixed.  */
+            const double r0 = u0.dat[0], r1 = u1.dat[0];
+            const double w[3] = {r1*u0.dat[1] - r0*u1.dat[1],
+                                 r1*u0.dat[2] - r0*u1.dat[2],
+                                 r1*u0.dat[3] - r0*u1.dat[3]};
+
+            /*  Im p . w is linear in p and zero on the fold.                 */
+            const double f0 = u0.dat[1]*w[0] + u0.dat[2]*w[1] + u0.dat[3]*w[2];
+            const double f1 = u1.dat[1]*w[0] + u1.dat[2]*w[1] + u1.dat[3]*w[2];
+            double lo, hi, a, b;
+
+            if (f0 == 0.0 && f1 == 0.0)
+                return row(y0)*row(y1) <= 0.0 && column(x0)*column(x1) <= 0.0;
+
+            a = f0*row(y0) + f1*column(x0);
+            b = f0*row(y0) + f1*column(x1);
+            lo = std::min(a, b);
+            hi = std::max(a, b);
+            a = f0*row(y1) + f1*column(x0);
+            b = f0*row(y1) + f1*column(x1);
+            lo = std::min(lo, std::min(a, b));
+            hi = std::max(hi, std::max(a, b));
+            return lo <= 0.0 && hi >= 0.0;
+        }
+    };
+}
+/*  End of namespace "qnf".                                                   */
+
+#endif
+/*  End of include guard.                                                     */